@@ -15,23 +15,40 @@
 
 #include "batch_import.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <optional>
 #include <random>
+#include <set>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 
 #include <gflags/gflags.h>
 
 #include "utils/bolt.hpp"
+#include "utils/checkpoint.hpp"
 #include "utils/constants.hpp"
 #include "utils/future.hpp"
+#include "utils/memory_tracker.hpp"
 #include "utils/notifier.hpp"
+#include "utils/perf_counters.hpp"
+#include "utils/progress.hpp"
+#include "utils/query_keys.hpp"
+#include "utils/simulator.hpp"
+#include "utils/synchronized.hpp"
 #include "utils/thread_pool.hpp"
+#include "utils/trace.hpp"
 #include "utils/utils.hpp"
 
 namespace mode::batch_import {
 
 using namespace std::string_literals;
 
+/// Batches which have to be executed one after another, different lanes are independent of each other.
+using Lane = std::vector<query::Batch>;
+
 struct Batches {
   Batches() = delete;
   Batches(const Batches &) = delete;
@@ -39,15 +56,37 @@ struct Batches {
   Batches(Batches &&) = default;
   Batches &operator=(Batches &&) = default;
 
-  explicit Batches(uint64_t batch_size, uint64_t max_batches)
-      : batch_size(batch_size), vertices_batch(batch_size, 0), edges_batch(batch_size, 1) {
+  explicit Batches(uint64_t batch_size, uint64_t max_batches, EdgeScheduling edge_scheduling,
+                   MergeScheduling merge_scheduling, std::string_view merge_key_property, uint64_t lanes_number,
+                   utils::MemoryTracker *memory_tracker)
+      : batch_size(batch_size),
+        edge_scheduling(edge_scheduling),
+        merge_scheduling(merge_scheduling),
+        merge_key_property(merge_key_property),
+        tracked_bytes(memory_tracker),
+        vertices_batch(batch_size, 0),
+        edges_batch(batch_size, 1) {
     batch_index = 1;
     vertex_batches.reserve(max_batches);
     edge_batches.reserve(max_batches);
+    if (edge_scheduling == EdgeScheduling::CONFLICT_AWARE) {
+      edge_lanes.resize(std::max(lanes_number, static_cast<uint64_t>(1)));
+    }
+    if (merge_scheduling == MergeScheduling::HASH_PARTITIONED) {
+      node_merge_lanes.resize(std::max(lanes_number, static_cast<uint64_t>(1)));
+      relationship_merge_lanes.resize(std::max(lanes_number, static_cast<uint64_t>(1)));
+    }
+  }
+  bool Empty() const {
+    auto lanes_empty = [](const std::vector<Lane> &lanes) {
+      return std::all_of(lanes.begin(), lanes.end(), [](const auto &lane) { return lane.empty(); });
+    };
+    return pre_queries.empty() && vertex_batches.empty() && edge_batches.empty() && post_queries.empty() &&
+           lanes_empty(node_merge_lanes) && lanes_empty(relationship_merge_lanes);
   }
-  bool Empty() const { return vertex_batches.empty() && edge_batches.empty(); }
 
   void AddQuery(query::Query query) {
+    tracked_bytes.Add(sizeof(query::Query) + query.query.capacity());
     // NOTE: Take a look at what info /ref QueryInfo contains.
     auto is_pre_query = [](const query::Query &query) {
       MG_ASSERT(query.info, "QueryInfo is an empty optional");
@@ -67,6 +106,12 @@ struct Batches {
       const auto &info = *query.info;
       return info.has_match && info.has_create;
     };
+    auto is_merge_query = [](const query::Query &query) {
+      MG_ASSERT(query.info, "QueryInfo is an empty optional");
+      const auto &info = *query.info;
+      return info.has_merge && !info.has_create && !info.has_detach_delete && !info.has_create_index &&
+             !info.has_drop_index && !info.has_remove && !info.has_storage_mode;
+    };
 
     if (is_pre_query(query)) {
       pre_queries.emplace_back(std::move(query));
@@ -79,6 +124,14 @@ struct Batches {
         vertices_batch = query::Batch(batch_size, batch_index);
         vertices_batch.queries.emplace_back(std::move(query));
       }
+    } else if (is_edge_query(query) && edge_scheduling == EdgeScheduling::CONFLICT_AWARE) {
+      // Edges sharing the (smallest) endpoint key land in the same lane, so a high-degree vertex is touched by as few
+      // batches as possible. Unkeyed edges all go to the first lane.
+      auto keys = query::keys::ExtractKeys(query.query);
+      auto lane = keys.match_keyed && !keys.match.empty() ? keys.match.front() % edge_lanes.size() : 0;
+      tracked_bytes.Add(keys.match.capacity() * sizeof(query::keys::Key));
+      edge_lanes[lane].emplace_back(
+          KeyedQuery{.query = std::move(query), .keys = std::move(keys.match), .is_keyed = keys.match_keyed});
     } else if (is_edge_query(query)) {
       if (edges_batch.queries.size() < batch_size) {
         edges_batch.queries.emplace_back(std::move(query));
@@ -88,19 +141,51 @@ struct Batches {
         edges_batch = query::Batch(batch_size, batch_index);
         edges_batch.queries.emplace_back(std::move(query));
       }
+    } else if (is_merge_query(query) && merge_scheduling == MergeScheduling::HASH_PARTITIONED) {
+      auto keys = query::keys::ExtractKeys(query.query, merge_key_property);
+      if (!keys.merge) {
+        post_queries.emplace_back(std::move(query));
+        return;
+      }
+      auto &lanes = keys.merge_has_relationship ? relationship_merge_lanes : node_merge_lanes;
+      AppendToLane(lanes[*keys.merge % lanes.size()], std::move(query));
     } else {
       post_queries.emplace_back(std::move(query));
     }
   }
 
-  // Add last batch if it's missing!
+  void AppendToLane(Lane &lane, query::Query query) {
+    if (lane.empty() || lane.back().queries.size() >= batch_size) {
+      batch_index += 1;
+      auto &batch = lane.emplace_back(batch_size, batch_index);
+      // MERGE creates nothing if the pattern is already there.
+      batch.check_created = false;
+    }
+    lane.back().queries.emplace_back(std::move(query));
+  }
+
+  // Add last batch if it's missing! A full batch is only pushed once the next query arrives, so it's still here.
   void Finalize() {
-    if (vertices_batch.queries.size() > 0 && vertices_batch.queries.size() < batch_size) {
+    if (vertices_batch.queries.size() > 0) {
       vertex_batches.emplace_back(std::move(vertices_batch));
     }
-    if (edges_batch.queries.size() > 0 && edges_batch.queries.size() < batch_size) {
+    if (edges_batch.queries.size() > 0) {
       edge_batches.emplace_back(std::move(edges_batch));
     }
+    for (auto &lane : edge_lanes) {
+      for (uint64_t begin = 0; begin < lane.size(); begin += batch_size) {
+        batch_index += 1;
+        auto &batch = edge_batches.emplace_back(batch_size, batch_index);
+        for (uint64_t i = begin; i < std::min(begin + batch_size, static_cast<uint64_t>(lane.size())); ++i) {
+          batch.queries.emplace_back(std::move(lane[i].query));
+          batch.keys.insert(batch.keys.end(), lane[i].keys.begin(), lane[i].keys.end());
+          batch.unkeyed = batch.unkeyed || !lane[i].is_keyed;
+        }
+        std::sort(batch.keys.begin(), batch.keys.end());
+        batch.keys.erase(std::unique(batch.keys.begin(), batch.keys.end()), batch.keys.end());
+      }
+      lane.clear();
+    }
   }
 
   uint64_t VertexQueryNo() const {
@@ -119,8 +204,19 @@ struct Batches {
   }
   uint64_t TotalQueryNo() const { return VertexQueryNo() + EdgesNo(); }
 
+  struct KeyedQuery {
+    query::Query query;
+    std::vector<query::keys::Key> keys;
+    bool is_keyed;
+  };
+
   uint64_t batch_size;
   uint64_t batch_index{0};
+  EdgeScheduling edge_scheduling;
+  MergeScheduling merge_scheduling;
+  std::string_view merge_key_property;
+  /// Everything held by the window (queries, keys, ...), released together with it.
+  utils::TrackedBytes tracked_bytes;
 
   // An assumption here that there is a few setup queries.
   std::vector<query::Query> pre_queries;
@@ -129,6 +225,12 @@ struct Batches {
   std::vector<query::Batch> vertex_batches;
   std::vector<query::Batch> edge_batches;
   std::vector<query::Query> post_queries;
+  // Only used by EdgeScheduling::CONFLICT_AWARE, edge queries are packed into batches lane by lane in Finalize.
+  std::vector<std::vector<KeyedQuery>> edge_lanes;
+  // Only used by MergeScheduling::HASH_PARTITIONED. Node MERGEs are executed after the vertex batches (edges might
+  // depend on them), relationship MERGEs after the edge batches.
+  std::vector<Lane> node_merge_lanes;
+  std::vector<Lane> relationship_merge_lanes;
 };
 
 inline std::ostream &operator<<(std::ostream &os, const Batches &bs) {
@@ -152,18 +254,76 @@ struct BatchExecutionContext {
   BatchExecutionContext &operator=(BatchExecutionContext &&) = delete;
 
   BatchExecutionContext(uint64_t batch_size, uint64_t max_batches, uint64_t max_concurrent_executions,
-                        const utils::bolt::Config &bolt_config)
+                        EdgeScheduling edge_scheduling, MergeScheduling merge_scheduling, uint64_t max_batch_attempts,
+                        const utils::bolt::Config &bolt_config, utils::Simulator *simulator)
       : batch_size(batch_size),
         max_batches(max_batches),
         max_concurrent_executions(max_concurrent_executions),
+        edge_scheduling(edge_scheduling),
+        merge_scheduling(merge_scheduling),
+        max_batch_attempts(max_batch_attempts),
         thread_pool(max_concurrent_executions) {
+    if (simulator) {
+      UseSimulator(*simulator);
+    } else {
+      UseDatabase(bolt_config);
+    }
+  }
+
+  /// A resumed import appends, the queries rejected before are not executed again.
+  void OpenRejectFile(const std::string &path, bool append) {
+    reject_file->open(path, append ? std::ios::app : std::ios::trunc);
+    if (!reject_file->is_open()) {
+      MG_FAIL("unable to open the reject file");
+    }
+  }
+
+  void UseDatabase(const utils::bolt::Config &bolt_config) {
     sessions.reserve(max_concurrent_executions);
     for (uint64_t thread_i = 0; thread_i < max_concurrent_executions; ++thread_i) {
-      sessions[thread_i] = MakeBoltSession(bolt_config);
+      sessions.emplace_back(MakeBoltSession(bolt_config));
       if (!sessions[thread_i].get()) {
         MG_FAIL("a session uninitialized");
       }
     }
+    dispatch = [this](std::function<void()> task) {
+      if (!utils::trace::IsEnabled()) [[likely]] {
+        thread_pool.AddTask(std::move(task));
+        return;
+      }
+      thread_pool.AddTask([task = std::move(task), queued = utils::trace::Now()]() {
+        utils::trace::Complete("queue wait", queued);
+        task();
+      });
+    };
+    notify = [this](utils::ReadinessToken readiness_token) { notifier.Notify(readiness_token); };
+    backoff = [](int64_t max_ms) {
+      utils::trace::Span span("backoff");
+      thread_local std::mt19937 generator{std::random_device{}()};
+      std::uniform_int_distribution<int64_t> distribution(0, max_ms);
+      std::this_thread::sleep_for(std::chrono::milliseconds(distribution(generator)));
+    };
+    execute_batch = [this](uint64_t session_i, const query::Batch &batch) {
+      return query::ExecuteBatch(sessions[session_i].get(), batch);
+    };
+    execute_query = [this](uint64_t session_i, const std::string &query) {
+      return query::ExecuteQuery(sessions[session_i].get(), query);
+    };
+    reconnect = [this, bolt_config](uint64_t session_i) { sessions[session_i] = MakeBoltSession(bolt_config); };
+  }
+
+  void UseSimulator(utils::Simulator &simulator) {
+    dispatch = [&simulator](std::function<void()> task) { simulator.Dispatch(task); };
+    notify = [&simulator](utils::ReadinessToken readiness_token) { simulator.Notify(readiness_token); };
+    backoff = [&simulator](int64_t max_ms) { simulator.Backoff(max_ms); };
+    execute_batch = [&simulator](uint64_t, const query::Batch &batch) { return simulator.ExecuteBatch(batch); };
+    execute_query = [&simulator](uint64_t, const std::string &query) {
+      simulator.ExecuteQuery(query);
+      return query::QueryResult{};
+    };
+    reconnect = [&simulator](uint64_t) { simulator.Reconnect(); };
+    restore = [&simulator](const query::Query &query) { simulator.Restore(query.query); };
+    notifier.InstallSimulatorTicker([this, &simulator]() { return simulator.Tick(notifier); });
   }
 
   /// A single batch size / number of queries in a single batch.
@@ -172,36 +332,112 @@ struct BatchExecutionContext {
   uint64_t max_batches;
   /// Size of the thread pool used to execute batches against the database.
   uint64_t max_concurrent_executions;
+  EdgeScheduling edge_scheduling;
+  MergeScheduling merge_scheduling;
+  std::string merge_key_property;
+  /// How many times a batch is retried after a broken connection or when a query created nothing, and after how many
+  /// conflicts it's reported.
+  uint64_t max_batch_attempts;
+  /// A window stops reading the input once it holds this many (tracked) bytes, 0 means no limit. The results fetched
+  /// by execute_batch are short-lived and not tracked.
+  uint64_t max_memory{0};
+  utils::MemoryTracker memory_tracker;
+  /// Journal of the committed queries, null if the import isn't checkpointed.
+  utils::Checkpoint *checkpoint{nullptr};
   utils::ThreadPool thread_pool{max_concurrent_executions};
   utils::Notifier notifier;
   std::vector<mg_memory::MgSessionPtr> sessions;
+  /// Everything that touches threads, time or the database goes through these, so that the simulator can replace it.
+  std::function<void(std::function<void()>)> dispatch;
+  std::function<void(utils::ReadinessToken)> notify;
+  /// Sleeps for a random time up to the given number of milliseconds.
+  std::function<void(int64_t)> backoff;
+  std::function<query::BatchResult(uint64_t, const query::Batch &)> execute_batch;
+  /// Executes a query outside of an explicit transaction, throws on failure.
+  std::function<query::QueryResult(uint64_t, const std::string &)> execute_query;
+  std::function<void(uint64_t)> reconnect;
+  /// Called for the queries committed before a resume, only the simulator needs to know what's in the database.
+  std::function<void(const query::Query &)> restore{[](const query::Query &) {}};
+  /// Queries which failed on their own, not opened if the path is empty.
+  utils::Synchronized<std::ofstream, std::mutex> reject_file;
+  /// Counts the batch executions, aborts, rejected queries, ... and reports them if enabled.
+  utils::Progress progress;
 };
 
 Batches FetchBatches(BatchExecutionContext &execution_context) {
   uint64_t query_number = 0;
-  Batches batches(execution_context.batch_size, execution_context.max_batches);
+  Batches batches(execution_context.batch_size, execution_context.max_batches, execution_context.edge_scheduling,
+                  execution_context.merge_scheduling, execution_context.merge_key_property,
+                  execution_context.max_concurrent_executions, &execution_context.memory_tracker);
   while (true) {
     if (query_number + 1 >= execution_context.batch_size * execution_context.max_batches) {
       break;
     }
-    auto query = query::GetQuery(nullptr, true);
+    // Backpressure, the rest of the input waits until the window is executed and released.
+    if (execution_context.max_memory > 0 && batches.tracked_bytes.Bytes() >= execution_context.max_memory) {
+      break;
+    }
+    // The rest of the input is left for --resume.
+    if (utils::IsStopRequested()) {
+      break;
+    }
+    const auto parse_start = std::chrono::steady_clock::now();
+    std::optional<query::Query> query;
+    {
+      utils::trace::Span span("read");
+      query = query::GetQuery(nullptr, true);
+    }
     if (!query) {
       break;
     }
     if (query->query.empty()) {
       continue;
     }
+    execution_context.progress.Read(*query, std::chrono::steady_clock::now() - parse_start);
+    if (execution_context.checkpoint && execution_context.checkpoint->IsCommitted(*query)) {
+      execution_context.restore(*query);
+      continue;
+    }
     query_number += 1;
+    utils::trace::Span span("classify");
+    utils::perf::Scope scope(utils::perf::Phase::CLASSIFY);
+    utils::perf::AddQueries(utils::perf::Phase::CLASSIFY, 1);
     batches.AddQuery(std::move(*query));
   }
+  utils::trace::Span span("finalize");
   batches.Finalize();
   return batches;
 }
 
+/// Journals the committed queries, the ones executed outside of a batch are journaled under batch index 0.
+void Commit(uint64_t batch_index, const std::vector<query::Query> &queries, BatchExecutionContext &execution_context) {
+  if (execution_context.checkpoint) {
+    execution_context.checkpoint->Commit(batch_index, queries);
+  }
+}
+
+void Commit(uint64_t batch_index, const query::Query &query, BatchExecutionContext &execution_context) {
+  if (execution_context.checkpoint) {
+    execution_context.checkpoint->Commit(batch_index, query);
+  }
+}
+
+/// Executes the query outside of an explicit transaction, throws on failure.
+void ExecuteAutocommit(const query::Query &query, BatchExecutionContext &execution_context, uint64_t session_i) {
+  const auto start = std::chrono::steady_clock::now();
+  auto ret = execution_context.execute_query(session_i, query.query);
+  execution_context.progress.AddWait(std::chrono::steady_clock::now() - start);
+  execution_context.progress.Commit(ret.stats);
+  Commit(0, query, execution_context);
+}
+
 void ExecuteSerial(const std::vector<query::Query> &queries, BatchExecutionContext &context) {
   for (const auto &query : queries) {
+    if (utils::IsStopRequested()) {
+      return;
+    }
     try {
-      query::ExecuteQuery(context.sessions[0].get(), query.query);
+      ExecuteAutocommit(query, context, 0);
     } catch (const utils::ClientQueryException &e) {
       console::EchoFailure("Client received query exception", e.what());
       MG_FAIL("Unable to ExecuteSerial");
@@ -212,18 +448,141 @@ void ExecuteSerial(const std::vector<query::Query> &queries, BatchExecutionConte
   }
 }
 
+// NOTE: The magic numbers here are here because the idea was to avoid serialization errors in the transactional import
+// mode. They were picked in a specific context (playing with a specific dataset). It's definitely possible to improve.
+void UpdateBackoff(query::Batch &batch) {
+  batch.backoff = std::min(batch.backoff * 2, static_cast<int64_t>(100));
+  batch.attempts += 1;
+}
+
+/// Sleeps for a random time up to the batch backoff (full jitter), so that the batches which conflicted with each other
+/// don't all come back at the same time.
+void SleepBackoff(const query::Batch &batch, BatchExecutionContext &execution_context) {
+  if (batch.attempts == 0) {
+    return;
+  }
+  execution_context.backoff(batch.backoff);
+}
+
+void RejectQuery(uint64_t batch_index, const query::Query &query, const std::string &error,
+                 BatchExecutionContext &execution_context) {
+  execution_context.progress.rejected++;
+  console::EchoFailure("Query rejected", "line " + std::to_string(query.line_number) + ": " + error);
+  execution_context.reject_file.WithLock([&](auto &reject_file) {
+    if (!reject_file.is_open()) {
+      return;
+    }
+    // The file stays a valid cypherl file, the queries can be fixed and imported again.
+    auto comment = error;
+    std::replace(comment.begin(), comment.end(), '\n', ' ');
+    reject_file << "// line " << query.line_number << ": " << comment << '\n' << query.query << '\n';
+    reject_file.flush();
+  });
+  // Done as well, a resumed import doesn't reject it again.
+  Commit(batch_index, query, execution_context);
+}
+
+void ExecuteBatchWithRetry(query::Batch &batch, BatchExecutionContext &execution_context, uint64_t session_i);
+
+/// A batch which fails for good is split, at the failed query if the database told which one, otherwise in half. The
+/// parts are executed in order so a single query that fails on its own is the only thing that ends up rejected.
+void BisectBatch(query::Batch &batch, const query::BatchResult &result, BatchExecutionContext &execution_context,
+                 uint64_t session_i) {
+  auto &queries = batch.queries;
+  if (queries.size() == 1) {
+    RejectQuery(batch.index, queries.front(), result.error_message, execution_context);
+    return;
+  }
+  std::vector<uint64_t> splits;
+  if (result.failed_query && *result.failed_query < queries.size()) {
+    splits = {*result.failed_query, *result.failed_query + 1};
+  } else {
+    splits = {queries.size() / 2};
+  }
+  splits.push_back(queries.size());
+  uint64_t begin = 0;
+  for (const auto end : splits) {
+    if (begin == end) {
+      continue;
+    }
+    query::Batch part(end - begin, batch.index);
+    part.check_created = batch.check_created;
+    std::move(queries.begin() + begin, queries.begin() + end, std::back_inserter(part.queries));
+    ExecuteBatchWithRetry(part, execution_context, session_i);
+    begin = end;
+  }
+}
+
+/// Executes the batch until it's committed: conflicts are retried with a jittered backoff (with a warning after
+/// max_batch_attempts of them), broken sessions are reconnected and the batches creating nothing are retried up to
+/// max_batch_attempts times, and the batches failing on a query error (or still creating nothing) are bisected. The batch is always executed after the call, maybe with some queries rejected.
+void ExecuteBatchWithRetry(query::Batch &batch, BatchExecutionContext &execution_context, uint64_t session_i) {
+  while (true) {
+    SleepBackoff(batch, execution_context);
+    auto &progress = execution_context.progress;
+    if (batch.attempts > 0) {
+      progress.retries++;
+    }
+    progress.in_flight++;
+    const auto start = std::chrono::steady_clock::now();
+    auto ret = [&]() {
+      utils::trace::Span span("batch");
+      return execution_context.execute_batch(session_i, batch);
+    }();
+    progress.AddWait(std::chrono::steady_clock::now() - start);
+    progress.in_flight--;
+    progress.attempts++;
+    if (ret.is_executed) {
+      progress.Commit(batch.queries.size(), ret.nodes_created, ret.relationships_created);
+      Commit(batch.index, batch.queries, execution_context);
+      batch.is_executed = true;
+      return;
+    }
+    UpdateBackoff(batch);
+    progress.aborts++;
+    const auto attempts_left = static_cast<uint64_t>(batch.attempts) < execution_context.max_batch_attempts;
+    if (ret.error == query::BatchError::CONNECTION) {
+      if (!attempts_left) {
+        console::EchoFailure("Client received connection exception", ret.error_message);
+        MG_FAIL("Unable to execute a batch, the connection keeps failing");
+      }
+      execution_context.reconnect(session_i);
+      continue;
+    }
+    if (ret.error == query::BatchError::NOT_CREATED && attempts_left) {
+      continue;
+    }
+    if (ret.error == query::BatchError::CONFLICT) {
+      // The conflicting transactions finish eventually, rejecting the queries would lose good statements.
+      if (static_cast<uint64_t>(batch.attempts) == execution_context.max_batch_attempts) {
+        console::EchoFailure("Batch keeps conflicting",
+                             "retried " + std::to_string(batch.attempts) + " times, still retrying: " +
+                                 ret.error_message);
+      }
+      continue;
+    }
+    // A query error, or a query which keeps creating nothing (its endpoints are missing), fails the same way every time.
+    BisectBatch(batch, ret, execution_context, session_i);
+    batch.is_executed = true;
+    return;
+  }
+}
+
 /// returns the number of executed batches.
-uint64_t ExecuteBatchesParallel(std::vector<query::Batch> &batches, BatchExecutionContext &execution_context,
-                                const utils::bolt::Config &bolt_config) {
+uint64_t ExecuteBatchesParallel(std::vector<query::Batch> &batches, BatchExecutionContext &execution_context) {
   if (batches.empty()) return 0;
   std::atomic<uint64_t> executed_batches = 0;
   while (true) {
-    if (executed_batches.load() >= batches.size()) {
+    if (executed_batches.load() >= batches.size() || utils::IsStopRequested()) {
       break;
     }
 
     std::unordered_map<size_t, utils::Future<bool>> f_execs;
     uint64_t used_threads = 0;
+    // Keys of the batches scheduled in this round. A batch sharing any of them has to wait for one of the next rounds
+    // (it would most likely end up with a serialization error anyway). Batches without keys never conflict.
+    std::unordered_set<uint64_t> scheduled_keys;
+    bool scheduled_unkeyed = false;
     for (uint64_t batch_i = 0; batch_i < batches.size(); ++batch_i) {
       if (used_threads >= execution_context.max_concurrent_executions) {
         break;
@@ -232,41 +591,30 @@ uint64_t ExecuteBatchesParallel(std::vector<query::Batch> &batches, BatchExecuti
       if (batch.is_executed) {
         continue;
       }
+      if (used_threads > 0 &&
+          (scheduled_unkeyed || batch.unkeyed ||
+           std::any_of(batch.keys.begin(), batch.keys.end(),
+                       [&scheduled_keys](const auto key) { return scheduled_keys.contains(key); }))) {
+        continue;
+      }
+      scheduled_keys.insert(batch.keys.begin(), batch.keys.end());
+      scheduled_unkeyed = scheduled_unkeyed || batch.unkeyed;
 
       // Schedule all batches for parallel execution.
       auto thread_i = used_threads;
       used_threads++;
       utils::ReadinessToken readiness_token{static_cast<size_t>(batch_i)};
       std::function<void()> fill_notifier = [readiness_token, &execution_context]() {
-        execution_context.notifier.Notify(readiness_token);
+        execution_context.notify(readiness_token);
       };
       auto [future, promise] = utils::FuturePromisePairWithNotifications<bool>(nullptr, fill_notifier);
       auto shared_promise = std::make_shared<decltype(promise)>(std::move(promise));
-      execution_context.thread_pool.AddTask([&execution_context, &batches, thread_i, batch_i, &executed_batches,
-                                             &bolt_config, promise = std::move(shared_promise)]() mutable {
+      execution_context.dispatch([&execution_context, &batches, thread_i, batch_i, &executed_batches,
+                                  promise = std::move(shared_promise)]() mutable {
         auto &batch = batches.at(batch_i);
-        if (batch.backoff > 1) {
-          std::this_thread::sleep_for(std::chrono::milliseconds(batch.backoff));
-        }
-        auto ret = query::ExecuteBatch(execution_context.sessions[thread_i].get(), batch);
-        if (ret.is_executed) {
-          batch.is_executed = true;
-          executed_batches++;
-          promise->Fill(true);
-        } else {
-          // NOTE: The magic numbers here are here because the idea was to avoid serialization errors in the
-          // transactional import mode. They were picked in a specific context (playing with a specific dataset). It's
-          // definitely possible to improve.
-          batch.backoff *= 2;
-          if (batch.backoff > 100) {
-            batch.backoff = 1;
-          }
-          batch.attempts += 1;
-          promise->Fill(false);
-        }
-        if (mg_session_status(execution_context.sessions[thread_i].get()) == MG_SESSION_BAD) {
-          execution_context.sessions[thread_i] = MakeBoltSession(bolt_config);
-        }
+        ExecuteBatchWithRetry(batch, execution_context, thread_i);
+        executed_batches++;
+        promise->Fill(true);
       });
       f_execs.insert_or_assign(thread_i, std::move(future));
     }
@@ -281,25 +629,410 @@ uint64_t ExecuteBatchesParallel(std::vector<query::Batch> &batches, BatchExecuti
   return executed_batches.load();
 }
 
-int Run(const utils::bolt::Config &bolt_config, int batch_size, int workers_number) {
+/// Each non-empty lane is executed by a single worker, batch after batch, so that the order inside a lane is
+/// preserved.
+void ExecuteLanesParallel(std::vector<Lane> &lanes, BatchExecutionContext &execution_context) {
+  MG_ASSERT(lanes.size() <= execution_context.max_concurrent_executions, "there has to be a session per lane");
+  uint64_t used_threads = 0;
+  for (uint64_t lane_i = 0; lane_i < lanes.size(); ++lane_i) {
+    if (lanes[lane_i].empty()) {
+      continue;
+    }
+    used_threads++;
+    execution_context.dispatch([&execution_context, &lanes, lane_i]() {
+      for (auto &batch : lanes[lane_i]) {
+        if (utils::IsStopRequested()) {
+          break;
+        }
+        ExecuteBatchWithRetry(batch, execution_context, lane_i);
+      }
+      execution_context.notify(utils::ReadinessToken{static_cast<size_t>(lane_i)});
+    });
+  }
+
+  // Wait for all lanes to finish.
+  while (used_threads > 0) {
+    execution_context.notifier.Await();
+    --used_threads;
+  }
+}
+
+bool Intersects(const std::vector<query::keys::Key> &lhs, const std::vector<query::keys::Key> &rhs) {
+  auto lhs_it = lhs.begin();
+  auto rhs_it = rhs.begin();
+  while (lhs_it != lhs.end() && rhs_it != rhs.end()) {
+    if (*lhs_it < *rhs_it) {
+      ++lhs_it;
+    } else if (*rhs_it < *lhs_it) {
+      ++rhs_it;
+    } else {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// What a batch reads and writes, used by ImportScheduler::DAG to order the batches. Vertices are identified by keys
+/// (see query_keys.hpp), if a query touches vertices without knowing which ones, the access covers the whole label.
+/// Labels are stored as keys as well, MakeKey(label, "", "").
+struct Access {
+  std::vector<query::keys::Key> read_keys;
+  std::vector<query::keys::Key> write_keys;
+  /// All the labels read / written, keyed or not.
+  std::vector<query::keys::Key> read_labels;
+  std::vector<query::keys::Key> write_labels;
+  /// Labels read / written without knowing which vertices.
+  std::vector<query::keys::Key> opaque_read_labels;
+  std::vector<query::keys::Key> opaque_write_labels;
+  /// Labels under index DDL, any other access to them has to wait.
+  std::vector<query::keys::Key> fenced_labels;
+  /// Conflicts with everything.
+  bool barrier{false};
+
+  void Merge(const Access &other) {
+    auto append = [](auto &to, const auto &from) { to.insert(to.end(), from.begin(), from.end()); };
+    append(read_keys, other.read_keys);
+    append(write_keys, other.write_keys);
+    append(read_labels, other.read_labels);
+    append(write_labels, other.write_labels);
+    append(opaque_read_labels, other.opaque_read_labels);
+    append(opaque_write_labels, other.opaque_write_labels);
+    append(fenced_labels, other.fenced_labels);
+    barrier = barrier || other.barrier;
+  }
+
+  uint64_t Bytes() const {
+    return sizeof(query::keys::Key) *
+           (read_keys.capacity() + write_keys.capacity() + read_labels.capacity() + write_labels.capacity() +
+            opaque_read_labels.capacity() + opaque_write_labels.capacity() + fenced_labels.capacity());
+  }
+
+  void Normalize() {
+    for (auto *keys : {&read_keys, &write_keys, &read_labels, &write_labels, &opaque_read_labels, &opaque_write_labels,
+                       &fenced_labels}) {
+      std::sort(keys->begin(), keys->end());
+      keys->erase(std::unique(keys->begin(), keys->end()), keys->end());
+    }
+  }
+};
+
+Access AccessOf(const query::Query &query) {
+  MG_ASSERT(query.info, "QueryInfo is an empty optional");
+  const auto &info = *query.info;
+  Access access;
+  if (info.has_storage_mode || info.has_detach_delete || info.has_remove) {
+    access.barrier = true;
+    return access;
+  }
+  auto keys = query::keys::ExtractKeys(query.query);
+  if (keys.has_side_effects || keys.has_unlabeled_node) {
+    access.barrier = true;
+    return access;
+  }
+  auto labels = [](const std::vector<std::string> &labels) {
+    std::vector<query::keys::Key> label_keys;
+    label_keys.reserve(labels.size());
+    for (const auto &label : labels) {
+      label_keys.push_back(query::keys::MakeKey(label, "", ""));
+    }
+    return label_keys;
+  };
+  if (info.has_create_index || info.has_drop_index) {
+    if (keys.index_labels.empty()) {
+      access.barrier = true;
+    }
+    access.fenced_labels = labels(keys.index_labels);
+    return access;
+  }
+
+  const auto match_labels = labels(keys.match_labels);
+  const auto create_labels = labels(keys.create_labels);
+  const auto merge_labels = labels(keys.merge_labels);
+  auto append = [](auto &to, const auto &from) { to.insert(to.end(), from.begin(), from.end()); };
+  append(access.read_keys, keys.match);
+  append(access.read_labels, match_labels);
+  if (!keys.match_keyed) {
+    append(access.opaque_read_labels, match_labels);
+  }
+  // Created vertices are new, two CREATEs never depend on each other, only on what reads the created vertices.
+  append(access.write_keys, keys.create);
+  append(access.write_labels, create_labels);
+  if (!keys.create_keyed) {
+    append(access.opaque_write_labels, create_labels);
+  }
+  // MERGE reads and maybe writes the merged vertices.
+  append(access.read_keys, keys.merge_vertices);
+  append(access.write_keys, keys.merge_vertices);
+  append(access.read_labels, merge_labels);
+  append(access.write_labels, merge_labels);
+  if (!keys.merge_keyed) {
+    append(access.opaque_read_labels, merge_labels);
+    append(access.opaque_write_labels, merge_labels);
+  }
+  if (keys.merge_has_relationship) {
+    // A merged relationship between matched vertices, the next MERGE of the same relationship has to see it.
+    append(access.write_keys, keys.match);
+    append(access.write_labels, match_labels);
+    if (!keys.match_keyed) {
+      append(access.opaque_write_labels, match_labels);
+    }
+  }
+  access.Normalize();
+  return access;
+}
+
+/// Returns true if the order of the two batches matters.
+bool Conflicts(const Access &lhs, const Access &rhs) {
+  if (lhs.barrier || rhs.barrier) {
+    return true;
+  }
+  auto one_way = [](const Access &a, const Access &b) {
+    return Intersects(a.write_keys, b.read_keys) || Intersects(a.opaque_write_labels, b.read_labels) ||
+           Intersects(a.opaque_read_labels, b.write_labels) || Intersects(a.fenced_labels, b.read_labels) ||
+           Intersects(a.fenced_labels, b.write_labels) || Intersects(a.fenced_labels, b.fenced_labels);
+  };
+  return one_way(lhs, rhs) || one_way(rhs, lhs);
+}
+
+struct DagNode {
+  query::Batch batch;
+  Access access;
+  /// Queries are executed one by one outside of an explicit transaction (e.g. index DDL can't be a part of one).
+  bool autocommit{false};
+  /// Number of not yet committed batches this one depends on.
+  uint64_t dependencies{0};
+  std::vector<uint64_t> dependents;
+};
+
+/// The nodes are created in the order of the phased execution, a node depends on every earlier node it conflicts with,
+/// so the result is the same as in the phased execution.
+std::vector<DagNode> BuildDag(Batches &batches) {
+  std::vector<DagNode> nodes;
+  auto add_node = [&nodes, &batches](query::Batch batch, bool autocommit) {
+    Access access;
+    for (const auto &query : batch.queries) {
+      access.Merge(AccessOf(query));
+    }
+    access.Normalize();
+    batches.tracked_bytes.Add(access.Bytes());
+    nodes.push_back(DagNode{.batch = std::move(batch),
+                            .access = std::move(access),
+                            .autocommit = autocommit,
+                            .dependencies = 0,
+                            .dependents = {}});
+  };
+  auto add_autocommit = [&](std::vector<query::Query> &queries, uint64_t max_size) {
+    for (uint64_t begin = 0; begin < queries.size(); begin += max_size) {
+      query::Batch batch(max_size, nodes.size());
+      for (uint64_t i = begin; i < std::min(begin + max_size, static_cast<uint64_t>(queries.size())); ++i) {
+        batch.queries.emplace_back(std::move(queries[i]));
+      }
+      add_node(std::move(batch), true);
+    }
+  };
+  auto add_lanes = [&](std::vector<Lane> &lanes) {
+    for (auto &lane : lanes) {
+      for (auto &batch : lane) {
+        add_node(std::move(batch), false);
+      }
+    }
+  };
+
+  // Each setup query on its own, so that a CREATE INDEX only fences its label.
+  add_autocommit(batches.pre_queries, 1);
+  for (auto &batch : batches.vertex_batches) {
+    add_node(std::move(batch), false);
+  }
+  add_lanes(batches.node_merge_lanes);
+  for (auto &batch : batches.edge_batches) {
+    add_node(std::move(batch), false);
+  }
+  add_lanes(batches.relationship_merge_lanes);
+  add_autocommit(batches.post_queries, batches.batch_size);
+
+  for (uint64_t node_i = 0; node_i < nodes.size(); ++node_i) {
+    for (uint64_t prev_i = 0; prev_i < node_i; ++prev_i) {
+      if (Conflicts(nodes[prev_i].access, nodes[node_i].access)) {
+        nodes[prev_i].dependents.push_back(node_i);
+        nodes[node_i].dependencies++;
+      }
+    }
+  }
+  return nodes;
+}
+
+void ExecuteDagNode(DagNode &node, BatchExecutionContext &execution_context, uint64_t session_i) {
+  auto &batch = node.batch;
+  if (node.autocommit) {
+    for (const auto &query : batch.queries) {
+      try {
+        ExecuteAutocommit(query, execution_context, session_i);
+      } catch (const utils::ClientQueryException &e) {
+        console::EchoFailure("Client received query exception", e.what());
+        MG_FAIL("Unable to execute an autocommit batch");
+      } catch (const utils::ClientFatalException &e) {
+        console::EchoFailure("Client received connection exception", e.what());
+        MG_FAIL("Unable to execute an autocommit batch");
+      }
+    }
+    batch.is_executed = true;
+    return;
+  }
+  ExecuteBatchWithRetry(batch, execution_context, session_i);
+}
+
+void ExecuteDag(std::vector<DagNode> &nodes, BatchExecutionContext &execution_context) {
+  // Lower index first, that's the order of the phased execution.
+  std::set<uint64_t> ready;
+  for (uint64_t node_i = 0; node_i < nodes.size(); ++node_i) {
+    if (nodes[node_i].dependencies == 0) {
+      ready.insert(node_i);
+    }
+  }
+  std::vector<uint64_t> free_sessions;
+  for (uint64_t session_i = 0; session_i < execution_context.max_concurrent_executions; ++session_i) {
+    free_sessions.push_back(execution_context.max_concurrent_executions - session_i - 1);
+  }
+  std::vector<uint64_t> session_of(nodes.size());
+  std::vector<uint64_t> running;
+  uint64_t committed = 0;
+  while (committed < nodes.size()) {
+    // On stop, only the running batches are drained.
+    for (auto it = ready.begin(); it != ready.end() && !free_sessions.empty() && !utils::IsStopRequested();) {
+      const auto node_i = *it;
+      // Same as in ExecuteBatchesParallel, batches sharing vertex keys are not executed at the same time.
+      const auto &batch = nodes[node_i].batch;
+      if (!running.empty() && std::any_of(running.begin(), running.end(), [&](const auto running_i) {
+            const auto &other = nodes[running_i].batch;
+            return batch.unkeyed || other.unkeyed || Intersects(batch.keys, other.keys);
+          })) {
+        ++it;
+        continue;
+      }
+      it = ready.erase(it);
+      const auto session_i = free_sessions.back();
+      free_sessions.pop_back();
+      session_of[node_i] = session_i;
+      running.push_back(node_i);
+      execution_context.dispatch([&execution_context, &nodes, node_i, session_i]() {
+        ExecuteDagNode(nodes[node_i], execution_context, session_i);
+        execution_context.notify(utils::ReadinessToken{static_cast<size_t>(node_i)});
+      });
+    }
+    if (running.empty() && utils::IsStopRequested()) {
+      break;
+    }
+    MG_ASSERT(!running.empty(), "no batch is ready, the import DAG is broken");
+
+    const auto node_i = execution_context.notifier.Await().GetId();
+    running.erase(std::find(running.begin(), running.end(), node_i));
+    free_sessions.push_back(session_of[node_i]);
+    auto &node = nodes[node_i];
+    MG_ASSERT(node.batch.is_executed, "a batch finished without being executed");
+    committed++;
+    for (const auto dependent_i : node.dependents) {
+      if (--nodes[dependent_i].dependencies == 0) {
+        ready.insert(dependent_i);
+      }
+    }
+  }
+}
+
+int Run(const utils::bolt::Config &bolt_config, const Config &config) {
   // NOTE: In the execution context it's possible to define size of the thread pool + how many different batches are
   // held in RAM at any given time. For simplicity of runtime flags, these to are set to the same value
   // (workers_number).
-  BatchExecutionContext execution_context(batch_size, workers_number, workers_number, bolt_config);
+  std::optional<utils::Simulator> simulator;
+  if (config.simulation) {
+    simulator.emplace(*config.simulation);
+  }
+  std::optional<utils::Checkpoint> checkpoint;
+  if (!config.checkpoint_file.empty()) {
+    checkpoint.emplace(config.checkpoint_file, config.resume);
+    if (!checkpoint->IsOpen()) {
+      console::EchoFailure("Unable to open the checkpoint file", config.checkpoint_file);
+      return 1;
+    }
+    // The simulated database starts empty, it learns the committed vertices by reading the committed queries.
+    if (!simulator) {
+      checkpoint->SeekInput();
+    }
+  }
+  BatchExecutionContext execution_context(config.batch_size, config.workers_number, config.workers_number,
+                                          config.edge_scheduling, config.merge_scheduling, config.max_batch_attempts,
+                                          bolt_config, simulator ? &*simulator : nullptr);
+  if (!config.reject_file.empty()) {
+    execution_context.OpenRejectFile(config.reject_file, config.resume);
+  }
+  execution_context.merge_key_property = config.merge_key_property;
+  execution_context.max_memory = config.max_memory;
+  execution_context.checkpoint = checkpoint ? &*checkpoint : nullptr;
+  execution_context.progress.Start(config.progress);
   while (true) {
     auto batches = FetchBatches(execution_context);
     if (batches.Empty()) {
       break;
     }
+    if (config.import_scheduler == ImportScheduler::DAG) {
+      // NOTE: The end of a window is still a barrier, the DAG is built out of the batches held in RAM.
+      auto nodes = [&batches]() {
+        utils::trace::Span span("build dag");
+        return BuildDag(batches);
+      }();
+      utils::trace::Span span("execute dag");
+      ExecuteDag(nodes, execution_context);
+      continue;
+    }
+    // Each phase is a span on the main thread, the batches are spans on the workers.
+    auto phase = [](const char *name, auto execute) {
+      utils::trace::Span span(name);
+      execute();
+    };
     // Stuff like CREATE INDEX.
-    ExecuteSerial(batches.pre_queries, execution_context);
+    phase("pre queries", [&]() { ExecuteSerial(batches.pre_queries, execution_context); });
     // Vertices have to come first because edges depend on vertices.
-    ExecuteBatchesParallel(batches.vertex_batches, execution_context, bolt_config);
-    ExecuteBatchesParallel(batches.edge_batches, execution_context, bolt_config);
+    phase("vertex batches", [&]() { ExecuteBatchesParallel(batches.vertex_batches, execution_context); });
+    phase("node merges", [&]() { ExecuteLanesParallel(batches.node_merge_lanes, execution_context); });
+    phase("edge batches", [&]() { ExecuteBatchesParallel(batches.edge_batches, execution_context); });
+    phase("relationship merges", [&]() { ExecuteLanesParallel(batches.relationship_merge_lanes, execution_context); });
     // Any cleanup queries.
-    ExecuteSerial(batches.post_queries, execution_context);
+    phase("post queries", [&]() { ExecuteSerial(batches.post_queries, execution_context); });
+  }
+  execution_context.progress.Finish();
+  const auto stopped = utils::IsStopRequested();
+  if (checkpoint) {
+    checkpoint->Flush();
+    if (checkpoint->Skipped() > 0) {
+      std::cerr << "Checkpoint: " << checkpoint->Skipped() << " queries committed before were skipped" << std::endl;
+    }
+  }
+  if (stopped) {
+    std::cerr << "Import stopped, the rest of the input can be imported with --resume" << std::endl;
+  }
+  // The abort rate is the main thing to compare between the edge scheduling modes.
+  const auto attempts = execution_context.progress.attempts.load();
+  const auto aborts = execution_context.progress.aborts.load();
+  std::cerr << "Batched import: " << attempts - aborts << " batches executed, " << aborts << " aborted ("
+            << (attempts > 0 ? 100.0 * static_cast<double>(aborts) / static_cast<double>(attempts) : 0.0)
+            << "% abort rate), " << execution_context.progress.rejected.load() << " queries rejected" << std::endl;
+  auto mib = [](uint64_t bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); };
+  std::cerr << "Memory: peak tracked " << mib(execution_context.memory_tracker.Peak()) << " MiB";
+  if (config.max_memory > 0) {
+    std::cerr << " (limit " << mib(config.max_memory) << " MiB)";
+  }
+  if (auto peak_rss = utils::PeakRss(); peak_rss) {
+    std::cerr << ", peak RSS " << mib(*peak_rss) << " MiB";
+  }
+  std::cerr << std::endl;
+  if (simulator) {
+    const auto &stats = simulator->Stats();
+    const auto seconds = simulator->Now().count();
+    std::cerr << "Simulation: " << stats.committed_queries << " queries committed in " << seconds
+              << " virtual seconds (" << (seconds > 0 ? static_cast<double>(stats.committed_queries) / seconds : 0.0)
+              << " queries/s), " << stats.conflicts << " conflicts, " << stats.drops << " connection drops"
+              << std::endl;
   }
-  return 0;
+  return stopped ? 1 : 0;
 }
 
 }  // namespace mode::batch_import
@@ -15,7 +15,12 @@
 
 #pragma once
 
+#include <optional>
+#include <string>
+
 #include "utils/bolt.hpp"
+#include "utils/progress.hpp"
+#include "utils/simulator.hpp"
 
 // NOTE: Batched and parallel execution has many practical issue.
 //   * In the transactional mode, there are many serialization errors -> check if a transaction was successfully
@@ -25,6 +30,54 @@
 
 namespace mode::batch_import {
 
-int Run(const utils::bolt::Config &bolt_config, int batch_size, int workers_number);
+enum class EdgeScheduling {
+  /// Edge batches are formed and executed in the input order.
+  ARRIVAL,
+  /// Edge queries are grouped into lanes by their MATCH endpoint keys and batches sharing an endpoint key are never
+  /// executed at the same time.
+  CONFLICT_AWARE,
+};
+
+enum class MergeScheduling {
+  /// MERGE queries are executed one by one after all other batches.
+  SERIAL,
+  /// MERGE queries are sharded by their MERGE key onto worker lanes. Queries with the same key keep the input order
+  /// inside a lane, different lanes are executed in parallel.
+  HASH_PARTITIONED,
+};
+
+enum class ImportScheduler {
+  /// Setup queries, vertex batches, edge batches and the rest are executed one phase after another.
+  PHASED,
+  /// Batches are ordered only by what they read and write (labels, vertex keys, index DDL), a batch is executed as soon
+  /// as all the batches it depends on are committed.
+  DAG,
+};
+
+struct Config {
+  int batch_size;
+  int workers_number;
+  EdgeScheduling edge_scheduling;
+  MergeScheduling merge_scheduling;
+  /// The property the MERGE queries are sharded by, empty means the only property of the merged pattern.
+  std::string merge_key_property;
+  ImportScheduler import_scheduler;
+  /// A batch is retried this many times after a broken connection or when a query created nothing, conflicts are
+  /// retried until the batch passes (with a warning after this many).
+  int max_batch_attempts;
+  /// Where the queries that fail on their own are written, empty means nowhere.
+  std::string reject_file;
+  /// If set, the batches are executed against a simulated database in virtual time instead of a real one.
+  std::optional<utils::SimulatorConfig> simulation;
+  /// Max bytes held by a window of batches (parsed queries + scheduling metadata), 0 means no limit.
+  uint64_t max_memory;
+  /// Journal of the committed queries (see utils/checkpoint.hpp), empty means no journal.
+  std::string checkpoint_file;
+  /// Skip what the checkpoint journal says was already committed.
+  bool resume;
+  utils::ProgressConfig progress;
+};
+
+int Run(const utils::bolt::Config &bolt_config, const Config &config);
 
 }  // namespace mode::batch_import
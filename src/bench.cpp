@@ -0,0 +1,391 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "bench.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "utils/checkpoint.hpp"
+#include "utils/histogram.hpp"
+#include "utils/utils.hpp"
+
+namespace mode::bench {
+
+namespace {
+
+struct Generator {
+  enum class Type { INT, FLOAT, STRING, CHOICE, SEQ };
+  Type type;
+  /// The length of STRING and the start of SEQ as well.
+  int64_t min{0};
+  int64_t max{0};
+  double float_min{0.0};
+  double float_max{0.0};
+  std::vector<std::string> choices;
+};
+
+struct Template {
+  std::string name;
+  double weight;
+  std::vector<std::variant<std::string, Generator>> parts;
+};
+
+std::atomic<int64_t> sequence{0};
+
+std::vector<std::string_view> Split(std::string_view text, char separator) {
+  std::vector<std::string_view> parts;
+  for (auto pos = text.find(separator); pos != std::string_view::npos; pos = text.find(separator)) {
+    parts.push_back(text.substr(0, pos));
+    text.remove_prefix(pos + 1);
+  }
+  parts.push_back(text);
+  return parts;
+}
+
+template <class T>
+std::optional<T> ParseNumber(std::string_view text) {
+  T value{};
+  if constexpr (std::is_floating_point_v<T>) {
+    // No floating point std::from_chars on older macOS.
+    const std::string number(text);
+    char *end = nullptr;
+    value = std::strtod(number.c_str(), &end);
+    if (number.empty() || end != number.c_str() + number.size()) {
+      return std::nullopt;
+    }
+  } else {
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc() || end != text.data() + text.size()) {
+      return std::nullopt;
+    }
+  }
+  return value;
+}
+
+Generator MakeGenerator(Generator::Type type) {
+  return Generator{.type = type, .min = 0, .max = 0, .float_min = 0.0, .float_max = 0.0, .choices = {}};
+}
+
+/// The part between "${" and "}".
+std::optional<Generator> ParseGenerator(std::string_view spec) {
+  const auto args = Split(spec, ':');
+  if (args[0] == "int" && args.size() == 3) {
+    auto min = ParseNumber<int64_t>(args[1]);
+    auto max = ParseNumber<int64_t>(args[2]);
+    if (min && max && *min <= *max) {
+      auto generator = MakeGenerator(Generator::Type::INT);
+      generator.min = *min;
+      generator.max = *max;
+      return generator;
+    }
+  } else if (args[0] == "float" && args.size() == 3) {
+    auto min = ParseNumber<double>(args[1]);
+    auto max = ParseNumber<double>(args[2]);
+    if (min && max && *min <= *max) {
+      auto generator = MakeGenerator(Generator::Type::FLOAT);
+      generator.float_min = *min;
+      generator.float_max = *max;
+      return generator;
+    }
+  } else if (args[0] == "string" && args.size() == 2) {
+    if (auto length = ParseNumber<int64_t>(args[1]); length && *length >= 0) {
+      auto generator = MakeGenerator(Generator::Type::STRING);
+      generator.min = *length;
+      return generator;
+    }
+  } else if (args[0] == "choice" && args.size() == 2) {
+    auto generator = MakeGenerator(Generator::Type::CHOICE);
+    for (auto choice : Split(args[1], '|')) {
+      generator.choices.emplace_back(choice);
+    }
+    return generator;
+  } else if (args[0] == "seq" && args.size() <= 2) {
+    auto start = args.size() == 2 ? ParseNumber<int64_t>(args[1]) : std::optional<int64_t>(0);
+    if (start) {
+      auto generator = MakeGenerator(Generator::Type::SEQ);
+      generator.min = *start;
+      return generator;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<Template> ParseTemplate(std::string_view line) {
+  const auto weight_end = line.find(' ');
+  const auto name_end = weight_end == std::string_view::npos ? weight_end : line.find(' ', weight_end + 1);
+  if (name_end == std::string_view::npos) {
+    return std::nullopt;
+  }
+  auto weight = ParseNumber<double>(line.substr(0, weight_end));
+  if (!weight || *weight <= 0) {
+    return std::nullopt;
+  }
+  Template query_template{.name = std::string(line.substr(weight_end + 1, name_end - weight_end - 1)),
+                          .weight = *weight,
+                          .parts = {}};
+  auto query = line.substr(name_end + 1);
+  for (auto begin = query.find("${"); begin != std::string_view::npos; begin = query.find("${")) {
+    const auto end = query.find('}', begin);
+    if (end == std::string_view::npos) {
+      return std::nullopt;
+    }
+    auto generator = ParseGenerator(query.substr(begin + 2, end - begin - 2));
+    if (!generator) {
+      return std::nullopt;
+    }
+    query_template.parts.emplace_back(std::string(query.substr(0, begin)));
+    query_template.parts.emplace_back(std::move(*generator));
+    query.remove_prefix(end + 1);
+  }
+  query_template.parts.emplace_back(std::string(query));
+  return query_template;
+}
+
+std::optional<std::vector<Template>> LoadWorkload(const std::string &path) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    console::EchoFailure("Unable to open the workload file", path);
+    return std::nullopt;
+  }
+  std::vector<Template> templates;
+  std::string line;
+  for (int line_number = 1; std::getline(file, line); ++line_number) {
+    std::string_view trimmed(line);
+    trimmed.remove_prefix(std::min(trimmed.find_first_not_of(" \t"), trimmed.size()));
+    trimmed.remove_suffix(trimmed.size() - std::min(trimmed.find_last_not_of(" \t\r") + 1, trimmed.size()));
+    if (trimmed.empty() || trimmed.starts_with('#') || trimmed.starts_with("//")) {
+      continue;
+    }
+    auto query_template = ParseTemplate(trimmed);
+    if (!query_template) {
+      console::EchoFailure("Invalid workload line " + std::to_string(line_number),
+                           line + "\nExpected \"<weight> <name> <query>\" with valid ${...} generators");
+      return std::nullopt;
+    }
+    templates.push_back(std::move(*query_template));
+  }
+  if (templates.empty()) {
+    console::EchoFailure("Empty workload", path);
+    return std::nullopt;
+  }
+  return templates;
+}
+
+std::string Render(const Template &query_template, std::mt19937_64 &random) {
+  static constexpr std::string_view kAlphabet = "abcdefghijklmnopqrstuvwxyz0123456789";
+  std::string query;
+  for (const auto &part : query_template.parts) {
+    if (const auto *text = std::get_if<std::string>(&part)) {
+      query += *text;
+      continue;
+    }
+    const auto &generator = std::get<Generator>(part);
+    switch (generator.type) {
+      case Generator::Type::INT:
+        query += std::to_string(std::uniform_int_distribution<int64_t>(generator.min, generator.max)(random));
+        break;
+      case Generator::Type::FLOAT: {
+        const auto begin = query.size();
+        utils::AppendFloat(query,
+                           std::uniform_real_distribution<double>(generator.float_min, generator.float_max)(random));
+        // Cypher takes 1 for an integer and has no '+' in the exponent of the float literals.
+        if (const auto plus = query.find('+', begin); plus != std::string::npos) {
+          query.erase(plus, 1);
+        }
+        if (query.find_first_of(".e", begin) == std::string::npos) {
+          query.append(".0");
+        }
+        break;
+      }
+      case Generator::Type::STRING:
+        for (int64_t i = 0; i < generator.min; ++i) {
+          query += kAlphabet[random() % kAlphabet.size()];
+        }
+        break;
+      case Generator::Type::CHOICE:
+        query += generator.choices[random() % generator.choices.size()];
+        break;
+      case Generator::Type::SEQ:
+        query += std::to_string(generator.min + sequence++);
+        break;
+    }
+  }
+  return query;
+}
+
+struct SessionStats {
+  std::vector<utils::Histogram> latencies;
+  std::vector<uint64_t> errors;
+  /// Open loop only, the queries that should have been sent before the end of the run but weren't.
+  uint64_t missed{0};
+  bool connected{true};
+};
+
+void RunSession(const utils::bolt::Config &bolt_config, const Config &config, const std::vector<Template> &templates,
+                int index, std::chrono::steady_clock::time_point start, SessionStats *stats) {
+  auto session = MakeBoltSession(bolt_config);
+  if (!session) {
+    stats->connected = false;
+    return;
+  }
+  std::mt19937_64 random(config.seed + index);
+  std::vector<double> weights;
+  for (const auto &query_template : templates) {
+    weights.push_back(query_template.weight);
+  }
+  std::discrete_distribution<size_t> pick(weights.begin(), weights.end());
+
+  const bool open_loop = config.rate > 0;
+  const auto end = start + config.duration;
+  // In the open loop, each session sends every sessions/rate seconds, the sessions are staggered evenly.
+  const auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(open_loop ? config.sessions / config.rate : 0.0));
+  auto intended = start + interval * index / config.sessions;
+  while (!utils::IsStopRequested()) {
+    if (open_loop && intended >= end) {
+      break;
+    }
+    // A server which can't keep up with the rate doesn't prolong the run, the queries it's behind with are counted as
+    // missed, so they don't just vanish from the results.
+    if (std::chrono::steady_clock::now() >= end) {
+      if (open_loop && interval.count() > 0) {
+        stats->missed += (end - intended + interval - std::chrono::steady_clock::duration(1)) / interval;
+      }
+      break;
+    }
+    if (open_loop) {
+      std::this_thread::sleep_until(intended);
+    }
+    const auto template_index = pick(random);
+    const auto query = Render(templates[template_index], random);
+    const auto sent = std::chrono::steady_clock::now();
+    try {
+      query::ExecuteQuery(session.get(), query);
+      const auto latency = std::chrono::steady_clock::now() - (open_loop ? intended : sent);
+      stats->latencies[template_index].Record(
+          std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+    } catch (const utils::ClientQueryException &e) {
+      ++stats->errors[template_index];
+    } catch (const utils::ClientFatalException &e) {
+      ++stats->errors[template_index];
+      session = MakeBoltSession(bolt_config);
+      if (!session) {
+        stats->connected = false;
+        return;
+      }
+    }
+    intended += interval;
+  }
+}
+
+void PrintRow(const std::string &name, const utils::Histogram &latency, uint64_t errors, double seconds) {
+  auto ms = [](uint64_t us) { return static_cast<double>(us) / 1000.0; };
+  std::cout << std::left << std::setw(24) << name << std::right << std::setw(10) << latency.Count() << std::setw(8)
+            << errors << std::setw(12) << latency.Count() / seconds << std::setw(10) << latency.Mean() / 1000.0
+            << std::setw(10) << ms(latency.ValueAtPercentile(50)) << std::setw(10)
+            << ms(latency.ValueAtPercentile(90)) << std::setw(10) << ms(latency.ValueAtPercentile(99)) << std::setw(10)
+            << ms(latency.ValueAtPercentile(99.9)) << std::setw(10) << ms(latency.Max()) << '\n';
+}
+
+}  // namespace
+
+int Run(const utils::bolt::Config &bolt_config, const Config &config) {
+  auto templates = LoadWorkload(config.workload_file);
+  if (!templates) {
+    return 1;
+  }
+  // Ctrl-C ends the run early, the results so far are still reported.
+  utils::EnableGracefulStop();
+
+  std::vector<SessionStats> stats(config.sessions);
+  for (auto &session_stats : stats) {
+    session_stats.latencies.resize(templates->size());
+    session_stats.errors.resize(templates->size());
+  }
+  const auto start = std::chrono::steady_clock::now();
+  {
+    std::vector<std::thread> sessions;
+    for (int i = 0; i < config.sessions; ++i) {
+      sessions.emplace_back(RunSession, std::cref(bolt_config), std::cref(config), std::cref(*templates), i, start,
+                            &stats[i]);
+    }
+    for (auto &session : sessions) {
+      session.join();
+    }
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::vector<utils::Histogram> latencies(templates->size());
+  std::vector<uint64_t> errors(templates->size(), 0);
+  utils::Histogram total_latency;
+  uint64_t total_errors = 0;
+  uint64_t missed = 0;
+  bool connected = true;
+  for (const auto &session_stats : stats) {
+    connected = connected && session_stats.connected;
+    missed += session_stats.missed;
+    for (size_t i = 0; i < templates->size(); ++i) {
+      latencies[i].Merge(session_stats.latencies[i]);
+      errors[i] += session_stats.errors[i];
+    }
+  }
+  for (size_t i = 0; i < templates->size(); ++i) {
+    total_latency.Merge(latencies[i]);
+    total_errors += errors[i];
+  }
+
+  std::cout << std::fixed << std::setprecision(3);
+  if (config.rate > 0) {
+    std::cout << "Bench: open loop at " << config.rate << " queries/s, latencies from the intended send time "
+              << "(coordinated omission corrected)\n";
+  } else {
+    std::cout << "Bench: closed loop\n";
+  }
+  std::cout << "Bench: " << config.sessions << " sessions, " << seconds << " s, " << total_latency.Count()
+            << " queries (" << total_latency.Count() / seconds << " queries/s), " << total_errors << " errors";
+  if (config.rate > 0) {
+    std::cout << ", " << missed << " missed (not sent before the end, the server was behind)";
+  }
+  std::cout << '\n';
+  std::cout << std::left << std::setw(24) << "template" << std::right << std::setw(10) << "queries" << std::setw(8)
+            << "errors" << std::setw(12) << "queries/s" << std::setw(10) << "mean ms" << std::setw(10) << "p50"
+            << std::setw(10) << "p90" << std::setw(10) << "p99" << std::setw(10) << "p99.9" << std::setw(10) << "max"
+            << '\n';
+  for (size_t i = 0; i < templates->size(); ++i) {
+    PrintRow((*templates)[i].name, latencies[i], errors[i], seconds);
+  }
+  PrintRow("total", total_latency, total_errors, seconds);
+  std::cout.flush();
+  if (!connected) {
+    console::EchoFailure("Bench", "some sessions couldn't connect");
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace mode::bench
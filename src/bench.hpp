@@ -0,0 +1,46 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "utils/bolt.hpp"
+
+namespace mode::bench {
+
+/// The workload file has a query template per line, "<weight> <name> <query>", lines starting with # or // are
+/// comments. The query can contain the value generators, replaced by a new value on every execution:
+///   ${int:<min>:<max>}, ${float:<min>:<max>}  uniform in [min, max]
+///   ${string:<length>}                        random lowercase letters and digits
+///   ${choice:<a>|<b>|...}                     one of the values
+///   ${seq} or ${seq:<start>}                  a counter shared by all the sessions, e.g. for unique ids
+struct Config {
+  std::string workload_file;
+  int sessions;
+  std::chrono::milliseconds duration;
+  /// Queries per second of all the sessions together (open loop), 0 runs each session back to back (closed loop).
+  double rate;
+  uint64_t seed;
+};
+
+/// Runs the workload and prints the throughput and the latency percentiles of each template. In the open loop, the
+/// latency is measured from the time the query should have been sent according to the rate, so that a slow response
+/// delaying the next queries shows up in their latency as well (coordinated omission correction).
+int Run(const utils::bolt::Config &bolt_config, const Config &config);
+
+}  // namespace mode::bench
@@ -113,17 +113,20 @@ int Run(utils::bolt::Config &bolt_config, const std::string &history, bool no_hi
     }
 
     try {
-      auto ret = query::ExecuteQuery(session.get(), query->query);
-      if (ret.records.size() > 0) {
+      auto sink = format::MakeRecordSink(output_opts, csv_opts);
+      auto ret = query::ExecuteQuery(session.get(), query->query, sink.get());
+      if (sink) {
+        sink->Finish();
+      } else if (ret.records.size() > 0) {
         Output(ret.header, ret.records, output_opts, csv_opts);
       }
       std::string summary;
-      if (ret.records.size() == 0) {
+      if (ret.num_records == 0) {
         summary = "Empty set";
-      } else if (ret.records.size() == 1) {
-        summary = std::to_string(ret.records.size()) + " row in set";
+      } else if (ret.num_records == 1) {
+        summary = std::to_string(ret.num_records) + " row in set";
       } else {
-        summary = std::to_string(ret.records.size()) + " rows in set";
+        summary = std::to_string(ret.num_records) + " rows in set";
       }
       std::printf("%s (round trip in %.3lf sec)\n", summary.c_str(), ret.wall_time.count());
       auto history_ret = save_history();
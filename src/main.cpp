@@ -18,6 +18,7 @@
 #include <signal.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cstdio>
 #include <iostream>
 #include <optional>
@@ -41,11 +42,21 @@
 #include <replxx.h>
 
 #include "batch_import.hpp"
+#include "bench.hpp"
 #include "interactive.hpp"
 #include "parsing.hpp"
+#include "replay.hpp"
 #include "serial_import.hpp"
 #include "utils/assert.hpp"
+#include "utils/bolt_record.hpp"
+#include "utils/checkpoint.hpp"
+#include "utils/compression.hpp"
 #include "utils/constants.hpp"
+#include "utils/memory_tracker.hpp"
+#include "utils/output.hpp"
+#include "utils/perf_counters.hpp"
+#include "utils/progress.hpp"
+#include "utils/trace.hpp"
 #include "utils/utils.hpp"
 #include "version.hpp"
 
@@ -64,12 +75,34 @@ DEFINE_bool(use_ssl, false, "Use SSL when connecting to the server.");
 DEFINE_bool(fit_to_screen, false, "Fit output width to screen width.");
 DEFINE_bool(term_colors, false, "Use terminal colors syntax highlighting.");
 DEFINE_string(output_format, "tabular",
-              "Query output format can be csv, tabular or cypherl. If output format is "
+              "Query output format can be csv, tabular, jsonl, arrow or cypherl. If output format is "
               "not tabular `fit-to-screen` flag is ignored.");
+DEFINE_string(output_file, "",
+              "Write the query results to the file instead of the standard output, `fit-to-screen` is ignored then. "
+              "The results are written in large blocks by a background thread either way.");
+DEFINE_string(output_compression, "none",
+              "Compress the output, none, gzip or zstd. The output is compressed in 1MiB blocks by `format-workers` "
+              "threads, each block is a separate gzip member or zstd frame, written in order.");
+DEFINE_validator(output_compression,
+                 [](const char *, const std::string &value) { return utils::compression::Parse(value).has_value(); });
+DEFINE_int32(format_workers, 0,
+             "Threads formatting the CSV and JSONL output and compressing it, 0 means the number of cores. The records "
+             "are formatted in chunks while they are fetched, the chunks are written in order.");
+DEFINE_validator(format_workers, [](const char *, int32_t value) { return value >= 0; });
+DEFINE_int32(arrow_batch_rows, 65536,
+             "The records in each record batch of the arrow output, the types of the columns are taken from the "
+             "first batch.");
+DEFINE_validator(arrow_batch_rows, [](const char *, int32_t value) { return value > 0; });
+DEFINE_int32(tabular_sample_rows, 0,
+             "If not 0, the tabular output is printed while the records are fetched, without keeping the whole result "
+             "in memory. The widths of the columns are estimated from that many first records, longer cells of the "
+             "later records are truncated. 0 sizes the columns from all the records.");
+DEFINE_validator(tabular_sample_rows, [](const char *, int32_t value) { return value >= 0; });
 DEFINE_bool(verbose_execution_info, false,
             "Output the additional information about query such as query cost, parsing, planning and execution times.");
 DEFINE_validator(output_format, [](const char *, const std::string &value) {
-  if (value == constants::kCsvFormat || value == constants::kTabularFormat || value == constants::kCypherlFormat) {
+  if (value == constants::kCsvFormat || value == constants::kTabularFormat || value == constants::kCypherlFormat ||
+      value == constants::kJsonlFormat || value == constants::kArrowFormat) {
     return true;
   }
   return false;
@@ -101,9 +134,12 @@ DEFINE_string(
     "an experimental feature, the behavior might be unexpected because it depends on how the underlying database "
     "system is configured (e.g., in the transactional setup there might be many serialization errors, while in the "
     "analytical setup, ordering of nodes/edges is very important. `parser` mode will just print info about the "
-    "provided queries. NOTE: `parser` mode won't execute any query against the underlying database system.");
+    "provided queries. NOTE: `parser` mode won't execute any query against the underlying database system. `bench` "
+    "mode runs the --bench-workload queries for --bench-duration-ms and reports the latencies, see --bench-*. `replay` "
+    "mode sends the queries of a timestamped log at the recorded pace, see --replay-*.");
 DEFINE_validator(import_mode, [](const char *, const std::string &value) {
-  if (value == constants::kSerialMode || value == constants::kBatchedParallel || value == constants::kParserMode) {
+  if (value == constants::kSerialMode || value == constants::kBatchedParallel || value == constants::kParserMode ||
+      value == constants::kBenchMode || value == constants::kReplayMode) {
     return true;
   }
   return false;
@@ -111,6 +147,125 @@ DEFINE_validator(import_mode, [](const char *, const std::string &value) {
 DEFINE_int32(batch_size, 1000, "A single batch size only when --import-mode=batched-parallel.");
 DEFINE_int32(workers_number, 32,
              "The number of threads to execute batches in parallel, only when --import-mode=batched-parallel");
+DEFINE_string(edge_scheduling, "arrival",
+              "How edge batches are scheduled, only when --import-mode=batched-parallel. `arrival` batches edges in "
+              "the input order. `conflict-aware` extracts the MATCH endpoint keys (label + property value) of each "
+              "edge query, groups edges sharing an endpoint into the same batches and never runs batches with "
+              "overlapping keys concurrently, which avoids most of the serialization errors around high-degree "
+              "vertices.");
+DEFINE_validator(edge_scheduling, [](const char *, const std::string &value) {
+  if (value == constants::kArrivalScheduling || value == constants::kConflictAwareScheduling) {
+    return true;
+  }
+  return false;
+});
+DEFINE_string(merge_scheduling, "serial",
+              "How MERGE queries are executed, only when --import-mode=batched-parallel. `serial` executes them one by "
+              "one after all other batches. `hash-partitioned` shards them by the MERGE key (the label and the "
+              "--merge-key-property of the merged node, or the key properties of the matched endpoints) onto worker "
+              "lanes: queries with the same key keep the input order, while different lanes run in parallel. Node "
+              "MERGEs run right after the vertex batches, relationship MERGEs between matched nodes after the edge "
+              "batches; anything else (more labels, no literal key property, ...) falls back to the serial "
+              "execution.");
+DEFINE_validator(merge_scheduling, [](const char *, const std::string &value) {
+  if (value == constants::kSerialMergeScheduling || value == constants::kHashPartitionedMergeScheduling) {
+    return true;
+  }
+  return false;
+});
+DEFINE_string(merge_key_property, "",
+              "The property which identifies the vertices for --merge-scheduling=hash-partitioned, e.g. `id`. If it's "
+              "empty, only the MERGE patterns with a single property are sharded, by that property.");
+DEFINE_string(import_scheduler, "phased",
+              "How batches are ordered, only when --import-mode=batched-parallel. `phased` executes the setup queries, "
+              "vertex batches, edge batches and the remaining queries one phase after another. `dag` extracts the "
+              "labels, vertex keys and index DDL each batch reads and writes, and executes a batch as soon as the "
+              "batches it conflicts with are committed, e.g. edges between already imported vertices don't wait for "
+              "the unrelated vertex batches. Queries that can't be analyzed (SET, DELETE, STORAGE MODE, ...) still "
+              "act as barriers.");
+DEFINE_validator(import_scheduler, [](const char *, const std::string &value) {
+  if (value == constants::kPhasedImportScheduler || value == constants::kDagImportScheduler) {
+    return true;
+  }
+  return false;
+});
+DEFINE_int32(max_batch_attempts, 20,
+             "How many times a batch is retried because of a broken connection before the import fails, or because a "
+             "query created nothing (e.g. a matched node isn't there yet) before it's treated as a query error, only "
+             "when --import-mode=batched-parallel. Serialization conflicts are retried until the batch passes, with a "
+             "warning after this many of them. On a query error the batch is bisected until the queries failing on "
+             "their own are found and rejected.");
+DEFINE_validator(max_batch_attempts, [](const char *, int32_t value) { return value > 0; });
+DEFINE_string(reject_file, "",
+              "File to write the rejected queries to (prefixed by a comment with the input line number and the "
+              "error), only when --import-mode=batched-parallel.");
+DEFINE_string(max_memory, "",
+              "Memory budget of the batched-parallel import, e.g. 512MB or 4GB (powers of 1024). Once the parsed "
+              "queries waiting for execution hold that many bytes, mgconsole stops reading the input until they are "
+              "executed. The results fetched while executing them aren't counted. The peak tracked memory and the peak "
+              "RSS are reported at the end. Empty means no limit.");
+DEFINE_validator(max_memory, [](const char *, const std::string &value) {
+  return value.empty() || utils::ParseByteSize(value).has_value();
+});
+DEFINE_string(checkpoint_file, "",
+              "Journal of the committed parts of the input (serial and batched-parallel import). If the import is "
+              "interrupted, run it again with the same input and --resume to import only the rest. With the journal, "
+              "the first SIGINT/SIGTERM stops reading the input, waits for the batches in flight and flushes the "
+              "journal.");
+DEFINE_bool(resume, false, "Skip the parts of the input the --checkpoint-file says were committed.");
+DEFINE_bool(progress, false,
+            "Report the import progress (input consumed, ETA, queries/s, created nodes and relationships, retries, "
+            "...) while importing, as a status line if stderr is a terminal, otherwise as JSON lines. A summary with "
+            "the client time split between parsing, waiting for the database and formatting is printed at the end.");
+DEFINE_int32(progress_interval_ms, 1000, "How often the import progress is reported.");
+DEFINE_validator(progress_interval_ms, [](const char *, int32_t value) { return value > 0; });
+DEFINE_string(trace_file, "",
+              "Write Chrome trace events (chrome://tracing, https://ui.perfetto.dev) of the import to the file: "
+              "reading and classifying the queries, waiting in the worker queue, begin, run, pull, commit, backoff, "
+              "...");
+DEFINE_string(record_bolt, "",
+              "Record the Bolt requests and responses of the sessions (with timestamps) to the file, it can be served "
+              "back by mgconsole_replay_server.");
+DEFINE_bool(profile_counters, false,
+            "Count cycles, instructions, cache misses and branch misses (perf_event_open, Linux only) of the client "
+            "phases: reading and parsing the input, classifying the queries, fetching and formatting the results. A "
+            "per-phase table is printed at exit.");
+DEFINE_string(bench_workload, "",
+              "Workload of --import-mode=bench, a query template per line: \"<weight> <name> <query>\" where the "
+              "query can contain the value generators ${int:<min>:<max>}, ${float:<min>:<max>}, ${string:<length>}, "
+              "${choice:<a>|<b>|...} and ${seq}.");
+DEFINE_int32(bench_sessions, 8, "Number of concurrent sessions of --import-mode=bench.");
+DEFINE_validator(bench_sessions, [](const char *, int32_t value) { return value > 0; });
+DEFINE_int32(bench_duration_ms, 10000, "How long --import-mode=bench runs.");
+DEFINE_double(bench_rate, 0.0,
+              "Target queries per second of --import-mode=bench (open loop), the latencies are measured from the "
+              "intended send time. 0 runs each session back to back (closed loop).");
+DEFINE_validator(bench_rate, [](const char *, double value) { return value >= 0.0; });
+DEFINE_uint64(bench_seed, 0, "Seed of the --import-mode=bench value generators.");
+DEFINE_string(replay_format, "cypherl",
+              "Format of the --import-mode=replay log on the standard input. `cypherl` queries annotated with a "
+              "\"// @ts <timestamp> [latency_ms=<ms>]\" line or `csv` records \"<timestamp>,<query>[,<latency_ms>]\". "
+              "The timestamp is in seconds or an ISO 8601 UTC date and time.");
+DEFINE_validator(replay_format, [](const char *, const std::string &value) {
+  return value == constants::kCypherlFormat || value == constants::kCsvFormat;
+});
+DEFINE_int32(replay_sessions, 8, "Number of sessions --import-mode=replay sends the queries over.");
+DEFINE_validator(replay_sessions, [](const char *, int32_t value) { return value > 0; });
+DEFINE_double(replay_speed, 1.0,
+              "Pace of --import-mode=replay relative to the recorded one, e.g. 2 replays twice as fast, 0 as fast as "
+              "possible.");
+DEFINE_validator(replay_speed, [](const char *, double value) { return value >= 0.0; });
+DEFINE_bool(simulation, false,
+            "Execute the batched-parallel import against a simulated database in virtual time instead of connecting "
+            "to Memgraph. The run is deterministic for the given seed, at the end the simulated throughput and the "
+            "number of conflicts are reported. Meant for testing and benchmarking of the import scheduling.");
+DEFINE_uint64(simulation_seed, 0, "Seed of the simulated database, only when --simulation.");
+DEFINE_double(simulation_query_latency_ms, 1.0, "Mean virtual time of a single query, only when --simulation.");
+DEFINE_double(simulation_conflict_probability, 0.0,
+              "Probability that a transaction fails with a serialization error on top of the conflicts between "
+              "concurrent transactions touching the same vertices, only when --simulation.");
+DEFINE_double(simulation_drop_probability, 0.0,
+              "Probability that the connection drops during a transaction, only when --simulation.");
 DEFINE_bool(collect_parser_stats, true, "Collect parsing statistics only when --import-mode=parser");
 DEFINE_bool(print_parser_stats, true, "Print parser statistics for each query only when --import-mode=parser");
 
@@ -123,7 +278,11 @@ int main(int argc, char **argv) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
 
   format::CsvOptions csv_opts{FLAGS_csv_delimiter, FLAGS_csv_escapechar, FLAGS_csv_doublequote};
-  format::OutputOptions output_opts{FLAGS_output_format, FLAGS_fit_to_screen};
+  // A file has no screen width.
+  format::OutputOptions output_opts{FLAGS_output_format, FLAGS_fit_to_screen && FLAGS_output_file.empty(),
+                                    static_cast<uint64_t>(FLAGS_tabular_sample_rows),
+                                    static_cast<uint64_t>(FLAGS_format_workers),
+                                    static_cast<uint64_t>(FLAGS_arrow_batch_rows)};
 
   if (output_opts.output_format == constants::kCsvFormat && !csv_opts.ValidateDoubleQuote()) {
     console::EchoFailure(
@@ -133,6 +292,43 @@ int main(int argc, char **argv) {
     return 1;
   }
 
+  if (!FLAGS_output_file.empty() && !utils::output::OpenFile(FLAGS_output_file)) {
+    console::EchoFailure("Unable to open the output file", FLAGS_output_file);
+    return 1;
+  }
+  const auto compression = *utils::compression::Parse(FLAGS_output_compression);
+  // The messages printed between the compressed blocks (or the Arrow messages) would make them unreadable.
+  const auto binary =
+      output_opts.output_format == constants::kArrowFormat || compression != utils::compression::Type::NONE;
+  if (binary && FLAGS_output_file.empty() && !utils::output::SeparateConsole()) {
+    console::EchoFailure("Unable to separate the output", "the standard output can't be duplicated");
+    return 1;
+  }
+  utils::output::SetCompression(compression, static_cast<size_t>(FLAGS_format_workers));
+  if (binary) {
+    utils::output::SetBinary();
+  }
+
+  if (FLAGS_resume && FLAGS_checkpoint_file.empty()) {
+    console::EchoFailure("Unsupported flags", "--resume requires --checkpoint-file");
+    return 1;
+  }
+  // Only the batched-parallel import has batches in flight worth draining, the serial one exits right away.
+  if (!FLAGS_checkpoint_file.empty() && FLAGS_import_mode == constants::kBatchedParallel) {
+    utils::EnableGracefulStop();
+  }
+  if (!FLAGS_trace_file.empty()) {
+    utils::trace::Enable(FLAGS_trace_file);
+  }
+  if (!FLAGS_record_bolt.empty() && !utils::bolt_record::Enable(FLAGS_record_bolt)) {
+    console::EchoFailure("Unable to open the Bolt recording file", FLAGS_record_bolt);
+    return 1;
+  }
+  if (FLAGS_profile_counters) {
+    // Without the counters, the import still runs.
+    utils::perf::Enable();
+  }
+
   if (mg_init() != 0) {
     console::EchoFailure("Internal error", "Couldn't initialize all the resources");
     return 1;
@@ -151,6 +347,11 @@ int main(int argc, char **argv) {
 #else /* _WIN32 */
 
   auto shutdown = [](int exit_code = 0) {
+    // The import drains and exits on its own, the next signal exits right away.
+    if (utils::IsGracefulStopEnabled() && !utils::IsStopRequested()) {
+      utils::RequestStop();
+      return;
+    }
     if (is_shutting_down) return;
     is_shutting_down = 1;
 
@@ -173,7 +374,8 @@ int main(int argc, char **argv) {
   sigemptyset(&action.sa_mask);
   sigaddset(&action.sa_mask, SIGTERM);
   sigaddset(&action.sa_mask, SIGINT);
-  action.sa_flags = SA_RESTART;
+  // A restarted read of the input would block until the next line arrives, the stop has to interrupt it.
+  action.sa_flags = utils::IsGracefulStopEnabled() ? 0 : SA_RESTART;
   sigaction(SIGTERM, &action, nullptr);
   sigaction(SIGINT, &action, nullptr);
 
@@ -187,15 +389,68 @@ int main(int argc, char **argv) {
       .use_ssl = FLAGS_use_ssl,
   };
 
-  if (console::is_a_tty(STDIN_FILENO)) {  // INTERACTIVE
-    return mode::interactive::Run(bolt_config, FLAGS_history, FLAGS_no_history, FLAGS_verbose_execution_info, csv_opts,
-                                  output_opts);
+  const utils::ProgressConfig progress_config{
+      .enabled = FLAGS_progress,
+      .interval = std::chrono::milliseconds(FLAGS_progress_interval_ms),
+  };
+
+  if (FLAGS_import_mode == constants::kBenchMode) {
+    // Doesn't read the standard input.
+    return mode::bench::Run(bolt_config, mode::bench::Config{
+                                             .workload_file = FLAGS_bench_workload,
+                                             .sessions = FLAGS_bench_sessions,
+                                             .duration = std::chrono::milliseconds(FLAGS_bench_duration_ms),
+                                             .rate = FLAGS_bench_rate,
+                                             .seed = FLAGS_bench_seed,
+                                         });
+  } else if (console::is_a_tty(STDIN_FILENO)) {  // INTERACTIVE
+    const auto code = mode::interactive::Run(bolt_config, FLAGS_history, FLAGS_no_history,
+                                             FLAGS_verbose_execution_info, csv_opts, output_opts);
+    // Results which couldn't be written fail the run as well.
+    return utils::output::Close() ? code : 1;
+  } else if (FLAGS_import_mode == constants::kReplayMode) {
+    return mode::replay::Run(bolt_config, mode::replay::Config{
+                                              .format = FLAGS_replay_format,
+                                              .sessions = FLAGS_replay_sessions,
+                                              .speed = FLAGS_replay_speed,
+                                          });
   } else if (FLAGS_import_mode == constants::kParserMode) {
-    return mode::parsing::Run(FLAGS_collect_parser_stats, FLAGS_print_parser_stats);
+    return mode::parsing::Run(FLAGS_collect_parser_stats, FLAGS_print_parser_stats, progress_config);
   } else if (FLAGS_import_mode == constants::kBatchedParallel) {
-    return mode::batch_import::Run(bolt_config, FLAGS_batch_size, FLAGS_workers_number);
+    mode::batch_import::Config batch_config{
+        .batch_size = FLAGS_batch_size,
+        .workers_number = FLAGS_workers_number,
+        .edge_scheduling = FLAGS_edge_scheduling == constants::kConflictAwareScheduling
+                               ? mode::batch_import::EdgeScheduling::CONFLICT_AWARE
+                               : mode::batch_import::EdgeScheduling::ARRIVAL,
+        .merge_scheduling = FLAGS_merge_scheduling == constants::kHashPartitionedMergeScheduling
+                                ? mode::batch_import::MergeScheduling::HASH_PARTITIONED
+                                : mode::batch_import::MergeScheduling::SERIAL,
+        .merge_key_property = FLAGS_merge_key_property,
+        .import_scheduler = FLAGS_import_scheduler == constants::kDagImportScheduler
+                                ? mode::batch_import::ImportScheduler::DAG
+                                : mode::batch_import::ImportScheduler::PHASED,
+        .max_batch_attempts = FLAGS_max_batch_attempts,
+        .reject_file = FLAGS_reject_file,
+        .simulation = std::nullopt,
+        .max_memory = FLAGS_max_memory.empty() ? 0 : *utils::ParseByteSize(FLAGS_max_memory),
+        .checkpoint_file = FLAGS_checkpoint_file,
+        .resume = FLAGS_resume,
+        .progress = progress_config,
+    };
+    if (FLAGS_simulation) {
+      batch_config.simulation = utils::SimulatorConfig{
+          .seed = FLAGS_simulation_seed,
+          .query_latency_ms = FLAGS_simulation_query_latency_ms,
+          .conflict_probability = FLAGS_simulation_conflict_probability,
+          .drop_probability = FLAGS_simulation_drop_probability,
+      };
+    }
+    return mode::batch_import::Run(bolt_config, batch_config);
   } else if (FLAGS_import_mode == constants::kSerialMode) {
-    return mode::serial_import::Run(bolt_config, csv_opts, output_opts);
+    const auto code = mode::serial_import::Run(bolt_config, csv_opts, output_opts, FLAGS_checkpoint_file,
+                                               FLAGS_resume, progress_config);
+    return utils::output::Close() ? code : 1;
   } else {
     MG_FAIL("Unknown import mode!");
   }
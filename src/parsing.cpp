@@ -15,15 +15,21 @@
 
 #include "parsing.hpp"
 
+#include <chrono>
+
+#include "utils/progress.hpp"
 #include "utils/utils.hpp"
 
 namespace mode::parsing {
 
 using namespace std::string_literals;
 
-int Run(bool collect_parsing_stats, bool print_parser_stats) {
+int Run(bool collect_parsing_stats, bool print_parser_stats, const utils::ProgressConfig &progress_config) {
   int64_t query_index = 0;
+  utils::Progress progress;
+  progress.Start(progress_config);
   while (true) {
+    const auto parse_start = std::chrono::steady_clock::now();
     auto query = query::GetQuery(nullptr, collect_parsing_stats);
     if (!query) {
       break;
@@ -31,6 +37,7 @@ int Run(bool collect_parsing_stats, bool print_parser_stats) {
     if (query->query.empty()) {
       continue;
     }
+    progress.Read(*query, std::chrono::steady_clock::now() - parse_start);
     if (collect_parsing_stats && print_parser_stats) {
       std::cout << "Line: " << query->line_number << " "
                 << "Index: " << query->index << " "
@@ -45,6 +52,7 @@ int Run(bool collect_parsing_stats, bool print_parser_stats) {
     }
     ++query_index;
   }
+  progress.Finish();
   std::cout << "Parsed " << query_index << " queries" << std::endl;
   return 0;
 }
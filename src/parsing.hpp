@@ -15,8 +15,10 @@
 
 #pragma once
 
+#include "utils/progress.hpp"
+
 namespace mode::parsing {
 
-int Run(bool collect_parser_stats, bool print_parser_stats);
+int Run(bool collect_parser_stats, bool print_parser_stats, const utils::ProgressConfig &progress_config);
 
 }  // namespace mode::parsing
@@ -0,0 +1,431 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "replay.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "utils/checkpoint.hpp"
+#include "utils/constants.hpp"
+#include "utils/histogram.hpp"
+#include "utils/utils.hpp"
+
+namespace mode::replay {
+
+namespace {
+
+constexpr std::string_view kTimestampAnnotation = "// @ts";
+constexpr std::string_view kLatencyKey = "latency_ms=";
+
+struct Entry {
+  /// Since the first query of the log after loading.
+  std::chrono::microseconds time;
+  std::string query;
+  std::optional<uint64_t> recorded_latency_us;
+};
+
+std::string_view TrimView(std::string_view text) {
+  text.remove_prefix(std::min(text.find_first_not_of(" \t\r\n"), text.size()));
+  text.remove_suffix(text.size() - std::min(text.find_last_not_of(" \t\r\n") + 1, text.size()));
+  return text;
+}
+
+std::optional<double> ParseDouble(std::string_view text) {
+  const std::string number(text);
+  char *end = nullptr;
+  const double value = std::strtod(number.c_str(), &end);
+  if (number.empty() || end != number.c_str() + number.size()) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+/// Days since 1970-01-01 of a proleptic Gregorian date (http://howardhinnant.github.io/date_algorithms.html).
+int64_t DaysFromCivil(int64_t year, unsigned month, unsigned day) {
+  year -= month <= 2;
+  const int64_t era = (year >= 0 ? year : year - 399) / 400;
+  const auto year_of_era = static_cast<unsigned>(year - era * 400);
+  const unsigned day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+  const unsigned day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+  return era * 146097 + static_cast<int64_t>(day_of_era) - 719468;
+}
+
+/// Seconds, e.g. Unix time, or an ISO 8601 UTC date and time, "2024-01-31T12:00:00.250Z" or "2024-01-31 12:00:00".
+std::optional<std::chrono::microseconds> ParseTimestamp(std::string_view text) {
+  if (auto seconds = ParseDouble(text)) {
+    return std::chrono::microseconds(std::llround(*seconds * 1e6));
+  }
+  int year = 0;
+  unsigned month = 0;
+  unsigned day = 0;
+  unsigned hours = 0;
+  unsigned minutes = 0;
+  double seconds = 0.0;
+  int parsed = 0;
+  const std::string timestamp(text);
+  if (std::sscanf(timestamp.c_str(), "%d-%u-%u%*1[T ]%u:%u:%lf%n", &year, &month, &day, &hours, &minutes, &seconds,
+                  &parsed) != 6) {
+    return std::nullopt;
+  }
+  const auto rest = std::string_view(timestamp).substr(parsed);
+  if (month < 1 || month > 12 || day < 1 || day > 31 || hours > 23 || minutes > 59 || seconds < 0 || seconds >= 61 ||
+      !(rest.empty() || rest == "Z")) {
+    return std::nullopt;
+  }
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::hours(24 * DaysFromCivil(year, month, day) + hours) + std::chrono::minutes(minutes) +
+      std::chrono::microseconds(std::llround(seconds * 1e6)));
+}
+
+std::optional<uint64_t> ParseLatency(std::string_view text) {
+  auto latency = ParseDouble(TrimView(text));
+  if (!latency || *latency < 0) {
+    return std::nullopt;
+  }
+  return static_cast<uint64_t>(std::llround(*latency * 1000.0));
+}
+
+/// Every entry without a timestamp is sent right after the previous one, the entries are then ordered by time.
+void Normalize(const std::vector<std::optional<std::chrono::microseconds>> &times, std::vector<Entry> *entries) {
+  std::chrono::microseconds previous{0};
+  for (size_t i = 0; i < entries->size(); ++i) {
+    if (times[i]) {
+      previous = *times[i];
+    }
+    (*entries)[i].time = previous;
+  }
+  std::stable_sort(entries->begin(), entries->end(), [](const auto &a, const auto &b) { return a.time < b.time; });
+  const auto first = entries->empty() ? std::chrono::microseconds{0} : entries->front().time;
+  for (auto &entry : *entries) {
+    entry.time -= first;
+  }
+}
+
+std::optional<std::vector<Entry>> LoadCypherl() {
+  std::vector<Entry> entries;
+  std::vector<std::optional<std::chrono::microseconds>> times;
+  bool any_timestamp = false;
+  while (true) {
+    auto query = query::GetQuery(nullptr);
+    if (!query) {
+      break;
+    }
+    // The annotation lines are a part of the query text, the rest of the lines are sent as they are.
+    std::optional<std::chrono::microseconds> time;
+    std::optional<uint64_t> latency;
+    std::string text;
+    std::string_view rest(query->query);
+    while (!rest.empty()) {
+      const auto end = std::min(rest.find('\n'), rest.size());
+      const auto line = rest.substr(0, end);
+      rest.remove_prefix(std::min(end + 1, rest.size()));
+      const auto trimmed = TrimView(line);
+      if (!trimmed.starts_with(kTimestampAnnotation)) {
+        text.append(line).push_back('\n');
+        continue;
+      }
+      auto annotation = trimmed.substr(kTimestampAnnotation.size());
+      const auto latency_pos = annotation.find(kLatencyKey);
+      if (latency_pos != std::string_view::npos) {
+        latency = ParseLatency(annotation.substr(latency_pos + kLatencyKey.size()));
+        annotation = annotation.substr(0, latency_pos);
+      }
+      time = ParseTimestamp(TrimView(annotation));
+      if (!time || (latency_pos != std::string_view::npos && !latency)) {
+        console::EchoFailure("Invalid replay annotation of the query at line " + std::to_string(query->line_number),
+                             std::string(trimmed) + "\nExpected \"// @ts <timestamp> [latency_ms=<ms>]\"");
+        return std::nullopt;
+      }
+      any_timestamp = true;
+    }
+    if (TrimView(text).empty()) {
+      continue;
+    }
+    times.push_back(time);
+    entries.push_back(Entry{.time = {}, .query = std::string(TrimView(text)), .recorded_latency_us = latency});
+  }
+  if (!entries.empty() && !any_timestamp) {
+    console::EchoFailure("Invalid replay log", "none of the queries has a \"// @ts <timestamp>\" annotation");
+    return std::nullopt;
+  }
+  Normalize(times, &entries);
+  return entries;
+}
+
+/// RFC 4180 records, the fields can be quoted and then contain commas, newlines and "" for a quote.
+std::optional<std::vector<std::vector<std::string>>> ParseCsv(std::string_view input) {
+  std::vector<std::vector<std::string>> records;
+  std::vector<std::string> record;
+  std::string field;
+  bool quoted = false;
+  auto end_record = [&]() {
+    record.push_back(std::move(field));
+    field.clear();
+    // Skips the empty lines.
+    if (record.size() > 1 || !record.front().empty()) {
+      records.push_back(std::move(record));
+    }
+    record.clear();
+  };
+  for (size_t i = 0; i < input.size(); ++i) {
+    const char c = input[i];
+    if (quoted) {
+      if (c != '"') {
+        field.push_back(c);
+      } else if (i + 1 < input.size() && input[i + 1] == '"') {
+        field.push_back('"');
+        ++i;
+      } else {
+        quoted = false;
+      }
+      continue;
+    }
+    switch (c) {
+      case '"':
+        quoted = true;
+        break;
+      case ',':
+        record.push_back(std::move(field));
+        field.clear();
+        break;
+      case '\r':
+        break;
+      case '\n':
+        end_record();
+        break;
+      default:
+        field.push_back(c);
+    }
+  }
+  if (quoted) {
+    return std::nullopt;
+  }
+  if (!field.empty() || !record.empty()) {
+    end_record();
+  }
+  return records;
+}
+
+std::optional<std::vector<Entry>> LoadCsv() {
+  const std::string input{std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>()};
+  auto records = ParseCsv(input);
+  if (!records) {
+    console::EchoFailure("Invalid replay log", "unterminated quoted CSV field");
+    return std::nullopt;
+  }
+  std::vector<Entry> entries;
+  std::vector<std::optional<std::chrono::microseconds>> times;
+  for (size_t i = 0; i < records->size(); ++i) {
+    const auto &record = (*records)[i];
+    auto time = ParseTimestamp(TrimView(record[0]));
+    if (i == 0 && !time) {
+      // The header.
+      continue;
+    }
+    std::optional<uint64_t> latency;
+    if (record.size() == 3) {
+      latency = ParseLatency(record[2]);
+    }
+    if (!time || record.size() < 2 || record.size() > 3 || (record.size() == 3 && !latency)) {
+      console::EchoFailure("Invalid replay log record " + std::to_string(i + 1),
+                           "expected \"<timestamp>,<query>[,<latency_ms>]\"");
+      return std::nullopt;
+    }
+    auto query = TrimView(record[1]);
+    if (query.ends_with(';')) {
+      query.remove_suffix(1);
+    }
+    times.push_back(time);
+    entries.push_back(Entry{.time = {}, .query = std::string(query), .recorded_latency_us = latency});
+  }
+  Normalize(times, &entries);
+  return entries;
+}
+
+struct SessionStats {
+  utils::Histogram latency;
+  utils::Histogram lag;
+  uint64_t errors{0};
+  std::chrono::steady_clock::time_point last_sent{};
+  bool connected{true};
+};
+
+std::atomic<bool> failure_reported{false};
+
+void RunSession(const utils::bolt::Config &bolt_config, const Config &config, const std::vector<Entry> &entries,
+                std::atomic<size_t> *next, std::chrono::steady_clock::time_point start, SessionStats *stats) {
+  auto session = MakeBoltSession(bolt_config);
+  if (!session) {
+    stats->connected = false;
+    return;
+  }
+  // Whichever session is free takes the next query, if all are busy at its time, it's sent late.
+  for (auto i = (*next)++; i < entries.size() && !utils::IsStopRequested(); i = (*next)++) {
+    const auto &entry = entries[i];
+    if (config.speed > 0) {
+      const auto scheduled = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                         std::chrono::duration<double, std::micro>(entry.time.count() / config.speed));
+      std::this_thread::sleep_until(scheduled);
+      stats->lag.Record(
+          std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - scheduled).count());
+    }
+    const auto sent = std::chrono::steady_clock::now();
+    stats->last_sent = sent;
+    try {
+      query::ExecuteQuery(session.get(), entry.query);
+      stats->latency.Record(
+          std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - sent).count());
+    } catch (const utils::ClientQueryException &e) {
+      ++stats->errors;
+      if (!failure_reported.exchange(true)) {
+        console::EchoFailure("Failed query (only the first failure is reported)", entry.query + "\n" + e.what());
+      }
+    } catch (const utils::ClientFatalException &e) {
+      ++stats->errors;
+      session = MakeBoltSession(bolt_config);
+      if (!session) {
+        stats->connected = false;
+        return;
+      }
+    }
+  }
+}
+
+void PrintRow(const std::string &name, const utils::Histogram &latency) {
+  auto ms = [](uint64_t us) { return static_cast<double>(us) / 1000.0; };
+  std::cout << std::left << std::setw(12) << name << std::right << std::setw(10) << latency.Count() << std::setw(10)
+            << latency.Mean() / 1000.0 << std::setw(10) << ms(latency.ValueAtPercentile(50)) << std::setw(10)
+            << ms(latency.ValueAtPercentile(90)) << std::setw(10) << ms(latency.ValueAtPercentile(99)) << std::setw(10)
+            << ms(latency.ValueAtPercentile(99.9)) << std::setw(10) << ms(latency.Max()) << '\n';
+}
+
+void PrintRatioRow(const utils::Histogram &replayed, const utils::Histogram &recorded) {
+  auto ratio = [](double a, double b) { return b > 0 ? a / b : 0.0; };
+  std::cout << std::left << std::setw(12) << "ratio" << std::right << std::setw(10) << "" << std::setw(10)
+            << ratio(replayed.Mean(), recorded.Mean());
+  for (double percentile : {50.0, 90.0, 99.0, 99.9}) {
+    std::cout << std::setw(10)
+              << ratio(static_cast<double>(replayed.ValueAtPercentile(percentile)),
+                       static_cast<double>(recorded.ValueAtPercentile(percentile)));
+  }
+  std::cout << std::setw(10) << ratio(static_cast<double>(replayed.Max()), static_cast<double>(recorded.Max()))
+            << '\n';
+}
+
+}  // namespace
+
+int Run(const utils::bolt::Config &bolt_config, const Config &config) {
+  auto entries = config.format == constants::kCsvFormat ? LoadCsv() : LoadCypherl();
+  if (!entries) {
+    return 1;
+  }
+  if (entries->empty()) {
+    console::EchoFailure("Invalid replay log", "no queries on the standard input");
+    return 1;
+  }
+  // Ctrl-C ends the replay early, the results so far are still reported.
+  utils::EnableGracefulStop();
+
+  std::vector<SessionStats> stats(config.sessions);
+  std::atomic<size_t> next{0};
+  const auto start = std::chrono::steady_clock::now();
+  {
+    std::vector<std::thread> sessions;
+    for (int i = 0; i < config.sessions; ++i) {
+      sessions.emplace_back(RunSession, std::cref(bolt_config), std::cref(config), std::cref(*entries), &next, start,
+                            &stats[i]);
+    }
+    for (auto &session : sessions) {
+      session.join();
+    }
+  }
+
+  utils::Histogram latency;
+  utils::Histogram lag;
+  utils::Histogram recorded_latency;
+  uint64_t errors = 0;
+  auto last_sent = start;
+  bool connected = true;
+  for (const auto &session_stats : stats) {
+    latency.Merge(session_stats.latency);
+    lag.Merge(session_stats.lag);
+    errors += session_stats.errors;
+    last_sent = std::max(last_sent, session_stats.last_sent);
+    connected = connected && session_stats.connected;
+  }
+  for (const auto &entry : *entries) {
+    if (entry.recorded_latency_us) {
+      recorded_latency.Record(*entry.recorded_latency_us);
+    }
+  }
+
+  // Both spans are from the first query sent to the last one sent.
+  const double recorded_seconds = std::chrono::duration<double>(entries->back().time).count();
+  const double replayed_seconds = std::chrono::duration<double>(last_sent - start).count();
+  const auto queries = static_cast<double>(entries->size());
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "Replay: " << entries->size() << " queries, " << config.sessions << " sessions, ";
+  if (config.speed > 0) {
+    std::cout << "speed " << config.speed << "x\n";
+  } else {
+    std::cout << "as fast as possible\n";
+  }
+  std::cout << "Replay: recorded " << recorded_seconds << " s";
+  if (recorded_seconds > 0) {
+    std::cout << " (" << queries / recorded_seconds << " queries/s)";
+  }
+  std::cout << ", replayed " << replayed_seconds << " s";
+  if (replayed_seconds > 0) {
+    std::cout << " (" << queries / replayed_seconds << " queries/s)";
+  }
+  if (config.speed > 0 && recorded_seconds > 0 && replayed_seconds > 0) {
+    std::cout << ", " << 100.0 * (recorded_seconds / config.speed) / replayed_seconds << "% of the target pace";
+  }
+  std::cout << ", " << errors << " errors\n";
+  if (config.speed > 0) {
+    auto ms = [](uint64_t us) { return static_cast<double>(us) / 1000.0; };
+    std::cout << "Replay: sent late by p50 " << ms(lag.ValueAtPercentile(50)) << " ms, p99 "
+              << ms(lag.ValueAtPercentile(99)) << " ms, max " << ms(lag.Max()) << " ms\n";
+  }
+  std::cout << std::left << std::setw(12) << "latency" << std::right << std::setw(10) << "queries" << std::setw(10)
+            << "mean ms" << std::setw(10) << "p50" << std::setw(10) << "p90" << std::setw(10) << "p99"
+            << std::setw(10) << "p99.9" << std::setw(10) << "max" << '\n';
+  if (recorded_latency.Count() > 0) {
+    PrintRow("recorded", recorded_latency);
+  }
+  PrintRow("replayed", latency);
+  if (recorded_latency.Count() > 0) {
+    PrintRatioRow(latency, recorded_latency);
+  }
+  std::cout.flush();
+  if (!connected) {
+    console::EchoFailure("Replay", "some sessions couldn't connect");
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace mode::replay
@@ -0,0 +1,44 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "utils/bolt.hpp"
+
+namespace mode::replay {
+
+/// The log is read from the standard input, either as
+///   cypherl: the queries with a "// @ts <timestamp> [latency_ms=<ms>]" comment line before each query, a query
+///            without the annotation is sent right after the previous one
+///   csv:     "<timestamp>,<query>[,<latency_ms>]" records (RFC 4180 quoting), an optional header is skipped
+/// where the timestamp is a number of seconds (e.g. Unix time) or an ISO 8601 UTC date and time,
+/// "2024-01-31T12:00:00.250Z". The latency_ms is the latency of the query in the recorded run.
+struct Config {
+  /// constants::kCypherlFormat or constants::kCsvFormat.
+  std::string format;
+  int sessions;
+  /// 1 replays at the recorded pace, 2 twice as fast, ..., 0 as fast as possible.
+  double speed;
+};
+
+/// Sends the queries from the log over a pool of sessions at the time they were recorded (scaled by the speed) and
+/// reports how the replayed run diverges from the recorded one: the throughput, how late the queries were sent
+/// because all the sessions were busy, and the replayed latencies against the recorded ones.
+int Run(const utils::bolt::Config &bolt_config, const Config &config);
+
+}  // namespace mode::replay
@@ -15,18 +15,38 @@
 
 #include "serial_import.hpp"
 
+#include <chrono>
+#include <optional>
+
+#include "utils/checkpoint.hpp"
+#include "utils/perf_counters.hpp"
+#include "utils/progress.hpp"
+
 namespace mode::serial_import {
 
 using namespace std::string_literals;
 
 int Run(const utils::bolt::Config &bolt_config, const format::CsvOptions &csv_opts,
-        const format::OutputOptions &output_opts) {
+        const format::OutputOptions &output_opts, const std::string &checkpoint_file, bool resume,
+        const utils::ProgressConfig &progress_config) {
   auto session = MakeBoltSession(bolt_config);
   if (session.get() == nullptr) {
     return 1;
   }
+  std::optional<utils::Checkpoint> checkpoint;
+  if (!checkpoint_file.empty()) {
+    checkpoint.emplace(checkpoint_file, resume);
+    if (!checkpoint->IsOpen()) {
+      console::EchoFailure("Unable to open the checkpoint file", checkpoint_file);
+      return 1;
+    }
+    checkpoint->SeekInput();
+  }
+  utils::Progress progress;
+  progress.Start(progress_config);
 
   while (true) {
+    const auto parse_start = std::chrono::steady_clock::now();
     auto query = query::GetQuery(nullptr);
     if (!query) {
       break;
@@ -34,11 +54,34 @@ int Run(const utils::bolt::Config &bolt_config, const format::CsvOptions &csv_op
     if (query->query.empty()) {
       continue;
     }
+    progress.Read(*query, std::chrono::steady_clock::now() - parse_start);
+    if (checkpoint && checkpoint->IsCommitted(*query)) {
+      continue;
+    }
 
     try {
-      auto ret = query::ExecuteQuery(session.get(), query->query);
-      if (ret.records.size() > 0) {
+      progress.in_flight++;
+      const auto start = std::chrono::steady_clock::now();
+      // The streamed records are formatted while waiting for the rest of them, ret.format_time isn't waiting.
+      auto sink = format::MakeRecordSink(output_opts, csv_opts);
+      auto ret = query::ExecuteQuery(session.get(), query->query, sink.get());
+      progress.AddWait(std::chrono::steady_clock::now() - start - ret.format_time);
+      progress.in_flight--;
+      progress.Commit(ret.stats);
+      if (checkpoint) {
+        checkpoint->Commit(0, *query);
+      }
+      if (sink) {
+        const auto format_start = std::chrono::steady_clock::now();
+        {
+          utils::perf::Scope scope(utils::perf::Phase::FORMAT);
+          sink->Finish();
+        }
+        progress.AddFormat(ret.format_time + (std::chrono::steady_clock::now() - format_start));
+      } else if (ret.records.size() > 0) {
+        const auto format_start = std::chrono::steady_clock::now();
         Output(ret.header, ret.records, output_opts, csv_opts);
+        progress.AddFormat(std::chrono::steady_clock::now() - format_start);
       }
     } catch (const utils::ClientQueryException &e) {
       console::EchoFailure("Failed query", query->query);
@@ -50,6 +93,7 @@ int Run(const utils::bolt::Config &bolt_config, const format::CsvOptions &csv_op
     }
   }
 
+  progress.Finish();
   return 0;
 }
 
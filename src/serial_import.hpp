@@ -16,11 +16,14 @@
 #pragma once
 
 #include "utils/bolt.hpp"
+#include "utils/progress.hpp"
 #include "utils/utils.hpp"
 
 namespace mode::serial_import {
 
+/// With a non-empty checkpoint_file, each executed query is journaled and resume skips the ones journaled before.
 int Run(const utils::bolt::Config &bolt_config, const format::CsvOptions &csv_opts,
-        const format::OutputOptions &output_opts);
+        const format::OutputOptions &output_opts, const std::string &checkpoint_file, bool resume,
+        const utils::ProgressConfig &progress_config);
 
 }  // namespace mode::serial_import
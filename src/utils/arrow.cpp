@@ -0,0 +1,744 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "arrow.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include "json.hpp"
+#include "output.hpp"
+
+namespace format {
+
+static_assert(std::endian::native == std::endian::little, "The Arrow stream is written in the native byte order.");
+
+namespace {
+
+/// A flatbuffer built back to front, the same way the flatbuffers library builds them, so that each object is written
+/// after the objects it refers to and the offsets point forward. The objects are referred to by their distance from the
+/// end of the buffer.
+class FlatBuilder {
+ public:
+  using Ref = uint32_t;
+
+  FlatBuilder() : buffer_(256) {}
+
+  template <class T>
+  void Push(T value) {
+    Align(sizeof(T));
+    std::memcpy(Grow(sizeof(T)), &value, sizeof(T));
+  }
+
+  void PushOffset(Ref ref) {
+    Align(sizeof(uint32_t));
+    Push<uint32_t>(size_ + sizeof(uint32_t) - ref);
+  }
+
+  Ref String(std::string_view str) {
+    PreAlign(str.size() + 1, sizeof(uint32_t));
+    *Grow(1) = 0;
+    std::memcpy(Grow(str.size()), str.data(), str.size());
+    Push<uint32_t>(str.size());
+    return size_;
+  }
+
+  Ref Offsets(const std::vector<Ref> &refs) {
+    PreAlign(refs.size() * sizeof(uint32_t), sizeof(uint32_t));
+    for (auto it = refs.rbegin(); it != refs.rend(); ++it) {
+      PushOffset(*it);
+    }
+    Push<uint32_t>(refs.size());
+    return size_;
+  }
+
+  /// A vector of structs of two longs (FieldNode and Buffer).
+  Ref Pairs(const std::vector<std::pair<int64_t, int64_t>> &pairs) {
+    PreAlign(pairs.size() * 2 * sizeof(int64_t), sizeof(int64_t));
+    for (auto it = pairs.rbegin(); it != pairs.rend(); ++it) {
+      Push<int64_t>(it->second);
+      Push<int64_t>(it->first);
+    }
+    Push<uint32_t>(pairs.size());
+    return size_;
+  }
+
+  /// The fields are added between StartTable and EndTable, the objects they refer to have to be created before.
+  void StartTable() {
+    fields_.clear();
+    table_start_ = size_;
+  }
+
+  template <class T>
+  void Field(uint16_t id, T value) {
+    Push<T>(value);
+    fields_.emplace_back(id, size_);
+  }
+
+  void FieldOffset(uint16_t id, Ref ref) {
+    PushOffset(ref);
+    fields_.emplace_back(id, size_);
+  }
+
+  Ref EndTable() {
+    // The offset of the vtable, set once it's written.
+    Push<int32_t>(0);
+    const auto table = size_;
+    uint16_t num_fields = 0;
+    for (const auto &[id, _] : fields_) {
+      num_fields = std::max<uint16_t>(num_fields, id + 1);
+    }
+    std::vector<uint16_t> vtable(num_fields, 0);
+    for (const auto &[id, field] : fields_) {
+      vtable[id] = table - field;
+    }
+    for (auto it = vtable.rbegin(); it != vtable.rend(); ++it) {
+      Push<uint16_t>(*it);
+    }
+    Push<uint16_t>(table - table_start_);
+    Push<uint16_t>(sizeof(uint16_t) * (2 + num_fields));
+    // The vtable is right before the table.
+    const int32_t vtable_offset = size_ - table;
+    std::memcpy(Data() + size_ - table, &vtable_offset, sizeof(vtable_offset));
+    return table;
+  }
+
+  std::string Finish(Ref root) {
+    PreAlign(sizeof(uint32_t), max_align_);
+    PushOffset(root);
+    return std::string(reinterpret_cast<const char *>(Data()), size_);
+  }
+
+ private:
+  uint8_t *Data() { return buffer_.data() + buffer_.size() - size_; }
+
+  /// Makes room for n bytes in front of the data.
+  uint8_t *Grow(size_t n) {
+    if (size_ + n > buffer_.size()) {
+      std::vector<uint8_t> grown(std::max(buffer_.size() * 2, size_ + n));
+      std::memcpy(grown.data() + grown.size() - size_, Data(), size_);
+      buffer_ = std::move(grown);
+    }
+    size_ += n;
+    return Data();
+  }
+
+  /// The final size is a multiple of max_align_, so the alignment from the end is the alignment from the start.
+  void Align(size_t alignment) { PreAlign(0, alignment); }
+
+  /// Aligns the end of the next n bytes.
+  void PreAlign(size_t n, size_t alignment) {
+    max_align_ = std::max(max_align_, alignment);
+    const auto padding = (alignment - (size_ + n) % alignment) % alignment;
+    std::memset(Grow(padding), 0, padding);
+  }
+
+  std::vector<uint8_t> buffer_;
+  size_t size_{0};
+  size_t max_align_{1};
+  uint32_t table_start_{0};
+  std::vector<std::pair<uint16_t, Ref>> fields_;
+};
+
+// The values of the Arrow flatbuffers schema (Schema.fbs and Message.fbs).
+constexpr int16_t kMetadataV5 = 4;
+constexpr uint8_t kHeaderSchema = 1;
+constexpr uint8_t kHeaderRecordBatch = 3;
+constexpr uint8_t kTypeInt = 2;
+constexpr uint8_t kTypeFloatingPoint = 3;
+constexpr uint8_t kTypeUtf8 = 5;
+constexpr uint8_t kTypeBool = 6;
+constexpr uint8_t kTypeDate = 8;
+constexpr uint8_t kTypeTime = 9;
+constexpr uint8_t kTypeTimestamp = 10;
+constexpr uint8_t kTypeInterval = 11;
+constexpr uint8_t kTypeList = 12;
+constexpr uint8_t kTypeStruct = 13;
+constexpr int16_t kPrecisionDouble = 2;
+constexpr int16_t kDateUnitDay = 0;
+constexpr int16_t kTimeUnitNanosecond = 3;
+constexpr int16_t kIntervalMonthDayNano = 2;
+
+constexpr int64_t kNanosecondsPerSecond = 1'000'000'000;
+/// The utf8 and list columns have 32-bit offsets, a batch is written early before they overflow.
+constexpr size_t kMaxOffset = std::numeric_limits<int32_t>::max() / 2;
+
+enum class Type { UTF8, BOOL, INT64, DOUBLE, DATE, TIME, TIMESTAMP, INTERVAL, LIST, STRUCT };
+
+std::string_view TypeName(Type type) {
+  switch (type) {
+    case Type::UTF8:
+      return "utf8";
+    case Type::BOOL:
+      return "bool";
+    case Type::INT64:
+      return "int64";
+    case Type::DOUBLE:
+      return "double";
+    case Type::DATE:
+      return "date32";
+    case Type::TIME:
+      return "time64[ns]";
+    case Type::TIMESTAMP:
+      return "timestamp[ns]";
+    case Type::INTERVAL:
+      return "interval[month_day_nano]";
+    case Type::LIST:
+      return "list";
+    case Type::STRUCT:
+      return "struct";
+  }
+  return "utf8";
+}
+
+struct Field {
+  std::string name;
+  Type type{Type::UTF8};
+  std::vector<Field> children;
+};
+
+Field InferField(std::string name, const std::vector<const mg_value *> &values) {
+  Field field{std::move(name), Type::UTF8, {}};
+  const auto first = std::find_if(values.begin(), values.end(), [](const mg_value *value) {
+    return value && mg_value_get_type(value) != MG_VALUE_TYPE_NULL;
+  });
+  if (first == values.end()) {
+    return field;
+  }
+  switch (mg_value_get_type(*first)) {
+    case MG_VALUE_TYPE_BOOL:
+      field.type = Type::BOOL;
+      break;
+    case MG_VALUE_TYPE_INTEGER:
+      field.type = Type::INT64;
+      break;
+    case MG_VALUE_TYPE_FLOAT:
+      field.type = Type::DOUBLE;
+      break;
+    case MG_VALUE_TYPE_DATE:
+      field.type = Type::DATE;
+      break;
+    case MG_VALUE_TYPE_LOCAL_TIME:
+      field.type = Type::TIME;
+      break;
+    case MG_VALUE_TYPE_LOCAL_DATE_TIME:
+      field.type = Type::TIMESTAMP;
+      break;
+    case MG_VALUE_TYPE_DURATION:
+      field.type = Type::INTERVAL;
+      break;
+    case MG_VALUE_TYPE_LIST: {
+      std::vector<const mg_value *> items;
+      for (const auto *value : values) {
+        if (!value || mg_value_get_type(value) != MG_VALUE_TYPE_LIST) continue;
+        const auto *list = mg_value_list(value);
+        for (uint32_t i = 0; i < mg_list_size(list); ++i) {
+          items.push_back(mg_list_at(list, i));
+        }
+      }
+      field.type = Type::LIST;
+      field.children.push_back(InferField("item", items));
+      break;
+    }
+    case MG_VALUE_TYPE_MAP: {
+      // The keys in the order they first appear.
+      std::vector<std::string> keys;
+      std::vector<std::vector<const mg_value *>> key_values;
+      std::unordered_map<std::string, size_t> key_index;
+      for (const auto *value : values) {
+        if (!value || mg_value_get_type(value) != MG_VALUE_TYPE_MAP) continue;
+        const auto *map = mg_value_map(value);
+        for (uint32_t i = 0; i < mg_map_size(map); ++i) {
+          const auto *key = mg_map_key_at(map, i);
+          const auto [it, inserted] =
+              key_index.emplace(std::string(mg_string_data(key), mg_string_size(key)), keys.size());
+          if (inserted) {
+            keys.push_back(it->first);
+            key_values.emplace_back();
+          }
+          key_values[it->second].push_back(mg_map_value_at(map, i));
+        }
+      }
+      // A struct without fields would lose the values, the empty maps stay JSON.
+      if (keys.empty()) break;
+      field.type = Type::STRUCT;
+      for (size_t i = 0; i < keys.size(); ++i) {
+        field.children.push_back(InferField(std::move(keys[i]), key_values[i]));
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  return field;
+}
+
+void AppendBit(std::string &bitmap, int64_t index, bool bit) {
+  if (index % 8 == 0) bitmap.push_back(0);
+  if (bit) bitmap.back() = static_cast<char>(bitmap.back() | (1 << (index % 8)));
+}
+
+template <class T>
+void AppendFixed(std::string &values, T value) {
+  values.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <class T>
+std::string_view Bytes(const std::vector<T> &values) {
+  return std::string_view(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+}
+
+/// The field nodes and the buffers of a record batch, in the order of the schema.
+struct Body {
+  void AddBuffer(std::string_view data) {
+    buffers.emplace_back(length, data.size());
+    data_buffers.push_back(data);
+    length += (data.size() + 7) / 8 * 8;
+  }
+
+  std::vector<std::pair<int64_t, int64_t>> nodes;
+  /// Offset and length of each buffer, each one padded to 8 bytes.
+  std::vector<std::pair<int64_t, int64_t>> buffers;
+  std::vector<std::string_view> data_buffers;
+  int64_t length{0};
+};
+
+class Column {
+ public:
+  explicit Column(const Field &field) : field_(field) {
+    if (field_.type == Type::UTF8 || field_.type == Type::LIST) {
+      offsets_.push_back(0);
+    }
+    children_.reserve(field_.children.size());
+    for (const auto &child : field_.children) {
+      children_.emplace_back(child);
+    }
+  }
+
+  void Append(const mg_value *value) {
+    if (!value || mg_value_get_type(value) == MG_VALUE_TYPE_NULL) {
+      AppendNull();
+      return;
+    }
+    if (!AppendValue(value)) {
+      mismatched_ = true;
+      AppendNull();
+      return;
+    }
+    AppendBit(validity_, length_, true);
+    ++length_;
+  }
+
+  /// The 32-bit offsets are close to overflowing.
+  bool Full() const {
+    if (values_.size() > kMaxOffset ||
+        (field_.type == Type::LIST && static_cast<size_t>(children_[0].length_) > kMaxOffset)) {
+      return true;
+    }
+    return std::any_of(children_.begin(), children_.end(), [](const auto &child) { return child.Full(); });
+  }
+
+  /// A value of the column or of its children didn't fit the type and was written as null.
+  bool Mismatched() const {
+    return mismatched_ ||
+           std::any_of(children_.begin(), children_.end(), [](const auto &child) { return child.Mismatched(); });
+  }
+
+  void Write(Body &body) const {
+    body.nodes.emplace_back(length_, null_count_);
+    // All valid values don't need the validity bitmap.
+    body.AddBuffer(null_count_ > 0 ? std::string_view(validity_) : std::string_view());
+    switch (field_.type) {
+      case Type::UTF8:
+        body.AddBuffer(Bytes(offsets_));
+        body.AddBuffer(values_);
+        break;
+      case Type::LIST:
+        body.AddBuffer(Bytes(offsets_));
+        break;
+      case Type::STRUCT:
+        break;
+      default:
+        body.AddBuffer(values_);
+    }
+    for (const auto &child : children_) {
+      child.Write(body);
+    }
+  }
+
+ private:
+  /// Returns false if the value doesn't fit the type of the column.
+  bool AppendValue(const mg_value *value) {
+    const auto type = mg_value_get_type(value);
+    switch (field_.type) {
+      case Type::UTF8:
+        if (type == MG_VALUE_TYPE_STRING) {
+          const auto *str = mg_value_string(value);
+          values_.append(mg_string_data(str), mg_string_size(str));
+        } else {
+          utils::json::AppendValue(values_, value);
+        }
+        offsets_.push_back(static_cast<int32_t>(values_.size()));
+        return true;
+      case Type::BOOL:
+        if (type != MG_VALUE_TYPE_BOOL) return false;
+        AppendBit(values_, length_, mg_value_bool(value));
+        return true;
+      case Type::INT64:
+        if (type != MG_VALUE_TYPE_INTEGER) return false;
+        AppendFixed<int64_t>(values_, mg_value_integer(value));
+        return true;
+      case Type::DOUBLE:
+        if (type == MG_VALUE_TYPE_FLOAT) {
+          AppendFixed<double>(values_, mg_value_float(value));
+        } else if (type == MG_VALUE_TYPE_INTEGER) {
+          AppendFixed<double>(values_, static_cast<double>(mg_value_integer(value)));
+        } else {
+          return false;
+        }
+        return true;
+      case Type::DATE:
+        if (type != MG_VALUE_TYPE_DATE) return false;
+        AppendFixed<int32_t>(values_, static_cast<int32_t>(mg_date_days(mg_value_date(value))));
+        return true;
+      case Type::TIME:
+        if (type != MG_VALUE_TYPE_LOCAL_TIME) return false;
+        AppendFixed<int64_t>(values_, mg_local_time_nanoseconds(mg_value_local_time(value)));
+        return true;
+      case Type::TIMESTAMP: {
+        if (type != MG_VALUE_TYPE_LOCAL_DATE_TIME) return false;
+        const auto *date_time = mg_value_local_date_time(value);
+        AppendFixed<int64_t>(values_, mg_local_date_time_seconds(date_time) * kNanosecondsPerSecond +
+                                          mg_local_date_time_nanoseconds(date_time));
+        return true;
+      }
+      case Type::INTERVAL: {
+        if (type != MG_VALUE_TYPE_DURATION) return false;
+        const auto *duration = mg_value_duration(value);
+        AppendFixed<int32_t>(values_, static_cast<int32_t>(mg_duration_months(duration)));
+        AppendFixed<int32_t>(values_, static_cast<int32_t>(mg_duration_days(duration)));
+        AppendFixed<int64_t>(values_, mg_duration_seconds(duration) * kNanosecondsPerSecond +
+                                          mg_duration_nanoseconds(duration));
+        return true;
+      }
+      case Type::LIST: {
+        if (type != MG_VALUE_TYPE_LIST) return false;
+        const auto *list = mg_value_list(value);
+        for (uint32_t i = 0; i < mg_list_size(list); ++i) {
+          children_[0].Append(mg_list_at(list, i));
+        }
+        offsets_.push_back(static_cast<int32_t>(children_[0].length_));
+        return true;
+      }
+      case Type::STRUCT: {
+        if (type != MG_VALUE_TYPE_MAP) return false;
+        const auto *map = mg_value_map(value);
+        for (size_t i = 0; i < children_.size(); ++i) {
+          children_[i].Append(mg_map_at(map, field_.children[i].name.c_str()));
+        }
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void AppendNull() {
+    AppendBit(validity_, length_, false);
+    ++null_count_;
+    switch (field_.type) {
+      case Type::UTF8:
+      case Type::LIST:
+        offsets_.push_back(offsets_.back());
+        break;
+      case Type::BOOL:
+        AppendBit(values_, length_, false);
+        break;
+      case Type::DATE:
+        values_.append(sizeof(int32_t), '\0');
+        break;
+      case Type::INTERVAL:
+        values_.append(2 * sizeof(int32_t) + sizeof(int64_t), '\0');
+        break;
+      case Type::STRUCT:
+        // The children have a slot for each struct.
+        for (auto &child : children_) {
+          child.Append(nullptr);
+        }
+        break;
+      default:
+        values_.append(sizeof(int64_t), '\0');
+    }
+    ++length_;
+  }
+
+  const Field &field_;
+  int64_t length_{0};
+  int64_t null_count_{0};
+  bool mismatched_{false};
+  std::string validity_;
+  /// The fixed width values, the bits of bool or the bytes of utf8.
+  std::string values_;
+  std::vector<int32_t> offsets_;
+  std::vector<Column> children_;
+};
+
+/// The Type union of Schema.fbs.
+std::pair<uint8_t, FlatBuilder::Ref> AddType(FlatBuilder &builder, Type type) {
+  builder.StartTable();
+  switch (type) {
+    case Type::UTF8:
+      return {kTypeUtf8, builder.EndTable()};
+    case Type::BOOL:
+      return {kTypeBool, builder.EndTable()};
+    case Type::INT64:
+      builder.Field<int32_t>(0, 64);
+      builder.Field<uint8_t>(1, 1);
+      return {kTypeInt, builder.EndTable()};
+    case Type::DOUBLE:
+      builder.Field<int16_t>(0, kPrecisionDouble);
+      return {kTypeFloatingPoint, builder.EndTable()};
+    case Type::DATE:
+      builder.Field<int16_t>(0, kDateUnitDay);
+      return {kTypeDate, builder.EndTable()};
+    case Type::TIME:
+      builder.Field<int32_t>(1, 64);
+      builder.Field<int16_t>(0, kTimeUnitNanosecond);
+      return {kTypeTime, builder.EndTable()};
+    case Type::TIMESTAMP:
+      // Without a timezone, the values are local.
+      builder.Field<int16_t>(0, kTimeUnitNanosecond);
+      return {kTypeTimestamp, builder.EndTable()};
+    case Type::INTERVAL:
+      builder.Field<int16_t>(0, kIntervalMonthDayNano);
+      return {kTypeInterval, builder.EndTable()};
+    case Type::LIST:
+      return {kTypeList, builder.EndTable()};
+    case Type::STRUCT:
+      return {kTypeStruct, builder.EndTable()};
+  }
+  return {kTypeUtf8, builder.EndTable()};
+}
+
+FlatBuilder::Ref AddField(FlatBuilder &builder, const Field &field) {
+  std::vector<FlatBuilder::Ref> children;
+  children.reserve(field.children.size());
+  for (const auto &child : field.children) {
+    children.push_back(AddField(builder, child));
+  }
+  const auto children_ref = builder.Offsets(children);
+  const auto name = builder.String(field.name);
+  const auto [type_type, type] = AddType(builder, field.type);
+  builder.StartTable();
+  builder.FieldOffset(0, name);
+  builder.FieldOffset(3, type);
+  builder.FieldOffset(5, children_ref);
+  // Nullable.
+  builder.Field<uint8_t>(1, 1);
+  builder.Field<uint8_t>(2, type_type);
+  return builder.EndTable();
+}
+
+std::string Message(FlatBuilder &builder, uint8_t header_type, FlatBuilder::Ref header, int64_t body_length) {
+  builder.StartTable();
+  builder.Field<int64_t>(3, body_length);
+  builder.FieldOffset(2, header);
+  builder.Field<int16_t>(0, kMetadataV5);
+  builder.Field<uint8_t>(1, header_type);
+  return builder.Finish(builder.EndTable());
+}
+
+/// The continuation marker, the size of the metadata and the metadata padded to 8 bytes.
+void AppendMessage(std::string &buffer, std::string_view metadata) {
+  const auto padded = (metadata.size() + 7) / 8 * 8;
+  AppendFixed<uint32_t>(buffer, 0xFFFFFFFF);
+  AppendFixed<int32_t>(buffer, static_cast<int32_t>(padded));
+  buffer.append(metadata);
+  buffer.append(padded - metadata.size(), '\0');
+}
+
+}  // namespace
+
+struct ArrowWriter::Batch {
+  explicit Batch(std::vector<Field> schema) : fields(std::move(schema)), warned(fields.size(), false) { Clear(); }
+
+  void Clear() {
+    columns.clear();
+    columns.reserve(fields.size());
+    for (const auto &field : fields) {
+      columns.emplace_back(field);
+    }
+    rows = 0;
+  }
+
+  void Append(const mg_list *record) {
+    for (size_t i = 0; i < columns.size(); ++i) {
+      columns[i].Append(i < mg_list_size(record) ? mg_list_at(record, static_cast<uint32_t>(i)) : nullptr);
+    }
+    ++rows;
+  }
+
+  bool Full() const {
+    return std::any_of(columns.begin(), columns.end(), [](const auto &column) { return column.Full(); });
+  }
+
+  /// Warns once per column about the values written as nulls because they didn't fit its type.
+  void WarnMismatches() {
+    for (size_t i = 0; i < columns.size(); ++i) {
+      if (warned[i] || !columns[i].Mismatched()) continue;
+      warned[i] = true;
+      std::cerr << "Warning: the Arrow type of the column '" << fields[i].name << "' is " << TypeName(fields[i].type)
+                << " (from the first batch), the values of it which don't fit are written as nulls" << std::endl;
+    }
+  }
+
+  /// Referred to by the columns.
+  const std::vector<Field> fields;
+  std::vector<bool> warned;
+  std::vector<Column> columns;
+  uint64_t rows{0};
+};
+
+ArrowWriter::ArrowWriter(std::vector<std::string> header, uint64_t batch_rows)
+    : header_(std::move(header)), batch_rows_(std::max<uint64_t>(batch_rows, 1)) {}
+
+ArrowWriter::~ArrowWriter() = default;
+
+void ArrowWriter::Append(std::string &buffer, const mg_list *record) {
+  if (!batch_) {
+    first_rows_.push_back(mg_memory::MakeCustomUnique<mg_list>(mg_list_copy(record)));
+    if (!first_rows_.back()) {
+      std::cerr << "out of memory";
+      std::abort();
+    }
+    if (first_rows_.size() == batch_rows_) {
+      WriteBatch(buffer);
+    }
+    return;
+  }
+  batch_->Append(record);
+  if (batch_->rows == batch_rows_ || batch_->Full()) {
+    WriteBatch(buffer);
+  }
+}
+
+void ArrowWriter::Finish(std::string &buffer) {
+  if (!batch_ || batch_->rows > 0) {
+    WriteBatch(buffer);
+  }
+  // The end of the stream.
+  AppendFixed<uint32_t>(buffer, 0xFFFFFFFF);
+  AppendFixed<int32_t>(buffer, 0);
+}
+
+void ArrowWriter::WriteBatch(std::string &buffer) {
+  if (!batch_) {
+    std::vector<Field> fields;
+    fields.reserve(header_.size());
+    for (size_t i = 0; i < header_.size(); ++i) {
+      std::vector<const mg_value *> values;
+      values.reserve(first_rows_.size());
+      for (const auto &row : first_rows_) {
+        values.push_back(i < mg_list_size(row.get()) ? mg_list_at(row.get(), static_cast<uint32_t>(i)) : nullptr);
+      }
+      fields.push_back(InferField(header_[i], values));
+    }
+    batch_ = std::make_unique<Batch>(std::move(fields));
+
+    FlatBuilder builder;
+    std::vector<FlatBuilder::Ref> field_refs;
+    field_refs.reserve(batch_->fields.size());
+    for (const auto &field : batch_->fields) {
+      field_refs.push_back(AddField(builder, field));
+    }
+    const auto fields_ref = builder.Offsets(field_refs);
+    builder.StartTable();
+    builder.FieldOffset(1, fields_ref);
+    // Little endian.
+    builder.Field<int16_t>(0, 0);
+    AppendMessage(buffer, Message(builder, kHeaderSchema, builder.EndTable(), 0));
+
+    // The first rows can overflow the offsets just like the later ones.
+    const auto first_rows = std::move(first_rows_);
+    first_rows_.clear();
+    for (const auto &row : first_rows) {
+      batch_->Append(row.get());
+      if (batch_->Full()) {
+        WriteRecordBatch(buffer);
+      }
+    }
+    if (batch_->rows == 0) return;
+  }
+  WriteRecordBatch(buffer);
+}
+
+void ArrowWriter::WriteRecordBatch(std::string &buffer) {
+  Body body;
+  for (const auto &column : batch_->columns) {
+    column.Write(body);
+  }
+  FlatBuilder builder;
+  const auto nodes = builder.Pairs(body.nodes);
+  const auto buffers = builder.Pairs(body.buffers);
+  builder.StartTable();
+  builder.Field<int64_t>(0, static_cast<int64_t>(batch_->rows));
+  builder.FieldOffset(1, nodes);
+  builder.FieldOffset(2, buffers);
+  AppendMessage(buffer, Message(builder, kHeaderRecordBatch, builder.EndTable(), body.length));
+  for (size_t i = 0; i < body.data_buffers.size(); ++i) {
+    const auto data = body.data_buffers[i];
+    buffer.append(data);
+    buffer.append((data.size() + 7) / 8 * 8 - data.size(), '\0');
+  }
+  batch_->WarnMismatches();
+  batch_->Clear();
+}
+
+void PrintArrow(const std::vector<std::string> &header, const std::vector<mg_memory::MgListPtr> &records,
+                uint64_t batch_rows) {
+  ArrowWriter writer(header, batch_rows);
+  for (const auto &record : records) {
+    writer.Append(utils::output::Buffer(), record.get());
+    utils::output::Commit();
+  }
+  writer.Finish(utils::output::Buffer());
+  utils::output::Commit();
+}
+
+void ArrowStream::Header(const std::vector<std::string> &header) {
+  writer_ = std::make_unique<ArrowWriter>(header, batch_rows_);
+}
+
+void ArrowStream::Record(const mg_list *record) {
+  writer_->Append(utils::output::Buffer(), record);
+  utils::output::Commit();
+}
+
+void ArrowStream::Finish() {
+  if (!writer_) {
+    // No records.
+    return;
+  }
+  writer_->Finish(utils::output::Buffer());
+  utils::output::Flush();
+}
+
+}  // namespace format
@@ -0,0 +1,87 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mgclient.h"
+#include "utils.hpp"
+
+// The Arrow IPC streaming format (https://arrow.apache.org/docs/format/Columnar.html#ipc-streaming-format), written
+// without the Arrow libraries: the messages are framed and their flatbuffers metadata is encoded here. The types of
+// the columns are taken from the first batch:
+//   integer -> int64, float -> double, string -> utf8, bool -> bool, date -> date32, local_time -> time64[ns],
+//   local_date_time -> timestamp[ns], duration -> interval[month_day_nano], list -> list<type of the elements>,
+//   map -> struct<keys of the maps>
+// The other values (graph and spatial ones) and the columns of nulls are utf8 with the JSON encoding of the values, see
+// json.hpp. In the later batches a value which doesn't fit the type of its column is null, except that integers are
+// converted in double columns and everything is JSON encoded in utf8 columns. A warning is printed to stderr the first
+// time a column gets such a null. Map keys which aren't in the struct are dropped.
+
+namespace format {
+
+/// Writes a single result as an Arrow IPC stream: the schema, a record batch per batch_rows records and the end of the
+/// stream.
+class ArrowWriter {
+ public:
+  ArrowWriter(std::vector<std::string> header, uint64_t batch_rows);
+  ArrowWriter(const ArrowWriter &) = delete;
+  ArrowWriter &operator=(const ArrowWriter &) = delete;
+  ArrowWriter(ArrowWriter &&) = delete;
+  ArrowWriter &operator=(ArrowWriter &&) = delete;
+  ~ArrowWriter();
+
+  /// Adds the record to the current batch and appends the batch to the buffer once it's full. The records of the first
+  /// batch are copied until the schema is known, the later ones go straight into the columns.
+  void Append(std::string &buffer, const mg_list *record);
+
+  /// Appends the last batch and the end of the stream.
+  void Finish(std::string &buffer);
+
+ private:
+  struct Batch;
+
+  /// Writes the schema first if it isn't known yet.
+  void WriteBatch(std::string &buffer);
+  void WriteRecordBatch(std::string &buffer);
+
+  std::vector<std::string> header_;
+  uint64_t batch_rows_;
+  std::vector<mg_memory::MgListPtr> first_rows_;
+  /// Created from the first batch.
+  std::unique_ptr<Batch> batch_;
+};
+
+void PrintArrow(const std::vector<std::string> &header, const std::vector<mg_memory::MgListPtr> &records,
+                uint64_t batch_rows);
+
+/// Prints the Arrow stream while the records are fetched.
+class ArrowStream : public query::RecordSink {
+ public:
+  explicit ArrowStream(uint64_t batch_rows) : batch_rows_(batch_rows) {}
+
+  void Header(const std::vector<std::string> &header) override;
+  void Record(const mg_list *record) override;
+  void Finish() override;
+
+ private:
+  uint64_t batch_rows_;
+  std::unique_ptr<ArrowWriter> writer_;
+};
+
+}  // namespace format
@@ -17,6 +17,8 @@
 
 #include "gflags/gflags.h"
 
+#include "bolt_record.hpp"
+
 namespace utils::bolt {
 
 using namespace std::string_literals;
@@ -40,6 +42,7 @@ mg_memory::MgSessionPtr MakeBoltSession(const Config &config) {
     mg_session *session_tmp;
     int status = mg_connect(params.get(), &session_tmp);
     session = mg_memory::MakeCustomUnique<mg_session>(session_tmp);
+    utils::bolt_record::Connect(session.get(), bolt_client_version, status);
     if (status != 0) {
       console::EchoFailure("Connection failure", mg_session_error(session.get()));
       return mg_memory::MakeCustomUnique<mg_session>(nullptr);
@@ -0,0 +1,332 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "bolt_record.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <unordered_map>
+
+namespace utils::bolt_record {
+
+namespace ps = packstream;
+
+namespace {
+
+struct Recording {
+  std::chrono::steady_clock::time_point start;
+  std::FILE *file{nullptr};
+  std::mutex lock;
+  std::unordered_map<const mg_session *, uint32_t> sessions;
+  uint32_t next_session{1};
+};
+
+Recording &GetRecording() {
+  static Recording recording;
+  return recording;
+}
+
+void CloseRecording() {
+  auto &recording = GetRecording();
+  std::lock_guard<std::mutex> guard(recording.lock);
+  enabled = false;
+  if (recording.file) {
+    std::fclose(recording.file);
+    recording.file = nullptr;
+  }
+}
+
+std::string String(const mg_string *string) { return std::string(mg_string_data(string), mg_string_size(string)); }
+
+ps::Map ConvertMap(const mg_map *map) {
+  ps::Map converted;
+  if (!map) {
+    return converted;
+  }
+  converted.reserve(mg_map_size(map));
+  for (uint32_t i = 0; i < mg_map_size(map); ++i) {
+    converted.emplace_back(String(mg_map_key_at(map, i)), ToPackStream(mg_map_value_at(map, i)));
+  }
+  return converted;
+}
+
+ps::List ConvertList(const mg_list *list) {
+  ps::List converted;
+  if (!list) {
+    return converted;
+  }
+  converted.reserve(mg_list_size(list));
+  for (uint32_t i = 0; i < mg_list_size(list); ++i) {
+    converted.push_back(ToPackStream(mg_list_at(list, i)));
+  }
+  return converted;
+}
+
+// Bolt 4 structures.
+ps::Value Node(const mg_node *node) {
+  ps::List labels;
+  for (uint32_t i = 0; i < mg_node_label_count(node); ++i) {
+    labels.push_back(ps::Value{String(mg_node_label_at(node, i))});
+  }
+  return ps::Value{ps::Structure{.signature = 'N',
+                                 .fields = {ps::Value{mg_node_id(node)}, ps::Value{std::move(labels)},
+                                            ps::Value{ConvertMap(mg_node_properties(node))}}}};
+}
+
+ps::Value UnboundRelationship(const mg_unbound_relationship *rel) {
+  return ps::Value{ps::Structure{.signature = 'r',
+                                 .fields = {ps::Value{mg_unbound_relationship_id(rel)},
+                                            ps::Value{String(mg_unbound_relationship_type(rel))},
+                                            ps::Value{ConvertMap(mg_unbound_relationship_properties(rel))}}}};
+}
+
+/// Every step gets its own node and relationship in the path, mgclient doesn't tell which ones are the same.
+ps::Value Path(const mg_path *path) {
+  ps::List nodes{Node(mg_path_node_at(path, 0))};
+  ps::List relationships;
+  ps::List sequence;
+  for (uint32_t i = 0; i < mg_path_length(path); ++i) {
+    relationships.push_back(UnboundRelationship(mg_path_relationship_at(path, i)));
+    nodes.push_back(Node(mg_path_node_at(path, i + 1)));
+    const int64_t relationship_index = i + 1;
+    sequence.push_back(ps::Value{mg_path_relationship_reversed_at(path, i) ? -relationship_index : relationship_index});
+    sequence.push_back(ps::Value{int64_t{i + 1}});
+  }
+  return ps::Value{ps::Structure{
+      .signature = 'P',
+      .fields = {ps::Value{std::move(nodes)}, ps::Value{std::move(relationships)}, ps::Value{std::move(sequence)}}}};
+}
+
+void Write(const mg_session *session, uint8_t direction, uint8_t signature, ps::List fields) {
+  auto &recording = GetRecording();
+  const uint64_t timestamp =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - recording.start)
+          .count();
+  std::string entry;
+  ps::Encoder encoder(&entry);
+  encoder.Write(ps::Value{ps::Structure{.signature = signature, .fields = std::move(fields)}});
+  std::string header;
+  auto append = [&header](uint64_t value, int bytes) {
+    for (int i = bytes - 1; i >= 0; --i) {
+      header.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+    }
+  };
+
+  std::lock_guard<std::mutex> guard(recording.lock);
+  if (!recording.file) {
+    return;
+  }
+  // A reconnect might reuse the address, HELLO always starts a new session.
+  auto it = recording.sessions.find(session);
+  if (it == recording.sessions.end() || (direction == kClient && signature == ps::message::kHello)) {
+    it = recording.sessions.insert_or_assign(session, recording.next_session++).first;
+  }
+  append(it->second, 4);
+  append(timestamp, 8);
+  append(direction, 1);
+  append(entry.size(), 4);
+  std::fwrite(header.data(), 1, header.size(), recording.file);
+  std::fwrite(entry.data(), 1, entry.size(), recording.file);
+}
+
+void Request(const mg_session *session, uint8_t signature, ps::List fields = {}) {
+  Write(session, kClient, signature, std::move(fields));
+}
+
+void Success(const mg_session *session, ps::Map metadata = {}) {
+  Write(session, kServer, ps::message::kSuccess, {ps::Value{std::move(metadata)}});
+}
+
+void Failure(mg_session *session) {
+  Write(session, kServer, ps::message::kFailure,
+        {ps::Value{ps::Map{{"message", ps::Value{std::string(mg_session_error(session))}}}}});
+}
+
+/// SUCCESS with the summary of the result, FAILURE if the call failed.
+void Outcome(mg_session *session, int status, const mg_result *result) {
+  if (status < 0) {
+    Failure(session);
+  } else {
+    Success(session, result ? ConvertMap(mg_result_summary(result)) : ps::Map{});
+  }
+}
+
+}  // namespace
+
+bool Enable(const std::string &path) {
+  auto &recording = GetRecording();
+  std::lock_guard<std::mutex> guard(recording.lock);
+  recording.file = std::fopen(path.c_str(), "wb");
+  if (!recording.file) {
+    return false;
+  }
+  std::fwrite(kHeader.data(), 1, kHeader.size(), recording.file);
+  recording.start = std::chrono::steady_clock::now();
+  enabled = true;
+  std::atexit(CloseRecording);
+  return true;
+}
+
+void Connect(mg_session *session, const std::string &user_agent, int status) {
+  if (!IsEnabled()) [[likely]] {
+    return;
+  }
+  Request(session, ps::message::kHello, {ps::Value{ps::Map{{"user_agent", ps::Value{user_agent}}}}});
+  Outcome(session, status, nullptr);
+}
+
+int Run(mg_session *session, const char *query, const mg_list **columns) {
+  if (!IsEnabled()) [[likely]] {
+    return mg_session_run(session, query, nullptr, nullptr, columns, nullptr);
+  }
+  Request(session, ps::message::kRun, {ps::Value{std::string(query)}, ps::Value{ps::Map{}}, ps::Value{ps::Map{}}});
+  const mg_list *run_columns = nullptr;
+  const int status = mg_session_run(session, query, nullptr, nullptr, &run_columns, nullptr);
+  if (status != 0) {
+    Failure(session);
+  } else {
+    Success(session, {{"fields", ps::Value{ConvertList(run_columns)}}});
+  }
+  if (columns) {
+    *columns = run_columns;
+  }
+  return status;
+}
+
+int Pull(mg_session *session, const mg_map *pull_information) {
+  if (!IsEnabled()) [[likely]] {
+    return mg_session_pull(session, pull_information);
+  }
+  Request(session, ps::message::kPull, {ps::Value{ConvertMap(pull_information)}});
+  const int status = mg_session_pull(session, pull_information);
+  if (status != 0) {
+    Failure(session);
+  }
+  return status;
+}
+
+int Fetch(mg_session *session, mg_result **result) {
+  const int status = mg_session_fetch(session, result);
+  if (!IsEnabled()) [[likely]] {
+    return status;
+  }
+  if (status == 1) {
+    Write(session, kServer, ps::message::kRecord, {ps::Value{ConvertList(mg_result_row(*result))}});
+  } else {
+    Outcome(session, status, *result);
+  }
+  return status;
+}
+
+int Begin(mg_session *session) {
+  if (!IsEnabled()) [[likely]] {
+    return mg_session_begin_transaction(session, nullptr);
+  }
+  Request(session, ps::message::kBegin, {ps::Value{ps::Map{}}});
+  const int status = mg_session_begin_transaction(session, nullptr);
+  Outcome(session, status, nullptr);
+  return status;
+}
+
+int Commit(mg_session *session, mg_result **result) {
+  if (!IsEnabled()) [[likely]] {
+    return mg_session_commit_transaction(session, result);
+  }
+  Request(session, ps::message::kCommit);
+  const int status = mg_session_commit_transaction(session, result);
+  Outcome(session, status, status == 0 ? *result : nullptr);
+  return status;
+}
+
+int Rollback(mg_session *session, mg_result **result) {
+  if (!IsEnabled()) [[likely]] {
+    return mg_session_rollback_transaction(session, result);
+  }
+  Request(session, ps::message::kRollback);
+  const int status = mg_session_rollback_transaction(session, result);
+  Outcome(session, status, status == 0 ? *result : nullptr);
+  return status;
+}
+
+ps::Value ToPackStream(const mg_value *value) {
+  switch (mg_value_get_type(value)) {
+    case MG_VALUE_TYPE_NULL:
+      return ps::Value{};
+    case MG_VALUE_TYPE_BOOL:
+      return ps::Value{mg_value_bool(value) != 0};
+    case MG_VALUE_TYPE_INTEGER:
+      return ps::Value{mg_value_integer(value)};
+    case MG_VALUE_TYPE_FLOAT:
+      return ps::Value{mg_value_float(value)};
+    case MG_VALUE_TYPE_STRING:
+      return ps::Value{String(mg_value_string(value))};
+    case MG_VALUE_TYPE_LIST:
+      return ps::Value{ConvertList(mg_value_list(value))};
+    case MG_VALUE_TYPE_MAP:
+      return ps::Value{ConvertMap(mg_value_map(value))};
+    case MG_VALUE_TYPE_NODE:
+      return Node(mg_value_node(value));
+    case MG_VALUE_TYPE_RELATIONSHIP: {
+      const auto *rel = mg_value_relationship(value);
+      return ps::Value{ps::Structure{
+          .signature = 'R',
+          .fields = {ps::Value{mg_relationship_id(rel)}, ps::Value{mg_relationship_start_id(rel)},
+                     ps::Value{mg_relationship_end_id(rel)}, ps::Value{String(mg_relationship_type(rel))},
+                     ps::Value{ConvertMap(mg_relationship_properties(rel))}}}};
+    }
+    case MG_VALUE_TYPE_UNBOUND_RELATIONSHIP:
+      return UnboundRelationship(mg_value_unbound_relationship(value));
+    case MG_VALUE_TYPE_PATH:
+      return Path(mg_value_path(value));
+    case MG_VALUE_TYPE_DATE:
+      return ps::Value{
+          ps::Structure{.signature = 'D', .fields = {ps::Value{mg_date_days(mg_value_date(value))}}}};
+    case MG_VALUE_TYPE_LOCAL_TIME:
+      return ps::Value{ps::Structure{
+          .signature = 't', .fields = {ps::Value{mg_local_time_nanoseconds(mg_value_local_time(value))}}}};
+    case MG_VALUE_TYPE_LOCAL_DATE_TIME: {
+      const auto *local_date_time = mg_value_local_date_time(value);
+      return ps::Value{ps::Structure{.signature = 'd',
+                                     .fields = {ps::Value{mg_local_date_time_seconds(local_date_time)},
+                                                ps::Value{mg_local_date_time_nanoseconds(local_date_time)}}}};
+    }
+    case MG_VALUE_TYPE_DURATION: {
+      const auto *duration = mg_value_duration(value);
+      return ps::Value{ps::Structure{
+          .signature = 'E',
+          .fields = {ps::Value{mg_duration_months(duration)}, ps::Value{mg_duration_days(duration)},
+                     ps::Value{mg_duration_seconds(duration)}, ps::Value{mg_duration_nanoseconds(duration)}}}};
+    }
+    case MG_VALUE_TYPE_POINT_2D: {
+      const auto *point = mg_value_point_2d(value);
+      return ps::Value{ps::Structure{.signature = 'X',
+                                     .fields = {ps::Value{mg_point_2d_srid(point)}, ps::Value{mg_point_2d_x(point)},
+                                                ps::Value{mg_point_2d_y(point)}}}};
+    }
+    case MG_VALUE_TYPE_POINT_3D: {
+      const auto *point = mg_value_point_3d(value);
+      return ps::Value{ps::Structure{.signature = 'Y',
+                                     .fields = {ps::Value{mg_point_3d_srid(point)}, ps::Value{mg_point_3d_x(point)},
+                                                ps::Value{mg_point_3d_y(point)}, ps::Value{mg_point_3d_z(point)}}}};
+    }
+    default:
+      // Types this version of mgconsole doesn't know about are recorded as null.
+      return ps::Value{};
+  }
+}
+
+}  // namespace utils::bolt_record
@@ -0,0 +1,62 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "mgclient.h"
+
+#include "packstream.hpp"
+
+// Records the Bolt traffic of the sessions at the mg_session boundary (--record-bolt), so that a session can be served
+// back by the replay server with the original timing and result shapes. The calls below wrap the mg_session ones and
+// cost a relaxed atomic load on top when the recording is disabled.
+//
+// The file starts with kHeader, followed by the entries:
+//   <session id: u32> <microseconds since the recording started: u64> <direction: u8, kClient or kServer>
+//   <size: u32> <Bolt message, a PackStream structure>
+// The integers are big-endian. The messages are the ones mgclient exchanges with the server for the call (HELLO, RUN,
+// PULL, BEGIN, COMMIT, ROLLBACK and their SUCCESS, RECORD or FAILURE responses), the ones mgclient sends on its own
+// (e.g. RESET after a failure) aren't visible at this boundary.
+
+namespace utils::bolt_record {
+
+constexpr std::string_view kHeader = "mgconsole-bolt-record 1\n";
+constexpr uint8_t kClient = 'C';
+constexpr uint8_t kServer = 'S';
+
+inline std::atomic<bool> enabled{false};
+
+inline bool IsEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+/// Starts recording into the file, false if it can't be opened.
+bool Enable(const std::string &path);
+
+/// Records a new session, HELLO and its outcome.
+void Connect(mg_session *session, const std::string &user_agent, int status);
+
+int Run(mg_session *session, const char *query, const mg_list **columns);
+int Pull(mg_session *session, const mg_map *pull_information);
+int Fetch(mg_session *session, mg_result **result);
+int Begin(mg_session *session);
+int Commit(mg_session *session, mg_result **result);
+int Rollback(mg_session *session, mg_result **result);
+
+packstream::Value ToPackStream(const mg_value *value);
+
+}  // namespace utils::bolt_record
@@ -0,0 +1,177 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "checkpoint.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif /* _WIN32 */
+
+namespace utils {
+
+namespace {
+
+std::atomic<bool> graceful_stop_enabled{false};
+std::atomic<bool> stop_requested{false};
+
+/// Sorts the ranges and merges the adjacent / overlapping ones.
+std::vector<InputRange> MergeRanges(std::vector<InputRange> ranges) {
+  std::sort(ranges.begin(), ranges.end(), [](const auto &lhs, const auto &rhs) { return lhs.begin < rhs.begin; });
+  std::vector<InputRange> merged;
+  for (const auto &range : ranges) {
+    if (!merged.empty() && range.begin <= merged.back().end) {
+      if (range.end > merged.back().end) {
+        merged.back().end = range.end;
+        merged.back().line = range.line;
+      }
+      continue;
+    }
+    merged.push_back(range);
+  }
+  return merged;
+}
+
+std::vector<InputRange> LoadRanges(const std::string &path) {
+  std::ifstream journal(path);
+  std::vector<InputRange> ranges;
+  std::string record;
+  while (std::getline(journal, record)) {
+    // The last record might be torn if the previous run died while writing it.
+    if (journal.eof()) {
+      break;
+    }
+    std::istringstream fields(record);
+    uint64_t batch_index = 0;
+    InputRange range{.begin = 0, .end = 0, .line = 0};
+    if (fields >> batch_index >> range.begin >> range.end >> range.line && range.begin <= range.end) {
+      ranges.push_back(range);
+    }
+  }
+  return MergeRanges(std::move(ranges));
+}
+
+void Sync(std::FILE *file) {
+  std::fflush(file);
+#ifdef _WIN32
+  _commit(_fileno(file));
+#else
+  fsync(fileno(file));
+#endif /* _WIN32 */
+}
+
+}  // namespace
+
+Checkpoint::Checkpoint(const std::string &path, bool resume) : last_sync_(std::chrono::steady_clock::now()) {
+  if (resume) {
+    committed_ = LoadRanges(path);
+  }
+  file_ = std::fopen(path.c_str(), resume ? "a" : "w");
+}
+
+Checkpoint::~Checkpoint() {
+  if (file_) {
+    Flush();
+    std::fclose(file_);
+  }
+}
+
+void Checkpoint::SeekInput() const {
+  if (committed_.empty() || committed_.front().begin != 0) {
+    return;
+  }
+  const auto &prefix = committed_.front();
+  if (console::SeekInput(prefix.end, prefix.line)) {
+    std::cerr << "Checkpoint: resuming the import from line " << prefix.line << " (byte " << prefix.end << ")"
+              << std::endl;
+  } else {
+    std::cerr << "Checkpoint: the input can't be seeked, the committed queries are skipped while reading it"
+              << std::endl;
+  }
+}
+
+bool Checkpoint::IsCommitted(const query::Query &query) const {
+  // The last range starting before the query.
+  auto it = std::upper_bound(committed_.begin(), committed_.end(), query.begin_offset,
+                             [](const auto offset, const auto &range) { return offset < range.begin; });
+  if (it == committed_.begin()) {
+    return false;
+  }
+  --it;
+  if (query.end_offset > it->end) {
+    return false;
+  }
+  ++skipped_;
+  return true;
+}
+
+void Checkpoint::Commit(uint64_t batch_index, const std::vector<query::Query> &queries) {
+  std::vector<InputRange> ranges;
+  ranges.reserve(queries.size());
+  for (const auto &query : queries) {
+    ranges.push_back({.begin = query.begin_offset, .end = query.end_offset, .line = query.line_number});
+  }
+  Write(batch_index, MergeRanges(std::move(ranges)));
+}
+
+void Checkpoint::Commit(uint64_t batch_index, const query::Query &query) {
+  Write(batch_index, {{.begin = query.begin_offset, .end = query.end_offset, .line = query.line_number}});
+}
+
+void Checkpoint::Write(uint64_t batch_index, const std::vector<InputRange> &ranges) {
+  std::lock_guard<std::mutex> guard(lock_);
+  if (!file_) {
+    return;
+  }
+  for (const auto &range : ranges) {
+    std::fprintf(file_, "%llu %llu %llu %lld\n", static_cast<unsigned long long>(batch_index),
+                 static_cast<unsigned long long>(range.begin), static_cast<unsigned long long>(range.end),
+                 static_cast<long long>(range.line));
+  }
+  // Hand the records to the OS right away, a crash of the process doesn't lose them, only the OS crash might lose the
+  // ones since the last fsync.
+  std::fflush(file_);
+  dirty_ = true;
+  const auto now = std::chrono::steady_clock::now();
+  if (now - last_sync_ >= kSyncInterval) {
+    Sync(file_);
+    last_sync_ = now;
+    dirty_ = false;
+  }
+}
+
+void Checkpoint::Flush() {
+  std::lock_guard<std::mutex> guard(lock_);
+  if (!file_ || !dirty_) {
+    return;
+  }
+  Sync(file_);
+  last_sync_ = std::chrono::steady_clock::now();
+  dirty_ = false;
+}
+
+void EnableGracefulStop() { graceful_stop_enabled = true; }
+bool IsGracefulStopEnabled() { return graceful_stop_enabled.load(); }
+void RequestStop() { stop_requested = true; }
+bool IsStopRequested() { return stop_requested.load(); }
+
+}  // namespace utils
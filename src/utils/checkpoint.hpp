@@ -0,0 +1,90 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "utils.hpp"
+
+namespace utils {
+
+/// A part of the input, [begin, end) in bytes. line is the line of the end.
+struct InputRange {
+  uint64_t begin;
+  uint64_t end;
+  int64_t line;
+};
+
+/// Journal of the committed parts of the input, so that an interrupted import can be resumed without importing
+/// anything twice. Each commit appends a line per contiguous input range, "<batch index> <begin> <end> <line>\n" (the
+/// batch index is only informational). The records are written right away (they survive the process) and fsynced in
+/// groups (kSyncInterval), a torn last record is ignored on resume.
+class Checkpoint {
+ public:
+  static constexpr std::chrono::milliseconds kSyncInterval{100};
+
+  /// Truncates the journal, or with resume loads the committed ranges and appends to it. Check IsOpen after.
+  Checkpoint(const std::string &path, bool resume);
+  Checkpoint(const Checkpoint &) = delete;
+  Checkpoint &operator=(const Checkpoint &) = delete;
+  Checkpoint(Checkpoint &&) = delete;
+  Checkpoint &operator=(Checkpoint &&) = delete;
+  ~Checkpoint();
+
+  bool IsOpen() const { return file_ != nullptr; }
+
+  /// Seeks the input to the end of the committed prefix. If the input can't be seeked it's read from the start and the
+  /// committed queries are skipped via IsCommitted.
+  void SeekInput() const;
+
+  /// True if the query was committed by a previous run.
+  bool IsCommitted(const query::Query &query) const;
+
+  /// Journals the queries of a committed (or rejected) batch, thread-safe.
+  void Commit(uint64_t batch_index, const std::vector<query::Query> &queries);
+  void Commit(uint64_t batch_index, const query::Query &query);
+
+  /// fsyncs everything committed so far.
+  void Flush();
+
+  /// Number of queries skipped because of IsCommitted.
+  uint64_t Skipped() const { return skipped_; }
+
+ private:
+  void Write(uint64_t batch_index, const std::vector<InputRange> &ranges);
+
+  std::FILE *file_{nullptr};
+  std::mutex lock_;
+  std::chrono::steady_clock::time_point last_sync_;
+  bool dirty_{false};
+  /// Committed by the previous runs, sorted and merged.
+  std::vector<InputRange> committed_;
+  mutable uint64_t skipped_{0};
+};
+
+/// Used by the signal handler (main.cpp): once enabled, the first SIGINT/SIGTERM only requests a stop, the imports
+/// stop reading the input, drain the batches in flight and flush the checkpoint journal. The second one exits.
+void EnableGracefulStop();
+bool IsGracefulStopEnabled();
+void RequestStop();
+bool IsStopRequested();
+
+}  // namespace utils
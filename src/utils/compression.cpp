@@ -0,0 +1,89 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "compression.hpp"
+
+#include <cstdlib>
+#include <iostream>
+
+#include <zlib.h>
+#include <zstd.h>
+
+namespace utils::compression {
+
+namespace {
+
+constexpr int kZstdLevel = 3;
+
+[[noreturn]] void Fail(std::string_view what) {
+  std::cerr << "compression failed: " << what << std::endl;
+  std::abort();
+}
+
+void CompressGzip(std::string_view block, std::string &buffer) {
+  z_stream stream{};
+  // 16 + the default window bits, a gzip header and trailer instead of the zlib ones.
+  if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+    Fail("deflateInit2");
+  }
+  const auto offset = buffer.size();
+  buffer.resize(offset + deflateBound(&stream, block.size()));
+  stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(block.data()));
+  stream.avail_in = block.size();
+  stream.next_out = reinterpret_cast<Bytef *>(buffer.data() + offset);
+  stream.avail_out = buffer.size() - offset;
+  // The bound fits everything, a single call finishes the member.
+  if (deflate(&stream, Z_FINISH) != Z_STREAM_END) {
+    Fail(stream.msg ? stream.msg : "deflate");
+  }
+  buffer.resize(offset + stream.total_out);
+  deflateEnd(&stream);
+}
+
+void CompressZstd(std::string_view block, std::string &buffer) {
+  const auto offset = buffer.size();
+  buffer.resize(offset + ZSTD_compressBound(block.size()));
+  const auto size =
+      ZSTD_compress(buffer.data() + offset, buffer.size() - offset, block.data(), block.size(), kZstdLevel);
+  if (ZSTD_isError(size)) {
+    Fail(ZSTD_getErrorName(size));
+  }
+  buffer.resize(offset + size);
+}
+
+}  // namespace
+
+std::optional<Type> Parse(std::string_view name) {
+  if (name == "none") return Type::NONE;
+  if (name == "gzip") return Type::GZIP;
+  if (name == "zstd") return Type::ZSTD;
+  return std::nullopt;
+}
+
+void Compress(Type type, std::string_view block, std::string &buffer) {
+  switch (type) {
+    case Type::NONE:
+      buffer.append(block);
+      break;
+    case Type::GZIP:
+      CompressGzip(block, buffer);
+      break;
+    case Type::ZSTD:
+      CompressZstd(block, buffer);
+      break;
+  }
+}
+
+}  // namespace utils::compression
@@ -0,0 +1,35 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Compression of the output in independent blocks: each block is a whole gzip member or zstd frame, and both formats
+// decompress a concatenation of them into the concatenation of the blocks. So the blocks can be compressed in
+// parallel and written one after another, and the result is still a regular .gz or .zst file.
+
+namespace utils::compression {
+
+enum class Type { NONE, GZIP, ZSTD };
+
+/// "none", "gzip" or "zstd".
+std::optional<Type> Parse(std::string_view name);
+
+/// Appends the compressed block to the buffer, thread-safe.
+void Compress(Type type, std::string_view block, std::string &buffer);
+
+}  // namespace utils::compression
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -38,11 +39,31 @@ constexpr const std::string_view kCommandDocs = ":docs";
 constexpr const std::string_view kCsvFormat = "csv";
 constexpr const std::string_view kTabularFormat = "tabular";
 constexpr const std::string_view kCypherlFormat = "cypherl";
+constexpr const std::string_view kJsonlFormat = "jsonl";
+constexpr const std::string_view kArrowFormat = "arrow";
 
 // Supported modes.
 constexpr const std::string_view kSerialMode = "serial";
 constexpr const std::string_view kBatchedParallel = "batched-parallel";
 constexpr const std::string_view kParserMode = "parser";
+constexpr const std::string_view kBenchMode = "bench";
+constexpr const std::string_view kReplayMode = "replay";
+
+// Supported edge scheduling policies of the batched-parallel mode.
+constexpr const std::string_view kArrivalScheduling = "arrival";
+constexpr const std::string_view kConflictAwareScheduling = "conflict-aware";
+
+// Supported MERGE scheduling policies of the batched-parallel mode.
+constexpr const std::string_view kSerialMergeScheduling = "serial";
+constexpr const std::string_view kHashPartitionedMergeScheduling = "hash-partitioned";
+
+// Supported schedulers of the batched-parallel mode.
+constexpr const std::string_view kPhasedImportScheduler = "phased";
+constexpr const std::string_view kDagImportScheduler = "dag";
+
+// Parts of the database error messages which mean that a transaction might pass if retried.
+constexpr const std::array<std::string_view, 3> kConflictErrorPatterns{"conflicting transactions", "Serialization",
+                                                                       "serialization"};
 
 // History default directory.
 static const std::string kDefaultHistoryBaseDir = "~";
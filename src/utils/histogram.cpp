@@ -0,0 +1,89 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "histogram.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace utils {
+
+namespace {
+// 2048 linear sub-buckets per power of two (the lower half of which overlaps with the previous bucket), i.e. 3
+// significant decimal digits.
+constexpr int kSubBucketHalfCountMagnitude = 10;
+constexpr uint64_t kSubBucketHalfCount = uint64_t{1} << kSubBucketHalfCountMagnitude;
+constexpr uint64_t kSubBucketMask = (kSubBucketHalfCount << 1) - 1;
+constexpr int kBucketCount = std::bit_width(Histogram::kMaxValue) - kSubBucketHalfCountMagnitude;
+
+int BucketIndex(uint64_t value) {
+  return std::bit_width(value | kSubBucketMask) - 1 - kSubBucketHalfCountMagnitude;
+}
+
+size_t CountsIndex(uint64_t value) {
+  const int bucket = BucketIndex(value);
+  const uint64_t sub_bucket = value >> bucket;
+  return ((bucket + 1) << kSubBucketHalfCountMagnitude) + (sub_bucket - kSubBucketHalfCount);
+}
+
+/// The largest value which ends up at the index.
+uint64_t HighestValueAt(size_t index) {
+  int bucket = static_cast<int>(index >> kSubBucketHalfCountMagnitude) - 1;
+  uint64_t sub_bucket = (index & (kSubBucketHalfCount - 1)) + kSubBucketHalfCount;
+  if (bucket < 0) {
+    sub_bucket -= kSubBucketHalfCount;
+    bucket = 0;
+  }
+  return ((sub_bucket + 1) << bucket) - 1;
+}
+}  // namespace
+
+Histogram::Histogram() : counts_((kBucketCount + 1) << kSubBucketHalfCountMagnitude, 0) {}
+
+void Histogram::Record(uint64_t value) {
+  value = std::min(value, kMaxValue);
+  ++counts_[CountsIndex(value)];
+  ++count_;
+  sum_ += value;
+  max_ = std::max(max_, value);
+}
+
+void Histogram::Merge(const Histogram &other) {
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    counts_[i] += other.counts_[i];
+  }
+  count_ += other.count_;
+  sum_ += other.sum_;
+  max_ = std::max(max_, other.max_);
+}
+
+uint64_t Histogram::ValueAtPercentile(double percentile) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  const auto wanted = std::max<uint64_t>(
+      1, static_cast<uint64_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<double>(count_))));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    seen += counts_[i];
+    if (seen >= wanted) {
+      return std::min(HighestValueAt(i), max_);
+    }
+  }
+  return max_;
+}
+
+}  // namespace utils
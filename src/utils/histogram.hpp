@@ -0,0 +1,50 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace utils {
+
+/// HDR histogram (log-linear buckets, http://hdrhistogram.org) of non-negative integer values, e.g. microseconds. The
+/// values up to kMaxValue are recorded with a relative error under 0.1% (3 significant digits) in constant time,
+/// larger ones are clamped. Not thread-safe, record per thread and Merge.
+class Histogram {
+ public:
+  /// An hour in microseconds fits.
+  static constexpr uint64_t kMaxValue = (uint64_t{1} << 32) - 1;
+
+  Histogram();
+
+  void Record(uint64_t value);
+  void Merge(const Histogram &other);
+
+  uint64_t Count() const { return count_; }
+  uint64_t Max() const { return max_; }
+  double Mean() const { return count_ ? static_cast<double>(sum_) / count_ : 0.0; }
+  /// The smallest recorded value (up to the precision) such that percentile % of the values are less or equal, 0 if
+  /// empty.
+  uint64_t ValueAtPercentile(double percentile) const;
+
+ private:
+  std::vector<uint64_t> counts_;
+  uint64_t count_{0};
+  uint64_t sum_{0};
+  uint64_t max_{0};
+};
+
+}  // namespace utils
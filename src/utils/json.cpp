@@ -0,0 +1,277 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "json.hpp"
+
+#include <cmath>
+
+#include "scan.hpp"
+#include "utils.hpp"
+
+namespace utils::json {
+
+namespace {
+
+constexpr char kHexDigits[] = "0123456789abcdef";
+
+std::string_view View(const mg_string *str) { return std::string_view(mg_string_data(str), mg_string_size(str)); }
+
+void AppendKey(std::string &buffer, std::string_view key) {
+  AppendString(buffer, key);
+  buffer.push_back(':');
+}
+
+void AppendFloat(std::string &buffer, double value) {
+  if (std::isnan(value)) {
+    buffer.append("\"NaN\"");
+  } else if (std::isinf(value)) {
+    buffer.append(value > 0 ? "\"Infinity\"" : "\"-Infinity\"");
+  } else {
+    const auto begin = buffer.size();
+    utils::AppendFloat(buffer, value);
+    // The shortest form of 1.0 is 1, which the JSON readers would take for an integer.
+    if (buffer.find_first_of(".e", begin) == std::string::npos) {
+      buffer.append(".0");
+    }
+  }
+}
+
+void AppendMap(std::string &buffer, const mg_map *map) {
+  buffer.push_back('{');
+  for (uint32_t i = 0; i < mg_map_size(map); ++i) {
+    if (i > 0) buffer.push_back(',');
+    AppendKey(buffer, View(mg_map_key_at(map, i)));
+    AppendValue(buffer, mg_map_value_at(map, i));
+  }
+  buffer.push_back('}');
+}
+
+void AppendList(std::string &buffer, const mg_list *list) {
+  buffer.push_back('[');
+  for (uint32_t i = 0; i < mg_list_size(list); ++i) {
+    if (i > 0) buffer.push_back(',');
+    AppendValue(buffer, mg_list_at(list, i));
+  }
+  buffer.push_back(']');
+}
+
+void AppendNode(std::string &buffer, const mg_node *node) {
+  buffer.append("{\"__type\":\"node\",\"id\":");
+  AppendInteger(buffer, mg_node_id(node));
+  buffer.append(",\"labels\":[");
+  for (uint32_t i = 0; i < mg_node_label_count(node); ++i) {
+    if (i > 0) buffer.push_back(',');
+    AppendString(buffer, View(mg_node_label_at(node, i)));
+  }
+  buffer.append("],\"properties\":");
+  AppendMap(buffer, mg_node_properties(node));
+  buffer.push_back('}');
+}
+
+void AppendRelationship(std::string &buffer, int64_t id, const mg_string *type, int64_t start, int64_t end,
+                        const mg_map *properties) {
+  buffer.append("{\"__type\":\"relationship\",\"id\":");
+  AppendInteger(buffer, id);
+  buffer.append(",\"type\":");
+  AppendString(buffer, View(type));
+  buffer.append(",\"start\":");
+  AppendInteger(buffer, start);
+  buffer.append(",\"end\":");
+  AppendInteger(buffer, end);
+  buffer.append(",\"properties\":");
+  AppendMap(buffer, properties);
+  buffer.push_back('}');
+}
+
+void AppendPath(std::string &buffer, const mg_path *path) {
+  buffer.append("{\"__type\":\"path\",\"nodes\":[");
+  for (uint32_t i = 0; i <= mg_path_length(path); ++i) {
+    if (i > 0) buffer.push_back(',');
+    AppendNode(buffer, mg_path_node_at(path, i));
+  }
+  buffer.append("],\"relationships\":[");
+  for (uint32_t i = 0; i < mg_path_length(path); ++i) {
+    if (i > 0) buffer.push_back(',');
+    // The relationships of a path don't know their endpoints, they are the nodes around them.
+    const auto *rel = mg_path_relationship_at(path, i);
+    auto start = mg_node_id(mg_path_node_at(path, i));
+    auto end = mg_node_id(mg_path_node_at(path, i + 1));
+    if (mg_path_relationship_reversed_at(path, i)) {
+      std::swap(start, end);
+    }
+    AppendRelationship(buffer, mg_unbound_relationship_id(rel), mg_unbound_relationship_type(rel), start, end,
+                       mg_unbound_relationship_properties(rel));
+  }
+  buffer.append("]}");
+}
+
+/// The value in the same text form as the other output formats.
+template <class T>
+void AppendTagged(std::string &buffer, std::string_view type, const T *value) {
+  buffer.append("{\"__type\":\"");
+  buffer.append(type);
+  buffer.append("\",\"__value\":\"");
+  utils::AppendValue(buffer, value);
+  buffer.append("\"}");
+}
+
+void AppendDuration(std::string &buffer, const mg_duration *duration) {
+  buffer.append("{\"__type\":\"duration\",\"months\":");
+  AppendInteger(buffer, mg_duration_months(duration));
+  buffer.append(",\"days\":");
+  AppendInteger(buffer, mg_duration_days(duration));
+  buffer.append(",\"seconds\":");
+  AppendInteger(buffer, mg_duration_seconds(duration));
+  buffer.append(",\"nanoseconds\":");
+  AppendInteger(buffer, mg_duration_nanoseconds(duration));
+  buffer.push_back('}');
+}
+
+void AppendPoint(std::string &buffer, const mg_point_2d *point) {
+  buffer.append("{\"__type\":\"point_2d\",\"srid\":");
+  AppendInteger(buffer, mg_point_2d_srid(point));
+  buffer.append(",\"x\":");
+  AppendFloat(buffer, mg_point_2d_x(point));
+  buffer.append(",\"y\":");
+  AppendFloat(buffer, mg_point_2d_y(point));
+  buffer.push_back('}');
+}
+
+void AppendPoint(std::string &buffer, const mg_point_3d *point) {
+  buffer.append("{\"__type\":\"point_3d\",\"srid\":");
+  AppendInteger(buffer, mg_point_3d_srid(point));
+  buffer.append(",\"x\":");
+  AppendFloat(buffer, mg_point_3d_x(point));
+  buffer.append(",\"y\":");
+  AppendFloat(buffer, mg_point_3d_y(point));
+  buffer.append(",\"z\":");
+  AppendFloat(buffer, mg_point_3d_z(point));
+  buffer.push_back('}');
+}
+
+}  // namespace
+
+void AppendString(std::string &buffer, std::string_view str) {
+  buffer.reserve(buffer.size() + str.size() + 2);
+  buffer.push_back('"');
+  for (size_t pos = 0;;) {
+    const auto special = scan::FindJsonSpecial(str, pos);
+    buffer.append(str.data() + pos, special - pos);
+    if (special == str.size()) break;
+    const auto c = str[special];
+    pos = special + 1;
+    switch (c) {
+      case '"':
+        buffer.append("\\\"");
+        break;
+      case '\\':
+        buffer.append("\\\\");
+        break;
+      case '\b':
+        buffer.append("\\b");
+        break;
+      case '\f':
+        buffer.append("\\f");
+        break;
+      case '\n':
+        buffer.append("\\n");
+        break;
+      case '\r':
+        buffer.append("\\r");
+        break;
+      case '\t':
+        buffer.append("\\t");
+        break;
+      default:
+        // The other control characters, everything else (UTF-8 as well) is copied with the runs.
+        buffer.append("\\u00");
+        buffer.push_back(kHexDigits[c >> 4]);
+        buffer.push_back(kHexDigits[c & 0xf]);
+    }
+  }
+  buffer.push_back('"');
+}
+
+void AppendValue(std::string &buffer, const mg_value *value) {
+  switch (mg_value_get_type(value)) {
+    case MG_VALUE_TYPE_NULL:
+      buffer.append("null");
+      return;
+    case MG_VALUE_TYPE_BOOL:
+      buffer.append(mg_value_bool(value) ? "true" : "false");
+      return;
+    case MG_VALUE_TYPE_INTEGER:
+      AppendInteger(buffer, mg_value_integer(value));
+      return;
+    case MG_VALUE_TYPE_FLOAT:
+      AppendFloat(buffer, mg_value_float(value));
+      return;
+    case MG_VALUE_TYPE_STRING:
+      AppendString(buffer, View(mg_value_string(value)));
+      return;
+    case MG_VALUE_TYPE_LIST:
+      AppendList(buffer, mg_value_list(value));
+      return;
+    case MG_VALUE_TYPE_MAP:
+      // Including the enums, {"__type": "mg_enum", "__value": "Status::Good"}.
+      AppendMap(buffer, mg_value_map(value));
+      return;
+    case MG_VALUE_TYPE_NODE:
+      AppendNode(buffer, mg_value_node(value));
+      return;
+    case MG_VALUE_TYPE_RELATIONSHIP: {
+      const auto *rel = mg_value_relationship(value);
+      AppendRelationship(buffer, mg_relationship_id(rel), mg_relationship_type(rel), mg_relationship_start_id(rel),
+                         mg_relationship_end_id(rel), mg_relationship_properties(rel));
+      return;
+    }
+    case MG_VALUE_TYPE_UNBOUND_RELATIONSHIP: {
+      const auto *rel = mg_value_unbound_relationship(value);
+      buffer.append("{\"__type\":\"relationship\",\"id\":");
+      AppendInteger(buffer, mg_unbound_relationship_id(rel));
+      buffer.append(",\"type\":");
+      AppendString(buffer, View(mg_unbound_relationship_type(rel)));
+      buffer.append(",\"properties\":");
+      AppendMap(buffer, mg_unbound_relationship_properties(rel));
+      buffer.push_back('}');
+      return;
+    }
+    case MG_VALUE_TYPE_PATH:
+      AppendPath(buffer, mg_value_path(value));
+      return;
+    case MG_VALUE_TYPE_DATE:
+      AppendTagged(buffer, "date", mg_value_date(value));
+      return;
+    case MG_VALUE_TYPE_LOCAL_TIME:
+      AppendTagged(buffer, "local_time", mg_value_local_time(value));
+      return;
+    case MG_VALUE_TYPE_LOCAL_DATE_TIME:
+      AppendTagged(buffer, "local_date_time", mg_value_local_date_time(value));
+      return;
+    case MG_VALUE_TYPE_DURATION:
+      AppendDuration(buffer, mg_value_duration(value));
+      return;
+    case MG_VALUE_TYPE_POINT_2D:
+      AppendPoint(buffer, mg_value_point_2d(value));
+      return;
+    case MG_VALUE_TYPE_POINT_3D:
+      AppendPoint(buffer, mg_value_point_3d(value));
+      return;
+    default:
+      buffer.append("{\"__type\":\"unknown\"}");
+      return;
+  }
+}
+
+}  // namespace utils::json
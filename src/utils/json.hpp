@@ -0,0 +1,40 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "mgclient.h"
+
+// JSON encoding of the query results, written straight into an append buffer. The values which JSON doesn't have are
+// objects tagged with "__type" (the same convention Memgraph uses for enums, {"__type": "mg_enum", "__value": ...}):
+//   node:          {"__type": "node", "id": 1, "labels": ["L"], "properties": {...}}
+//   relationship:  {"__type": "relationship", "id": 2, "type": "T", "start": 1, "end": 3, "properties": {...}}
+//   path:          {"__type": "path", "nodes": [...], "relationships": [...]}
+//   date, local_time, local_date_time: {"__type": "date", "__value": "1999-05-05"}
+//   duration:      {"__type": "duration", "months": 0, "days": 1, "seconds": 2, "nanoseconds": 3}
+//   point_2d/3d:   {"__type": "point_2d", "srid": 7203, "x": 0.0, "y": 1.0}
+// Floats always have a fraction or an exponent (1.0, not 1), the ones which aren't finite are the strings "NaN",
+// "Infinity" and "-Infinity".
+
+namespace utils::json {
+
+/// Appends the quoted and escaped string.
+void AppendString(std::string &buffer, std::string_view str);
+
+void AppendValue(std::string &buffer, const mg_value *value);
+
+}  // namespace utils::json
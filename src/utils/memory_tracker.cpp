@@ -0,0 +1,90 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "memory_tracker.hpp"
+
+#include <array>
+#include <cctype>
+#include <limits>
+#include <string>
+#include <utility>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif /* _WIN32 */
+
+namespace utils {
+
+std::optional<uint64_t> ParseByteSize(std::string_view value) {
+  uint64_t number = 0;
+  size_t pos = 0;
+  for (; pos < value.size() && std::isdigit(static_cast<unsigned char>(value[pos])); ++pos) {
+    const uint64_t digit = value[pos] - '0';
+    if (number > (std::numeric_limits<uint64_t>::max() - digit) / 10) {
+      return std::nullopt;
+    }
+    number = number * 10 + digit;
+  }
+  if (pos == 0) {
+    return std::nullopt;
+  }
+  std::string suffix;
+  for (; pos < value.size(); ++pos) {
+    suffix += static_cast<char>(std::toupper(static_cast<unsigned char>(value[pos])));
+  }
+  constexpr std::array<std::pair<std::string_view, uint64_t>, 11> kUnits{{
+      {"", 1},
+      {"B", 1},
+      {"K", 1ULL << 10},
+      {"KB", 1ULL << 10},
+      {"KIB", 1ULL << 10},
+      {"M", 1ULL << 20},
+      {"MB", 1ULL << 20},
+      {"MIB", 1ULL << 20},
+      {"G", 1ULL << 30},
+      {"GB", 1ULL << 30},
+      {"GIB", 1ULL << 30},
+  }};
+  std::optional<uint64_t> multiplier;
+  for (const auto &[unit, unit_multiplier] : kUnits) {
+    if (suffix == unit) {
+      multiplier = unit_multiplier;
+    }
+  }
+  if (!multiplier || number > std::numeric_limits<uint64_t>::max() / *multiplier) {
+    return std::nullopt;
+  }
+  return number * *multiplier;
+}
+
+std::optional<uint64_t> PeakRss() {
+#ifdef _WIN32
+  return std::nullopt;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return std::nullopt;
+  }
+#ifdef __APPLE__
+  // Bytes on macOS.
+  return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+  // Kilobytes on Linux.
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif /* __APPLE__ */
+#endif /* _WIN32 */
+}
+
+}  // namespace utils
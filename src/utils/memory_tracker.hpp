@@ -0,0 +1,87 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace utils {
+
+/// Counts the bytes held by the batched import. The numbers are estimates (string capacities + struct sizes), not what
+/// the allocator sees, but they grow with the input the same way.
+class MemoryTracker {
+ public:
+  void Add(uint64_t bytes) {
+    auto current = current_.fetch_add(bytes) + bytes;
+    auto peak = peak_.load();
+    while (current > peak && !peak_.compare_exchange_weak(peak, current)) {
+    }
+  }
+  void Release(uint64_t bytes) { current_.fetch_sub(bytes); }
+  uint64_t Current() const { return current_.load(); }
+  uint64_t Peak() const { return peak_.load(); }
+
+ private:
+  std::atomic<uint64_t> current_{0};
+  std::atomic<uint64_t> peak_{0};
+};
+
+/// Bytes registered with a MemoryTracker, released once the owner is gone.
+class TrackedBytes {
+ public:
+  explicit TrackedBytes(MemoryTracker *tracker) : tracker_(tracker) {}
+  TrackedBytes(const TrackedBytes &) = delete;
+  TrackedBytes &operator=(const TrackedBytes &) = delete;
+  TrackedBytes(TrackedBytes &&other) noexcept : tracker_(other.tracker_), bytes_(other.bytes_) { other.bytes_ = 0; }
+  TrackedBytes &operator=(TrackedBytes &&other) noexcept {
+    if (this != &other) {
+      Reset();
+      tracker_ = other.tracker_;
+      bytes_ = other.bytes_;
+      other.bytes_ = 0;
+    }
+    return *this;
+  }
+  ~TrackedBytes() { Reset(); }
+
+  void Add(uint64_t bytes) {
+    if (tracker_) {
+      tracker_->Add(bytes);
+      bytes_ += bytes;
+    }
+  }
+  void Reset() {
+    if (tracker_) {
+      tracker_->Release(bytes_);
+    }
+    bytes_ = 0;
+  }
+  uint64_t Bytes() const { return bytes_; }
+
+ private:
+  MemoryTracker *tracker_;
+  uint64_t bytes_{0};
+};
+
+/// Parses sizes like 1024, 512KB, 64MiB or 4G (powers of 1024), returns nullopt if the value is not a size.
+std::optional<uint64_t> ParseByteSize(std::string_view value);
+
+/// Peak resident set size of the process, nullopt if unknown on the platform.
+std::optional<uint64_t> PeakRss();
+
+}  // namespace utils
@@ -0,0 +1,253 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "output.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif /* _WIN32 */
+
+#include "future.hpp"
+#include "thread_pool.hpp"
+
+namespace utils::output {
+
+namespace {
+
+class Writer {
+ public:
+  Writer() { front_.reserve(kBufferSize + kBufferSize / 4); }
+  Writer(const Writer &) = delete;
+  Writer &operator=(const Writer &) = delete;
+  Writer(Writer &&) = delete;
+  Writer &operator=(Writer &&) = delete;
+  ~Writer() { Close(); }
+
+  bool Open(const std::string &path) {
+    auto *file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    file_ = file;
+    return true;
+  }
+
+  bool IsFile() const { return file_ != stdout; }
+
+  /// The results get their own copy of the standard output, which then points to the standard error.
+  bool SeparateConsole() {
+    std::cout.flush();
+    std::fflush(stdout);
+#ifdef _WIN32
+    const int results_fd = _dup(_fileno(stdout));
+    auto *file = results_fd >= 0 ? _fdopen(results_fd, "wb") : nullptr;
+    if (file) _setmode(results_fd, _O_BINARY);
+    const auto redirected = file && _dup2(_fileno(stderr), _fileno(stdout)) == 0;
+#else
+    const int results_fd = dup(fileno(stdout));
+    auto *file = results_fd >= 0 ? fdopen(results_fd, "wb") : nullptr;
+    const auto redirected = file && dup2(fileno(stderr), fileno(stdout)) >= 0;
+#endif /* _WIN32 */
+    if (!redirected) {
+      if (file) {
+        std::fclose(file);
+      } else if (results_fd >= 0) {
+#ifdef _WIN32
+        _close(results_fd);
+#else
+        close(results_fd);
+#endif /* _WIN32 */
+      }
+      return false;
+    }
+    file_ = file;
+    return true;
+  }
+
+  void SetCompression(compression::Type type, size_t workers) {
+    compression_ = type;
+    workers_ = workers > 0 ? workers : std::max(1U, std::thread::hardware_concurrency());
+  }
+
+  std::string &Buffer() { return front_; }
+
+  void Commit() {
+    if (front_.size() >= kBufferSize) {
+      HandOff();
+    }
+  }
+
+  void Flush() {
+    if (!front_.empty()) {
+      HandOff();
+    }
+    WriteCompressed(0);
+    std::unique_lock<std::mutex> guard(lock_);
+    cv_.wait(guard, [this] { return back_.empty(); });
+  }
+
+  bool Close() {
+    Flush();
+    if (thread_.joinable()) {
+      {
+        std::lock_guard<std::mutex> guard(lock_);
+        stop_ = true;
+      }
+      cv_.notify_all();
+      thread_.join();
+    }
+    if (file_ != stdout) {
+      if (std::fclose(file_) != 0) {
+        Fail(errno);
+      }
+      file_ = stdout;
+    } else if (std::fflush(stdout) != 0) {
+      Fail(errno);
+    }
+    return !failed_;
+  }
+
+ private:
+  /// Only the first error is reported, the rest of the output is dropped.
+  void Fail(int error) {
+    if (failed_.exchange(true)) return;
+    std::cerr << "Unable to write the output: " << std::strerror(error) << std::endl;
+  }
+
+  void HandOff() {
+    if (compression_ == compression::Type::NONE) {
+      Write(front_);
+      return;
+    }
+    // Each block is compressed on its own by the pool, and written in order once it's done.
+    if (!pool_) {
+      pool_ = std::make_unique<utils::ThreadPool>(workers_);
+    }
+    auto block = std::make_shared<std::string>(std::move(front_));
+    front_ = std::string();
+    front_.reserve(kBufferSize + kBufferSize / 4);
+    auto [future, promise] = utils::FuturePromisePair<std::shared_ptr<std::string>>();
+    auto shared_promise = std::make_shared<decltype(promise)>(std::move(promise));
+    pool_->AddTask([type = compression_, block = std::move(block), promise = std::move(shared_promise)]() {
+      auto compressed = std::make_shared<std::string>();
+      compression::Compress(type, *block, *compressed);
+      promise->Fill(std::move(compressed));
+    });
+    pending_.push_back(std::move(future));
+    // Enough blocks to keep the workers busy while the oldest one is written.
+    WriteCompressed(2 * workers_);
+  }
+
+  /// Writes the blocks which are already compressed, and waits for the oldest ones while there are more than
+  /// max_pending.
+  void WriteCompressed(size_t max_pending) {
+    while (!pending_.empty() && (pending_.size() > max_pending || pending_.front().IsReady())) {
+      auto compressed = std::move(pending_.front()).Wait();
+      pending_.pop_front();
+      Write(*compressed);
+    }
+  }
+
+  /// Waits until the writer thread is done with the previous buffer and gives it this one.
+  void Write(std::string &buffer) {
+    if (!thread_.joinable()) {
+      thread_ = std::thread([this] { Loop(); });
+    }
+    if (file_ == stdout) {
+      // Whatever was printed before the results goes first.
+      std::cout.flush();
+    }
+    {
+      std::unique_lock<std::mutex> guard(lock_);
+      cv_.wait(guard, [this] { return back_.empty(); });
+      std::swap(buffer, back_);
+    }
+    cv_.notify_all();
+  }
+
+  void Loop() {
+    std::unique_lock<std::mutex> guard(lock_);
+    while (true) {
+      cv_.wait(guard, [this] { return stop_ || !back_.empty(); });
+      if (back_.empty()) return;
+      // The front buffer isn't touched by this thread, the formatting continues while writing.
+      guard.unlock();
+      if (!failed_ &&
+          (std::fwrite(back_.data(), 1, back_.size(), file_) != back_.size() || std::fflush(file_) != 0)) {
+        Fail(errno);
+      }
+      guard.lock();
+      back_.clear();
+      cv_.notify_all();
+    }
+  }
+
+  std::FILE *file_{stdout};
+  compression::Type compression_{compression::Type::NONE};
+  size_t workers_{1};
+  std::unique_ptr<utils::ThreadPool> pool_;
+  std::deque<utils::Future<std::shared_ptr<std::string>>> pending_;
+  std::string front_;
+  /// Owned by the writer thread while not empty.
+  std::string back_;
+  std::mutex lock_;
+  std::condition_variable cv_;
+  bool stop_{false};
+  std::atomic<bool> failed_{false};
+  std::thread thread_;
+};
+
+Writer &GetWriter() {
+  static Writer writer;
+  return writer;
+}
+
+}  // namespace
+
+bool OpenFile(const std::string &path) { return GetWriter().Open(path); }
+
+void SetBinary() {
+#ifdef _WIN32
+  _setmode(_fileno(stdout), _O_BINARY);
+#endif /* _WIN32 */
+}
+
+void SetCompression(compression::Type type, size_t workers) { GetWriter().SetCompression(type, workers); }
+
+bool IsFile() { return GetWriter().IsFile(); }
+
+bool SeparateConsole() { return GetWriter().SeparateConsole(); }
+
+std::string &Buffer() { return GetWriter().Buffer(); }
+
+void Commit() { GetWriter().Commit(); }
+
+void Flush() { GetWriter().Flush(); }
+
+bool Close() { return GetWriter().Close(); }
+
+}  // namespace utils::output
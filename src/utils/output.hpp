@@ -0,0 +1,63 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "compression.hpp"
+
+// The query results are formatted into a buffer which is written by a background thread, kBufferSize bytes at a time.
+// While the writer thread writes one buffer, the formatting fills the other, so a large export costs a write per
+// kBufferSize bytes instead of a write per row, and the formatting overlaps the I/O.
+
+namespace utils::output {
+
+inline constexpr size_t kBufferSize = 1 << 20;
+
+/// Writes the results to the file instead of the standard output. Returns false if the file can't be opened.
+bool OpenFile(const std::string &path);
+
+/// The results aren't text, the standard output doesn't translate the line endings (on Windows).
+void SetBinary();
+
+/// Compresses the output in blocks of kBufferSize bytes on workers threads (0 means the number of cores), see
+/// compression.hpp.
+void SetCompression(compression::Type type, size_t workers);
+
+/// True if the results are written to a file given by OpenFile (or to the standard output kept by SeparateConsole).
+bool IsFile();
+
+/// Keeps the standard output for the results, the rest of the text printed there (failures, summaries, ...) goes to
+/// the standard error from now on, so that it doesn't corrupt binary results. Returns false if the descriptors can't be
+/// duplicated.
+bool SeparateConsole();
+
+/// The results are appended here, only from a single thread at a time.
+std::string &Buffer();
+
+/// Called after appending a whole piece of the output (e.g. a row), once there's kBufferSize bytes in the buffer, they
+/// are handed to the writer thread.
+void Commit();
+
+/// Writes everything appended so far and waits until it's written, called at the end of each result so that the
+/// results don't interleave with the rest of the output.
+void Flush();
+
+/// Writes everything and closes the output file. Returns false if any of the output couldn't be written, the first
+/// error is reported on the standard error when it happens.
+bool Close();
+
+}  // namespace utils::output
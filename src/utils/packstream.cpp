@@ -0,0 +1,329 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "packstream.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace utils::packstream {
+
+namespace {
+namespace marker {
+constexpr uint8_t kNull = 0xC0;
+constexpr uint8_t kFloat = 0xC1;
+constexpr uint8_t kFalse = 0xC2;
+constexpr uint8_t kTrue = 0xC3;
+constexpr uint8_t kInt8 = 0xC8;
+constexpr uint8_t kInt16 = 0xC9;
+constexpr uint8_t kInt32 = 0xCA;
+constexpr uint8_t kInt64 = 0xCB;
+constexpr uint8_t kTinyString = 0x80;
+constexpr uint8_t kString8 = 0xD0;
+constexpr uint8_t kTinyList = 0x90;
+constexpr uint8_t kList8 = 0xD4;
+constexpr uint8_t kTinyMap = 0xA0;
+constexpr uint8_t kMap8 = 0xD8;
+constexpr uint8_t kTinyStruct = 0xB0;
+constexpr uint8_t kStruct8 = 0xDC;
+constexpr uint8_t kStruct16 = 0xDD;
+}  // namespace marker
+
+template <class T>
+std::optional<T> ReadBigEndian(std::string_view *data) {
+  if (data->size() < sizeof(T)) {
+    return std::nullopt;
+  }
+  uint64_t value = 0;
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    value = (value << 8) | static_cast<uint8_t>((*data)[i]);
+  }
+  data->remove_prefix(sizeof(T));
+  T result;
+  if constexpr (sizeof(T) == 8) {
+    std::memcpy(&result, &value, sizeof(T));
+  } else {
+    result = static_cast<T>(value);
+  }
+  return result;
+}
+
+/// Size of a string, list or map: the 8, 16 and 32 bit markers of the three follow each other.
+std::optional<uint32_t> ReadSize(uint8_t marker, uint8_t tiny_marker, uint8_t marker8, std::string_view *data) {
+  if ((marker & 0xF0) == tiny_marker) {
+    return marker & 0x0F;
+  }
+  switch (marker - marker8) {
+    case 0:
+      return ReadBigEndian<uint8_t>(data);
+    case 1:
+      return ReadBigEndian<uint16_t>(data);
+    case 2:
+      return ReadBigEndian<uint32_t>(data);
+    default:
+      return std::nullopt;
+  }
+}
+
+std::optional<List> DecodeValues(uint32_t size, std::string_view *data) {
+  List values;
+  // The size comes from the data, don't trust it with the allocation.
+  values.reserve(std::min<size_t>(size, data->size()));
+  for (uint32_t i = 0; i < size; ++i) {
+    auto value = Decode(data);
+    if (!value) {
+      return std::nullopt;
+    }
+    values.push_back(std::move(*value));
+  }
+  return values;
+}
+}  // namespace
+
+const Value *Find(const Map &map, std::string_view key) {
+  for (const auto &[entry_key, value] : map) {
+    if (entry_key == key) {
+      return &value;
+    }
+  }
+  return nullptr;
+}
+
+template <class T>
+void Encoder::WriteBigEndian(T value) {
+  uint64_t bits = 0;
+  if constexpr (sizeof(T) == 8) {
+    std::memcpy(&bits, &value, sizeof(T));
+  } else {
+    bits = static_cast<std::make_unsigned_t<T>>(value);
+  }
+  for (size_t i = sizeof(T); i > 0; --i) {
+    buffer_->push_back(static_cast<char>((bits >> ((i - 1) * 8)) & 0xFF));
+  }
+}
+
+void Encoder::WriteNull() { buffer_->push_back(static_cast<char>(marker::kNull)); }
+
+void Encoder::WriteBool(bool value) { buffer_->push_back(static_cast<char>(value ? marker::kTrue : marker::kFalse)); }
+
+void Encoder::WriteInt(int64_t value) {
+  if (value >= -16 && value <= 127) {
+    buffer_->push_back(static_cast<char>(value));
+  } else if (value >= INT8_MIN && value <= INT8_MAX) {
+    buffer_->push_back(static_cast<char>(marker::kInt8));
+    WriteBigEndian(static_cast<int8_t>(value));
+  } else if (value >= INT16_MIN && value <= INT16_MAX) {
+    buffer_->push_back(static_cast<char>(marker::kInt16));
+    WriteBigEndian(static_cast<int16_t>(value));
+  } else if (value >= INT32_MIN && value <= INT32_MAX) {
+    buffer_->push_back(static_cast<char>(marker::kInt32));
+    WriteBigEndian(static_cast<int32_t>(value));
+  } else {
+    buffer_->push_back(static_cast<char>(marker::kInt64));
+    WriteBigEndian(value);
+  }
+}
+
+void Encoder::WriteFloat(double value) {
+  buffer_->push_back(static_cast<char>(marker::kFloat));
+  WriteBigEndian(value);
+}
+
+void Encoder::WriteSizeHeader(uint8_t tiny_marker, uint8_t marker8, uint32_t size) {
+  if (size < 16) {
+    buffer_->push_back(static_cast<char>(tiny_marker | size));
+  } else if (size <= UINT8_MAX) {
+    buffer_->push_back(static_cast<char>(marker8));
+    WriteBigEndian(static_cast<uint8_t>(size));
+  } else if (size <= UINT16_MAX) {
+    buffer_->push_back(static_cast<char>(marker8 + 1));
+    WriteBigEndian(static_cast<uint16_t>(size));
+  } else {
+    buffer_->push_back(static_cast<char>(marker8 + 2));
+    WriteBigEndian(size);
+  }
+}
+
+void Encoder::WriteString(std::string_view value) {
+  WriteSizeHeader(marker::kTinyString, marker::kString8, value.size());
+  buffer_->append(value);
+}
+
+void Encoder::WriteListHeader(uint32_t size) { WriteSizeHeader(marker::kTinyList, marker::kList8, size); }
+
+void Encoder::WriteMapHeader(uint32_t size) { WriteSizeHeader(marker::kTinyMap, marker::kMap8, size); }
+
+void Encoder::WriteStructHeader(uint8_t signature, uint8_t size) {
+  if (size < 16) {
+    buffer_->push_back(static_cast<char>(marker::kTinyStruct | size));
+  } else {
+    buffer_->push_back(static_cast<char>(marker::kStruct8));
+    buffer_->push_back(static_cast<char>(size));
+  }
+  buffer_->push_back(static_cast<char>(signature));
+}
+
+void Encoder::Write(const Value &value) {
+  std::visit(
+      [this](const auto &data) {
+        using T = std::decay_t<decltype(data)>;
+        if constexpr (std::is_same_v<T, std::nullptr_t>) {
+          WriteNull();
+        } else if constexpr (std::is_same_v<T, bool>) {
+          WriteBool(data);
+        } else if constexpr (std::is_same_v<T, int64_t>) {
+          WriteInt(data);
+        } else if constexpr (std::is_same_v<T, double>) {
+          WriteFloat(data);
+        } else if constexpr (std::is_same_v<T, std::string>) {
+          WriteString(data);
+        } else if constexpr (std::is_same_v<T, List>) {
+          WriteListHeader(data.size());
+          for (const auto &element : data) {
+            Write(element);
+          }
+        } else if constexpr (std::is_same_v<T, Map>) {
+          WriteMapHeader(data.size());
+          for (const auto &[key, element] : data) {
+            WriteString(key);
+            Write(element);
+          }
+        } else {
+          WriteStructHeader(data.signature, data.fields.size());
+          for (const auto &field : data.fields) {
+            Write(field);
+          }
+        }
+      },
+      value.data);
+}
+
+std::optional<Value> Decode(std::string_view *data) {
+  auto marker = ReadBigEndian<uint8_t>(data);
+  if (!marker) {
+    return std::nullopt;
+  }
+  const uint8_t m = *marker;
+  // Tiny ints, [-16, 127].
+  if (m <= 0x7F || m >= 0xF0) {
+    return Value{static_cast<int64_t>(static_cast<int8_t>(m))};
+  }
+  switch (m) {
+    case marker::kNull:
+      return Value{};
+    case marker::kFalse:
+      return Value{false};
+    case marker::kTrue:
+      return Value{true};
+    case marker::kFloat:
+      if (auto value = ReadBigEndian<double>(data)) {
+        return Value{*value};
+      }
+      return std::nullopt;
+    case marker::kInt8:
+      if (auto value = ReadBigEndian<int8_t>(data)) {
+        return Value{static_cast<int64_t>(*value)};
+      }
+      return std::nullopt;
+    case marker::kInt16:
+      if (auto value = ReadBigEndian<int16_t>(data)) {
+        return Value{static_cast<int64_t>(*value)};
+      }
+      return std::nullopt;
+    case marker::kInt32:
+      if (auto value = ReadBigEndian<int32_t>(data)) {
+        return Value{static_cast<int64_t>(*value)};
+      }
+      return std::nullopt;
+    case marker::kInt64:
+      if (auto value = ReadBigEndian<int64_t>(data)) {
+        return Value{*value};
+      }
+      return std::nullopt;
+    default:
+      break;
+  }
+  if ((m & 0xF0) == marker::kTinyString || (m >= marker::kString8 && m <= marker::kString8 + 2)) {
+    auto size = ReadSize(m, marker::kTinyString, marker::kString8, data);
+    if (!size || data->size() < *size) {
+      return std::nullopt;
+    }
+    Value value{std::string(data->substr(0, *size))};
+    data->remove_prefix(*size);
+    return value;
+  }
+  if ((m & 0xF0) == marker::kTinyList || (m >= marker::kList8 && m <= marker::kList8 + 2)) {
+    auto size = ReadSize(m, marker::kTinyList, marker::kList8, data);
+    if (!size) {
+      return std::nullopt;
+    }
+    if (auto values = DecodeValues(*size, data)) {
+      return Value{std::move(*values)};
+    }
+    return std::nullopt;
+  }
+  if ((m & 0xF0) == marker::kTinyMap || (m >= marker::kMap8 && m <= marker::kMap8 + 2)) {
+    auto size = ReadSize(m, marker::kTinyMap, marker::kMap8, data);
+    if (!size) {
+      return std::nullopt;
+    }
+    Map map;
+    for (uint32_t i = 0; i < *size; ++i) {
+      auto key = Decode(data);
+      auto value = key && key->Get<std::string>() ? Decode(data) : std::nullopt;
+      if (!value) {
+        return std::nullopt;
+      }
+      map.emplace_back(std::move(*std::get_if<std::string>(&key->data)), std::move(*value));
+    }
+    return Value{std::move(map)};
+  }
+  if ((m & 0xF0) == marker::kTinyStruct || m == marker::kStruct8 || m == marker::kStruct16) {
+    std::optional<uint32_t> size;
+    if ((m & 0xF0) == marker::kTinyStruct) {
+      size = m & 0x0F;
+    } else if (m == marker::kStruct8) {
+      size = ReadBigEndian<uint8_t>(data);
+    } else {
+      size = ReadBigEndian<uint16_t>(data);
+    }
+    auto signature = ReadBigEndian<uint8_t>(data);
+    if (!size || !signature) {
+      return std::nullopt;
+    }
+    if (auto fields = DecodeValues(*size, data)) {
+      return Value{Structure{.signature = *signature, .fields = std::move(*fields)}};
+    }
+    return std::nullopt;
+  }
+  return std::nullopt;
+}
+
+std::string ChunkMessage(std::string_view message) {
+  std::string chunked;
+  chunked.reserve(message.size() + (message.size() / kMaxChunkSize + 2) * 2);
+  while (!message.empty()) {
+    const auto size = std::min(message.size(), kMaxChunkSize);
+    chunked.push_back(static_cast<char>(size >> 8));
+    chunked.push_back(static_cast<char>(size & 0xFF));
+    chunked.append(message.substr(0, size));
+    message.remove_prefix(size);
+  }
+  chunked.append(2, '\0');
+  return chunked;
+}
+
+}  // namespace utils::packstream
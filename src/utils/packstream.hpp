@@ -0,0 +1,109 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// PackStream (the Bolt serialization format) and the Bolt message framing, only as much of it as the messages
+// exchanged between mgclient and a server need. mgclient has its own codec, this one is for the tools which have to
+// speak Bolt themselves (e.g. the mock server of the import benchmarks).
+namespace utils::packstream {
+
+struct Value;
+using List = std::vector<Value>;
+/// The entries are kept in the order they were encoded in.
+using Map = std::vector<std::pair<std::string, Value>>;
+
+struct Structure {
+  uint8_t signature;
+  List fields;
+};
+
+struct Value {
+  std::variant<std::nullptr_t, bool, int64_t, double, std::string, List, Map, Structure> data{nullptr};
+
+  bool IsNull() const { return std::holds_alternative<std::nullptr_t>(data); }
+  /// nullptr if the value isn't of the type T.
+  template <class T>
+  const T *Get() const {
+    return std::get_if<T>(&data);
+  }
+};
+
+/// nullptr if there is no such key or the map isn't a map.
+const Value *Find(const Map &map, std::string_view key);
+
+/// Appends the encoded values to the buffer.
+class Encoder {
+ public:
+  explicit Encoder(std::string *buffer) : buffer_(buffer) {}
+
+  void WriteNull();
+  void WriteBool(bool value);
+  void WriteInt(int64_t value);
+  void WriteFloat(double value);
+  void WriteString(std::string_view value);
+  /// The header has to be followed by size values (key-value pairs for a map).
+  void WriteListHeader(uint32_t size);
+  void WriteMapHeader(uint32_t size);
+  void WriteStructHeader(uint8_t signature, uint8_t size);
+  void Write(const Value &value);
+
+ private:
+  void WriteSizeHeader(uint8_t tiny_marker, uint8_t marker8, uint32_t size);
+  template <class T>
+  void WriteBigEndian(T value);
+
+  std::string *buffer_;
+};
+
+/// Decodes a value from the front of the data and consumes it, nullopt if the data is malformed or truncated (the
+/// data is left unspecified then).
+std::optional<Value> Decode(std::string_view *data);
+
+// Bolt message signatures (the Bolt 1 names of the same messages in parentheses).
+namespace message {
+constexpr uint8_t kHello = 0x01;  // (INIT)
+constexpr uint8_t kGoodbye = 0x02;
+constexpr uint8_t kAckFailure = 0x0E;
+constexpr uint8_t kReset = 0x0F;
+constexpr uint8_t kRun = 0x10;
+constexpr uint8_t kBegin = 0x11;
+constexpr uint8_t kCommit = 0x12;
+constexpr uint8_t kRollback = 0x13;
+constexpr uint8_t kDiscard = 0x2F;  // (DISCARD_ALL)
+constexpr uint8_t kPull = 0x3F;     // (PULL_ALL)
+constexpr uint8_t kSuccess = 0x70;
+constexpr uint8_t kRecord = 0x71;
+constexpr uint8_t kIgnored = 0x7E;
+constexpr uint8_t kFailure = 0x7F;
+}  // namespace message
+
+/// The first 4 bytes a Bolt client sends, followed by the 4 proposed versions.
+constexpr uint32_t kBoltMagic = 0x6060B017;
+/// Maximum chunk payload, a message is split into chunks, each prefixed by its 2 byte size, and ended by an empty one.
+constexpr size_t kMaxChunkSize = 0xFFFF;
+
+/// Frames a message into chunks.
+std::string ChunkMessage(std::string_view message);
+
+}  // namespace utils::packstream
@@ -0,0 +1,96 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "parallel_format.hpp"
+
+#include <thread>
+
+#include "output.hpp"
+
+namespace format {
+
+ParallelFormatter::ParallelFormatter(FormatChunk format, size_t workers)
+    : format_(std::move(format)),
+      workers_(workers > 0 ? workers : std::max(1U, std::thread::hardware_concurrency())) {}
+
+ParallelFormatter::~ParallelFormatter() {
+  // The chunks in flight can reference the caller's rows.
+  for (auto &future : pending_) {
+    std::move(future).Wait();
+  }
+}
+
+void ParallelFormatter::Add(Rows rows) { Dispatch(rows, nullptr); }
+
+void ParallelFormatter::Add(std::vector<mg_memory::MgListPtr> rows) {
+  auto owned = std::make_shared<std::vector<mg_memory::MgListPtr>>(std::move(rows));
+  Dispatch(Rows(*owned), owned);
+}
+
+void ParallelFormatter::Dispatch(Rows rows, std::shared_ptr<std::vector<mg_memory::MgListPtr>> owned) {
+  if (!pool_) {
+    if (workers_ > 1 && !deferred_) {
+      // Formatted on this thread by Finish if it's the only chunk.
+      deferred_.emplace(rows, std::move(owned));
+      return;
+    }
+    if (workers_ == 1) {
+      format_(utils::output::Buffer(), rows);
+      utils::output::Commit();
+      return;
+    }
+    pool_ = std::make_unique<utils::ThreadPool>(workers_);
+    auto [deferred_rows, deferred_owned] = std::move(*deferred_);
+    deferred_.reset();
+    Dispatch(deferred_rows, std::move(deferred_owned));
+  }
+  auto [future, promise] = utils::FuturePromisePair<std::shared_ptr<Formatted>>();
+  auto shared_promise = std::make_shared<decltype(promise)>(std::move(promise));
+  pool_->AddTask([this, rows, owned = std::move(owned), promise = std::move(shared_promise)]() {
+    auto formatted = std::make_shared<Formatted>();
+    // An exception escaping a pool task terminates the process, it's rethrown on the caller's thread instead.
+    try {
+      format_(formatted->buffer, rows);
+    } catch (...) {
+      formatted->error = std::current_exception();
+    }
+    promise->Fill(std::move(formatted));
+  });
+  pending_.push_back(std::move(future));
+  // Enough chunks to keep the workers busy while the oldest one is written, the rest waits in the fetch.
+  WriteFormatted(2 * workers_);
+}
+
+void ParallelFormatter::WriteFormatted(size_t max_pending) {
+  while (!pending_.empty() && (pending_.size() > max_pending || pending_.front().IsReady())) {
+    auto formatted = std::move(pending_.front()).Wait();
+    pending_.pop_front();
+    if (formatted->error) {
+      std::rethrow_exception(formatted->error);
+    }
+    utils::output::Buffer().append(formatted->buffer);
+    utils::output::Commit();
+  }
+}
+
+void ParallelFormatter::Finish() {
+  if (deferred_) {
+    format_(utils::output::Buffer(), deferred_->first);
+    utils::output::Commit();
+    deferred_.reset();
+  }
+  WriteFormatted(0);
+}
+
+}  // namespace format
@@ -0,0 +1,84 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "future.hpp"
+#include "thread_pool.hpp"
+#include "utils.hpp"
+
+// Large results are formatted in chunks of rows on a worker pool, each chunk into its own buffer, and the buffers are
+// written in the order of the chunks through utils::output. A result of a single chunk is formatted on the calling
+// thread, so small results don't start the pool.
+
+namespace format {
+
+inline constexpr size_t kFormatChunkRows = 1024;
+
+class ParallelFormatter {
+ public:
+  using Rows = std::span<const mg_memory::MgListPtr>;
+  /// Appends the formatted rows to the buffer, called concurrently for different chunks. An exception it throws is
+  /// rethrown by the Add or Finish call which gets to write that chunk.
+  using FormatChunk = std::function<void(std::string &buffer, Rows rows)>;
+
+  /// workers == 0 means the number of cores.
+  ParallelFormatter(FormatChunk format, size_t workers);
+  ParallelFormatter(const ParallelFormatter &) = delete;
+  ParallelFormatter &operator=(const ParallelFormatter &) = delete;
+  ParallelFormatter(ParallelFormatter &&) = delete;
+  ParallelFormatter &operator=(ParallelFormatter &&) = delete;
+  ~ParallelFormatter();
+
+  /// Formats the rows owned by the caller, they have to outlive Finish.
+  void Add(Rows rows);
+  /// Formats the rows owned by the formatter.
+  void Add(std::vector<mg_memory::MgListPtr> rows);
+
+  /// Writes the rest of the chunks, in order.
+  void Finish();
+
+ private:
+  /// A formatted chunk, or what formatting it threw on the worker.
+  struct Formatted {
+    std::string buffer;
+    std::exception_ptr error;
+  };
+
+  void Dispatch(Rows rows, std::shared_ptr<std::vector<mg_memory::MgListPtr>> owned);
+  /// Writes the chunks which are already formatted, and waits for the oldest ones while there are more than
+  /// max_pending.
+  void WriteFormatted(size_t max_pending);
+
+  FormatChunk format_;
+  size_t workers_;
+  /// The first chunk, until the second one comes.
+  std::optional<std::pair<Rows, std::shared_ptr<std::vector<mg_memory::MgListPtr>>>> deferred_;
+  /// Started with the second chunk.
+  std::unique_ptr<utils::ThreadPool> pool_;
+  std::deque<utils::Future<std::shared_ptr<Formatted>>> pending_;
+};
+
+}  // namespace format
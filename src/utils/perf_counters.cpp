@@ -0,0 +1,255 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "perf_counters.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif /* __linux__ */
+
+namespace utils::perf {
+
+namespace {
+
+constexpr std::array<const char *, kPhases> kPhaseNames{"read", "parse", "classify", "fetch", "format"};
+
+struct PhaseTotals {
+  std::atomic<uint64_t> calls{0};
+  std::array<std::atomic<uint64_t>, kCounters> counters{};
+  std::atomic<uint64_t> bytes{0};
+  std::atomic<uint64_t> queries{0};
+};
+
+std::array<PhaseTotals, kPhases> totals;
+/// A counter might be missing on some machines (e.g. cache misses inside a VM), the rest still works.
+std::array<std::atomic<bool>, kCounters> available{};
+
+#ifdef __linux__
+
+constexpr std::array<uint64_t, kCounters> kCounterConfigs{PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                          PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+int OpenCounter(uint64_t config, int group_fd) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = config;
+  attr.read_format = PERF_FORMAT_GROUP;
+  attr.disabled = group_fd == -1 ? 1 : 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  // The calling thread, on any CPU.
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+/// A counter group of the calling thread, the cycles are the leader.
+struct ThreadCounters {
+  ThreadCounters() {
+    leader = OpenCounter(kCounterConfigs[0], -1);
+    if (leader == -1) {
+      return;
+    }
+    slots[0] = 0;
+    int opened = 1;
+    for (size_t i = 1; i < kCounters; ++i) {
+      if (!available[i]) {
+        continue;
+      }
+      const auto fd = OpenCounter(kCounterConfigs[i], leader);
+      if (fd == -1) {
+        continue;
+      }
+      fds[i] = fd;
+      slots[i] = opened++;
+    }
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+  ThreadCounters(const ThreadCounters &) = delete;
+  ThreadCounters &operator=(const ThreadCounters &) = delete;
+  ~ThreadCounters() {
+    for (size_t i = 1; i < kCounters; ++i) {
+      if (fds[i] != -1) {
+        close(fds[i]);
+      }
+    }
+    if (leader != -1) {
+      close(leader);
+    }
+  }
+
+  bool Read(Sample &sample) const {
+    // PERF_FORMAT_GROUP: the number of counters followed by their values, in the order they were opened.
+    std::array<uint64_t, kCounters + 1> values{};
+    if (leader == -1 || read(leader, values.data(), sizeof(values)) <= 0) {
+      return false;
+    }
+    for (size_t i = 0; i < kCounters; ++i) {
+      sample[i] = slots[i] == -1 ? 0 : values[slots[i] + 1];
+    }
+    return true;
+  }
+
+  int leader{-1};
+  std::array<int, kCounters> fds{-1, -1, -1, -1};
+  /// Position of the counter in the group read, -1 if the counter isn't there.
+  std::array<int, kCounters> slots{-1, -1, -1, -1};
+};
+
+ThreadCounters &GetThreadCounters() {
+  thread_local ThreadCounters counters;
+  return counters;
+}
+
+#endif /* __linux__ */
+
+std::string Ratio(double numerator, double denominator) {
+  if (denominator <= 0) {
+    return "n/a";
+  }
+  std::ostringstream os;
+  os << std::setprecision(3) << numerator / denominator;
+  return os.str();
+}
+
+void PrintReport() {
+  static std::atomic<bool> printed{false};
+  if (printed.exchange(true)) {
+    return;
+  }
+  const std::array<const char *, kCounters> counter_names{"cycles", "instructions", "cache misses", "branch misses"};
+  auto &os = std::cerr;
+  os << "Hardware counters (user space):\n";
+  os << std::left << std::setw(10) << "phase" << std::right << std::setw(12) << "calls";
+  for (const auto *name : counter_names) {
+    os << std::setw(16) << name;
+  }
+  os << std::setw(8) << "IPC" << std::setw(14) << "bytes/cycle" << std::setw(14) << "queries/cycle" << '\n';
+  for (size_t phase = 0; phase < kPhases; ++phase) {
+    const auto &phase_totals = totals[phase];
+    if (phase_totals.calls == 0) {
+      continue;
+    }
+    os << std::left << std::setw(10) << kPhaseNames[phase] << std::right << std::setw(12) << phase_totals.calls;
+    for (size_t i = 0; i < kCounters; ++i) {
+      if (available[i]) {
+        os << std::setw(16) << phase_totals.counters[i];
+      } else {
+        os << std::setw(16) << "n/a";
+      }
+    }
+    const auto cycles = static_cast<double>(phase_totals.counters[0]);
+    const auto instructions = available[1] ? static_cast<double>(phase_totals.counters[1]) : 0.0;
+    os << std::setw(8) << Ratio(instructions, available[1] ? cycles : 0.0);
+    os << std::setw(14) << (phase_totals.bytes > 0 ? Ratio(static_cast<double>(phase_totals.bytes), cycles) : "-");
+    os << std::setw(14)
+       << (phase_totals.queries > 0 ? Ratio(static_cast<double>(phase_totals.queries), cycles) : "-") << '\n';
+  }
+  os << std::flush;
+}
+
+}  // namespace
+
+bool Enable() {
+#ifdef __linux__
+  for (auto &counter : available) {
+    counter = true;
+  }
+  // Probe on this thread, the counters of the other threads are opened on their first phase.
+  const auto leader = OpenCounter(kCounterConfigs[0], -1);
+  if (leader == -1) {
+    std::cerr << "Hardware counters are unavailable (perf_event_open: " << std::strerror(errno)
+              << "), --profile-counters is ignored" << std::endl;
+    return false;
+  }
+  for (size_t i = 1; i < kCounters; ++i) {
+    const auto fd = OpenCounter(kCounterConfigs[i], leader);
+    if (fd == -1) {
+      available[i] = false;
+    } else {
+      close(fd);
+    }
+  }
+  close(leader);
+  enabled = true;
+  // SIGINT/SIGTERM end the process with quick_exit, which doesn't run the atexit handlers.
+  std::atexit(PrintReport);
+  std::at_quick_exit(PrintReport);
+  return true;
+#else
+  std::cerr << "Hardware counters are only supported on Linux, --profile-counters is ignored" << std::endl;
+  return false;
+#endif /* __linux__ */
+}
+
+void AddBytes(Phase phase, uint64_t bytes) {
+  if (IsEnabled()) [[unlikely]] {
+    totals[static_cast<size_t>(phase)].bytes += bytes;
+  }
+}
+
+void AddQueries(Phase phase, uint64_t queries) {
+  if (IsEnabled()) [[unlikely]] {
+    totals[static_cast<size_t>(phase)].queries += queries;
+  }
+}
+
+bool Begin(Sample &sample) {
+#ifdef __linux__
+  return GetThreadCounters().Read(sample);
+#else
+  (void)sample;
+  return false;
+#endif /* __linux__ */
+}
+
+bool Next(Phase phase, Sample &sample) {
+#ifdef __linux__
+  Sample end;
+  if (!GetThreadCounters().Read(end)) {
+    return false;
+  }
+  auto &phase_totals = totals[static_cast<size_t>(phase)];
+  phase_totals.calls++;
+  for (size_t i = 0; i < kCounters; ++i) {
+    phase_totals.counters[i] += end[i] - sample[i];
+  }
+  sample = end;
+  return true;
+#else
+  (void)phase;
+  (void)sample;
+  return false;
+#endif /* __linux__ */
+}
+
+void End(Phase phase, const Sample &begin) {
+  auto sample = begin;
+  Next(phase, sample);
+}
+
+}  // namespace utils::perf
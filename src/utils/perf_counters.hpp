@@ -0,0 +1,94 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Hardware counters (cycles, instructions, cache misses, branch misses) read through perf_event_open around the client
+// phases, so that a client-bound import shows where the cycles go. Linux only. The counters are per thread (user space
+// only, which works with the default perf_event_paranoid), each phase is read at its start and its end, which costs a
+// syscall, so the phases are whole calls (a line parsed, a query classified, ...) and not something like NextState.
+
+namespace utils::perf {
+
+enum class Phase : uint8_t {
+  /// Reading a line of the input.
+  READ,
+  /// ParseLine, including the clause detection (NextState).
+  PARSE,
+  /// Extracting the keys / labels of a query in the batched import.
+  CLASSIFY,
+  /// Fetching the records, mg_session_fetch + mg_list_copy.
+  FETCH,
+  /// Formatting the results.
+  FORMAT,
+};
+inline constexpr size_t kPhases = 5;
+inline constexpr size_t kCounters = 4;
+using Sample = std::array<uint64_t, kCounters>;
+
+inline std::atomic<bool> enabled{false};
+
+inline bool IsEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+/// Starts counting if the counters are available (otherwise says why and returns false), the per-phase table is
+/// printed to stderr at exit.
+bool Enable();
+
+/// Bytes / queries processed by the phase, for the per-cycle figures.
+void AddBytes(Phase phase, uint64_t bytes);
+void AddQueries(Phase phase, uint64_t queries);
+
+bool Begin(Sample &sample);
+void End(Phase phase, const Sample &begin);
+/// Ends the phase and begins the next one with the same reading, sample becomes the begin of the next one.
+bool Next(Phase phase, Sample &sample);
+
+/// Counts the scope as the phase.
+class Scope {
+ public:
+  explicit Scope(Phase phase) : phase_(phase) {
+    if (IsEnabled()) [[unlikely]] {
+      active_ = Begin(begin_);
+    }
+  }
+  Scope(const Scope &) = delete;
+  Scope &operator=(const Scope &) = delete;
+  Scope(Scope &&) = delete;
+  Scope &operator=(Scope &&) = delete;
+  ~Scope() {
+    if (active_) [[unlikely]] {
+      End(phase_, begin_);
+    }
+  }
+
+  /// Counts the rest of the scope as the phase, e.g. the formatting of a streamed record during the fetching.
+  void Switch(Phase phase) {
+    if (active_) [[unlikely]] {
+      active_ = Next(phase_, begin_);
+    }
+    phase_ = phase;
+  }
+
+ private:
+  Phase phase_;
+  bool active_{false};
+  Sample begin_;
+};
+
+}  // namespace utils::perf
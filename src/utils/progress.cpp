@@ -0,0 +1,195 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "progress.hpp"
+
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include <sys/stat.h>
+
+namespace utils {
+
+namespace {
+
+std::optional<uint64_t> InputSize() {
+  struct stat input;
+  if (fstat(fileno(stdin), &input) != 0 || !S_ISREG(input.st_mode)) {
+    return std::nullopt;
+  }
+  return static_cast<uint64_t>(input.st_size);
+}
+
+double Seconds(int64_t ns) { return static_cast<double>(ns) / 1e9; }
+
+double MiB(uint64_t bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); }
+
+std::string FormatDuration(double seconds) {
+  auto total = static_cast<int64_t>(seconds);
+  std::ostringstream os;
+  os << total / 3600 << ':' << std::setfill('0') << std::setw(2) << total / 60 % 60 << ':' << std::setw(2)
+     << total % 60;
+  return os.str();
+}
+
+}  // namespace
+
+Progress::~Progress() {
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    stop_ = true;
+  }
+  stop_cv_.notify_all();
+  if (reporter_.joinable()) {
+    reporter_.join();
+  }
+}
+
+void Progress::Start(const ProgressConfig &config) {
+  config_ = config;
+  start_ = std::chrono::steady_clock::now();
+  input_size_ = InputSize();
+  tty_ = console::is_a_tty(fileno(stderr));
+  if (!config_.enabled) {
+    return;
+  }
+  reporter_ = std::thread([this]() {
+    std::unique_lock<std::mutex> guard(lock_);
+    while (!stop_cv_.wait_for(guard, config_.interval, [this]() { return stop_; })) {
+      guard.unlock();
+      Report(false);
+      guard.lock();
+    }
+  });
+}
+
+void Progress::Finish() {
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    stop_ = true;
+  }
+  stop_cv_.notify_all();
+  if (reporter_.joinable()) {
+    reporter_.join();
+  }
+  if (config_.enabled) {
+    Report(true);
+  }
+}
+
+void Progress::Read(const query::Query &query, std::chrono::nanoseconds parse_time) {
+  // A resumed import doesn't start at the beginning of the input.
+  if (first_read_.exchange(false)) {
+    start_offset_ = query.begin_offset;
+  }
+  offset_ = query.end_offset;
+  queries_read_++;
+  parse_ns_ += parse_time.count();
+}
+
+void Progress::Commit(uint64_t queries, uint64_t nodes_created, uint64_t relationships_created) {
+  queries_committed_ += queries;
+  nodes_created_ += nodes_created;
+  relationships_created_ += relationships_created;
+}
+
+void Progress::Commit(const std::optional<std::map<std::string, std::int64_t>> &stats) {
+  uint64_t nodes = 0;
+  uint64_t relationships = 0;
+  if (stats) {
+    if (auto it = stats->find("nodes-created"); it != stats->end()) {
+      nodes = it->second;
+    }
+    if (auto it = stats->find("relationships-created"); it != stats->end()) {
+      relationships = it->second;
+    }
+  }
+  Commit(1, nodes, relationships);
+}
+
+void Progress::Report(bool final) {
+  const auto now = std::chrono::steady_clock::now();
+  const auto elapsed = std::chrono::duration<double>(now - start_).count();
+  const auto offset = offset_.load();
+  const auto read_bytes = offset - std::min(start_offset_.load(), offset);
+  const auto committed = queries_committed_.load();
+
+  samples_.push_back(Sample{.time = now, .committed = committed});
+  while (samples_.size() > 2 && now - samples_[1].time >= kRateWindow) {
+    samples_.pop_front();
+  }
+  double rate = 0.0;
+  if (final) {
+    rate = elapsed > 0 ? static_cast<double>(committed) / elapsed : 0.0;
+  } else if (samples_.size() > 1) {
+    const auto window = std::chrono::duration<double>(now - samples_.front().time).count();
+    rate = window > 0 ? static_cast<double>(committed - samples_.front().committed) / window : 0.0;
+  }
+  std::optional<double> eta;
+  if (!final && input_size_ && read_bytes > 0 && *input_size_ >= offset) {
+    eta = elapsed * static_cast<double>(*input_size_ - offset) / static_cast<double>(read_bytes);
+  }
+
+  if (final) {
+    if (tty_) {
+      std::cerr << "\r\033[K";
+    }
+    std::cerr << "Import: " << queries_read_.load() << " queries read (" << MiB(read_bytes) << " MiB), " << committed
+              << " committed in " << elapsed << " s (" << rate << " queries/s), " << nodes_created_.load()
+              << " nodes and " << relationships_created_.load() << " relationships created" << std::endl;
+    std::cerr << "Client time: parse " << Seconds(parse_ns_.load()) << " s, wait " << Seconds(wait_ns_.load())
+              << " s, format " << Seconds(format_ns_.load()) << " s" << std::endl;
+    return;
+  }
+
+  std::ostringstream os;
+  if (tty_) {
+    // Kept short, a wrapped status line can't be overwritten.
+    os << std::fixed << std::setprecision(1) << '\r' << MiB(read_bytes);
+    if (input_size_) {
+      os << '/' << MiB(*input_size_) << " MiB ("
+         << (*input_size_ > 0 ? 100.0 * static_cast<double>(offset) / static_cast<double>(*input_size_) : 100.0)
+         << "%)";
+    } else {
+      os << " MiB";
+    }
+    os << std::setprecision(0) << " | " << committed << '/' << queries_read_.load() << " queries, " << rate
+       << " q/s | +" << nodes_created_.load() << " nodes, +" << relationships_created_.load() << " rels | "
+       << in_flight.load() << " in flight, " << retries.load() << " retries, " << aborts.load() << " aborts";
+    if (eta) {
+      os << " | ETA " << FormatDuration(*eta);
+    }
+    os << "\033[K";
+    std::cerr << os.str() << std::flush;
+    return;
+  }
+  os << "{\"elapsed_s\":" << elapsed << ",\"bytes\":" << read_bytes;
+  if (input_size_) {
+    os << ",\"input_bytes\":" << *input_size_;
+  }
+  os << ",\"queries_read\":" << queries_read_.load() << ",\"queries_committed\":" << committed
+     << ",\"queries_per_s\":" << rate << ",\"nodes_created\":" << nodes_created_.load()
+     << ",\"relationships_created\":" << relationships_created_.load() << ",\"batches_in_flight\":" << in_flight.load()
+     << ",\"retries\":" << retries.load() << ",\"aborts\":" << aborts.load() << ",\"rejected\":" << rejected.load();
+  if (eta) {
+    os << ",\"eta_s\":" << *eta;
+  }
+  os << "}\n";
+  std::cerr << os.str() << std::flush;
+}
+
+}  // namespace utils
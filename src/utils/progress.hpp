@@ -0,0 +1,107 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "utils.hpp"
+
+namespace utils {
+
+struct ProgressConfig {
+  /// Report the progress while importing + the summary at the end.
+  bool enabled{false};
+  std::chrono::milliseconds interval{1000};
+};
+
+/// Import telemetry. The counters are always collected (the batched import prints some of them at the end), the
+/// periodic report is rendered only if enabled: as a status line if stderr is a terminal, otherwise as JSON lines.
+class Progress {
+ public:
+  /// The queries/s figure is computed over this window.
+  static constexpr std::chrono::seconds kRateWindow{10};
+
+  Progress() = default;
+  Progress(const Progress &) = delete;
+  Progress &operator=(const Progress &) = delete;
+  Progress(Progress &&) = delete;
+  Progress &operator=(Progress &&) = delete;
+  ~Progress();
+
+  /// Starts the clock and, if enabled, the reporting thread. The input size (for the ETA) is known if stdin is a file.
+  void Start(const ProgressConfig &config);
+  /// Stops the reporting and, if enabled, prints the summary.
+  void Finish();
+
+  /// A query read by the import, parse_time is how long it took to read and parse it.
+  void Read(const query::Query &query, std::chrono::nanoseconds parse_time);
+  void Commit(uint64_t queries, uint64_t nodes_created, uint64_t relationships_created);
+  /// A query committed on its own, the created nodes / relationships come from the stats of the query.
+  void Commit(const std::optional<std::map<std::string, std::int64_t>> &stats);
+  /// Time spent waiting for the database.
+  void AddWait(std::chrono::nanoseconds duration) { wait_ns_ += duration.count(); }
+  /// Time spent formatting the results.
+  void AddFormat(std::chrono::nanoseconds duration) { format_ns_ += duration.count(); }
+
+  /// Batches being executed right now.
+  std::atomic<uint64_t> in_flight{0};
+  /// Batch executions (including the retried ones), the retried ones and the rolled back ones.
+  std::atomic<uint64_t> attempts{0};
+  std::atomic<uint64_t> retries{0};
+  std::atomic<uint64_t> aborts{0};
+  std::atomic<uint64_t> rejected{0};
+
+ private:
+  struct Sample {
+    std::chrono::steady_clock::time_point time;
+    uint64_t committed;
+  };
+
+  void Report(bool final);
+
+  ProgressConfig config_;
+  std::chrono::steady_clock::time_point start_;
+  std::optional<uint64_t> input_size_;
+  bool tty_{false};
+  std::atomic<bool> first_read_{true};
+  std::atomic<uint64_t> start_offset_{0};
+  std::atomic<uint64_t> offset_{0};
+  std::atomic<uint64_t> queries_read_{0};
+  std::atomic<uint64_t> queries_committed_{0};
+  std::atomic<uint64_t> nodes_created_{0};
+  std::atomic<uint64_t> relationships_created_{0};
+  std::atomic<int64_t> parse_ns_{0};
+  std::atomic<int64_t> wait_ns_{0};
+  std::atomic<int64_t> format_ns_{0};
+  /// Only touched by the reporting thread (and by Finish once it's gone).
+  std::deque<Sample> samples_;
+
+  std::mutex lock_;
+  std::condition_variable stop_cv_;
+  bool stop_{false};
+  std::thread reporter_;
+};
+
+}  // namespace utils
@@ -0,0 +1,769 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "query_keys.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <optional>
+
+namespace query::keys {
+
+using namespace std::string_literals;
+
+namespace {
+
+enum class TokenType { IDENTIFIER, STRING, NUMBER, PARAMETER, PUNCT, END };
+
+struct Token {
+  TokenType type{TokenType::END};
+  std::string_view text;
+};
+
+inline bool IsIdentifierChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || static_cast<unsigned char>(c) >= 0x80;
+}
+
+class Lexer {
+ public:
+  explicit Lexer(std::string_view query) : query_(query) {}
+
+  Token Next() {
+    SkipWhitespaceAndComments();
+    if (pos_ >= query_.size()) {
+      return Token{.type = TokenType::END, .text = {}};
+    }
+    const auto begin = pos_;
+    const char c = query_[pos_];
+    if (c == '`') {
+      auto end = query_.find('`', pos_ + 1);
+      if (end == std::string_view::npos) end = query_.size();
+      pos_ = std::min(end + 1, query_.size());
+      return Token{.type = TokenType::IDENTIFIER, .text = query_.substr(begin + 1, end - begin - 1)};
+    }
+    if (c == '\'' || c == '"') {
+      ++pos_;
+      bool escaped = false;
+      while (pos_ < query_.size()) {
+        if (escaped) {
+          escaped = false;
+        } else if (query_[pos_] == '\\') {
+          escaped = true;
+        } else if (query_[pos_] == c) {
+          break;
+        }
+        ++pos_;
+      }
+      auto end = pos_;
+      pos_ = std::min(pos_ + 1, query_.size());
+      return Token{.type = TokenType::STRING, .text = query_.substr(begin + 1, end - begin - 1)};
+    }
+    if (std::isdigit(static_cast<unsigned char>(c))) {
+      while (pos_ < query_.size()) {
+        const char n = query_[pos_];
+        if (IsIdentifierChar(n) || n == '.') {
+          ++pos_;
+        } else if ((n == '-' || n == '+') && (query_[pos_ - 1] == 'e' || query_[pos_ - 1] == 'E')) {
+          ++pos_;
+        } else {
+          break;
+        }
+      }
+      return Token{.type = TokenType::NUMBER, .text = query_.substr(begin, pos_ - begin)};
+    }
+    if (c == '$' || IsIdentifierChar(c)) {
+      ++pos_;
+      while (pos_ < query_.size() && IsIdentifierChar(query_[pos_])) {
+        ++pos_;
+      }
+      return Token{.type = c == '$' ? TokenType::PARAMETER : TokenType::IDENTIFIER,
+                   .text = query_.substr(begin, pos_ - begin)};
+    }
+    if (pos_ + 1 < query_.size()) {
+      auto two = query_.substr(pos_, 2);
+      if (two == "->" || two == "<-") {
+        pos_ += 2;
+        return Token{.type = TokenType::PUNCT, .text = two};
+      }
+    }
+    ++pos_;
+    return Token{.type = TokenType::PUNCT, .text = query_.substr(begin, 1)};
+  }
+
+ private:
+  void SkipWhitespaceAndComments() {
+    while (pos_ < query_.size()) {
+      if (std::isspace(static_cast<unsigned char>(query_[pos_]))) {
+        ++pos_;
+      } else if (query_.substr(pos_, 2) == "//") {
+        auto end = query_.find('\n', pos_);
+        pos_ = end == std::string_view::npos ? query_.size() : end + 1;
+      } else if (query_.substr(pos_, 2) == "/*") {
+        auto end = query_.find("*/", pos_ + 2);
+        pos_ = end == std::string_view::npos ? query_.size() : end + 2;
+      } else {
+        break;
+      }
+    }
+  }
+
+  std::string_view query_;
+  size_t pos_{0};
+};
+
+inline bool IsKeyword(const Token &token, std::string_view keyword) {
+  if (token.type != TokenType::IDENTIFIER || token.text.size() != keyword.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < keyword.size(); ++i) {
+    if (std::toupper(static_cast<unsigned char>(token.text[i])) != keyword[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+constexpr std::array kClauseKeywords{"MATCH",  "OPTIONAL", "CREATE", "MERGE", "WHERE",   "WITH",  "RETURN",
+                                     "SET",    "DELETE",   "DETACH", "REMOVE", "UNWIND", "ON",    "FOREACH",
+                                     "CALL",   "ORDER",    "SKIP",   "LIMIT", "UNION",   "YIELD", "USING"};
+
+inline bool IsClauseKeyword(const Token &token) {
+  return std::any_of(kClauseKeywords.begin(), kClauseKeywords.end(),
+                     [&token](std::string_view keyword) { return IsKeyword(token, keyword); });
+}
+
+inline bool IsPunct(const Token &token, std::string_view punct) {
+  return token.type == TokenType::PUNCT && token.text == punct;
+}
+
+enum class ClauseKind { NONE, MATCH, CREATE, MERGE, OTHER };
+
+void AppendUtf8(std::string &out, uint32_t code_point) {
+  if (code_point < 0x80) {
+    out += static_cast<char>(code_point);
+  } else if (code_point < 0x800) {
+    out += static_cast<char>(0xC0 | (code_point >> 6));
+    out += static_cast<char>(0x80 | (code_point & 0x3F));
+  } else if (code_point < 0x10000) {
+    out += static_cast<char>(0xE0 | (code_point >> 12));
+    out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (code_point & 0x3F));
+  } else {
+    out += static_cast<char>(0xF0 | (code_point >> 18));
+    out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+    out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (code_point & 0x3F));
+  }
+}
+
+/// The value of a string literal (without the quotes), nullopt if it has an escape sequence that isn't understood.
+std::optional<std::string> UnescapeString(std::string_view text) {
+  if (text.find('\\') == std::string_view::npos) {
+    return std::string(text);
+  }
+  std::string value;
+  value.reserve(text.size());
+  for (size_t i = 0; i < text.size(); ++i) {
+    if (text[i] != '\\') {
+      value += text[i];
+      continue;
+    }
+    if (++i == text.size()) {
+      return std::nullopt;
+    }
+    switch (text[i]) {
+      case '\\':
+      case '\'':
+      case '"':
+        value += text[i];
+        break;
+      case 'b':
+        value += '\b';
+        break;
+      case 'f':
+        value += '\f';
+        break;
+      case 'n':
+        value += '\n';
+        break;
+      case 'r':
+        value += '\r';
+        break;
+      case 't':
+        value += '\t';
+        break;
+      case 'u':
+      case 'U': {
+        const size_t digits = text[i] == 'u' ? 4 : 8;
+        if (i + digits >= text.size()) {
+          return std::nullopt;
+        }
+        uint32_t code_point = 0;
+        auto [end, ec] = std::from_chars(text.data() + i + 1, text.data() + i + 1 + digits, code_point, 16);
+        if (ec != std::errc() || end != text.data() + i + 1 + digits || code_point > 0x10FFFF ||
+            (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+          return std::nullopt;
+        }
+        AppendUtf8(value, code_point);
+        i += digits;
+        break;
+      }
+      default:
+        return std::nullopt;
+    }
+  }
+  return value;
+}
+
+/// Integers and floats with an integral value are written as integers (1, 1.0, 1e0 and 0x1 are all "n:1"), other
+/// floats in the shortest form that reads back the same. Nullopt if the number can't be read exactly.
+std::optional<std::string> NormalizeNumber(std::string_view text, bool negative) {
+  const auto sign = negative ? "-"s : ""s;
+  int base = 10;
+  if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+    base = 16;
+  } else if (text.size() > 2 && text[0] == '0' && (text[1] == 'o' || text[1] == 'O')) {
+    base = 8;
+  }
+  if (base != 10 || text.find_first_not_of("0123456789") == std::string_view::npos) {
+    if (base == 10 && text.size() > 1 && text[0] == '0') {
+      // Might be an octal literal.
+      return std::nullopt;
+    }
+    const auto digits = base == 10 ? text : text.substr(2);
+    const auto number = sign + std::string(digits);
+    int64_t value = 0;
+    auto [end, ec] = std::from_chars(number.data(), number.data() + number.size(), value, base);
+    if (ec != std::errc() || end != number.data() + number.size()) {
+      return std::nullopt;
+    }
+    return "n:" + std::to_string(value);
+  }
+  const auto number = sign + std::string(text);
+  char *end = nullptr;
+  const double value = std::strtod(number.c_str(), &end);
+  if (end != number.c_str() + number.size() || !std::isfinite(value)) {
+    return std::nullopt;
+  }
+  // Exactly representable as int64_t, i.e. in [-2^63, 2^63).
+  if (value == std::trunc(value) && value >= -0x1p63 && value < 0x1p63) {
+    return "n:" + std::to_string(static_cast<int64_t>(value));
+  }
+  std::array<char, 32> buffer;
+  auto [ptr, ec] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+  if (ec != std::errc()) {
+    return std::nullopt;
+  }
+  return "n:" + std::string(buffer.data(), ptr);
+}
+
+inline bool IsSideEffectKeyword(const Token &token) {
+  return IsKeyword(token, "SET") || IsKeyword(token, "DELETE") || IsKeyword(token, "REMOVE") ||
+         IsKeyword(token, "FOREACH") || IsKeyword(token, "CALL");
+}
+
+class PatternParser {
+ public:
+  PatternParser(std::string_view query, std::string_view merge_key_property)
+      : lexer_(query), merge_key_property_(merge_key_property) {
+    Advance();
+  }
+
+  QueryKeys Parse() {
+    while (current_.type != TokenType::END) {
+      if (IsKeyword(current_, "MATCH")) {
+        Advance();
+        ParsePatterns(ClauseKind::MATCH);
+      } else if (IsKeyword(current_, "MERGE")) {
+        Advance();
+        ParsePatterns(ClauseKind::MERGE);
+      } else if (IsKeyword(current_, "CREATE")) {
+        Advance();
+        ParsePatterns(ClauseKind::CREATE);
+      } else if (IsKeyword(current_, "WHERE") && clause_ == ClauseKind::MATCH) {
+        Advance();
+        ParseWhere();
+      } else if (IsKeyword(current_, "ON") && clause_ == ClauseKind::MERGE) {
+        // ON CREATE SET / ON MATCH SET only touch the merged pattern.
+        Advance();
+        if (IsKeyword(current_, "CREATE") || IsKeyword(current_, "MATCH")) {
+          Advance();
+        }
+        if (IsKeyword(current_, "SET")) {
+          Advance();
+          while (!AtClauseEnd()) {
+            Advance();
+          }
+        }
+      } else if (IsSideEffectKeyword(current_)) {
+        has_side_effects_ = true;
+        clause_ = ClauseKind::OTHER;
+        Advance();
+      } else if (IsKeyword(current_, "INDEX")) {
+        // DROP INDEX ON :Label(property)
+        ParseIndex();
+      } else if (IsClauseKeyword(current_) && !IsKeyword(current_, "OPTIONAL")) {
+        clause_ = ClauseKind::OTHER;
+        Advance();
+      } else {
+        Advance();
+      }
+    }
+    return BuildKeys();
+  }
+
+ private:
+  void Advance() { current_ = lexer_.Next(); }
+
+  bool AtClauseEnd() const {
+    return current_.type == TokenType::END || IsPunct(current_, ";") || IsClauseKeyword(current_);
+  }
+
+  void ParsePatterns(ClauseKind kind) {
+    clause_ = kind;
+    while (!AtClauseEnd()) {
+      if (kind == ClauseKind::CREATE && IsKeyword(current_, "INDEX")) {
+        ParseIndex();
+        return;
+      }
+      if (IsPunct(current_, "(")) {
+        ParseNode(NodesOf(kind));
+      } else if (IsPunct(current_, "[") && kind == ClauseKind::MERGE) {
+        ParseRelationship();
+      } else if (IsPunct(current_, "[")) {
+        SkipBalanced("[", "]");
+      } else {
+        Advance();
+      }
+    }
+  }
+
+  std::vector<NodePattern> &NodesOf(ClauseKind kind) {
+    switch (kind) {
+      case ClauseKind::MERGE:
+        return merge_nodes_;
+      case ClauseKind::CREATE:
+        return create_nodes_;
+      default:
+        return match_nodes_;
+    }
+  }
+
+  static NodePattern &NodeFor(std::vector<NodePattern> &nodes, const std::string &variable) {
+    if (!variable.empty()) {
+      for (auto &node : nodes) {
+        if (node.variable == variable) {
+          return node;
+        }
+      }
+    }
+    return nodes.emplace_back(NodePattern{.variable = variable, .labels = {}, .properties = {}});
+  }
+
+  static const NodePattern *FindNode(const std::vector<NodePattern> &nodes, const std::string &variable) {
+    if (variable.empty()) return nullptr;
+    for (const auto &node : nodes) {
+      if (node.variable == variable) {
+        return &node;
+      }
+    }
+    return nullptr;
+  }
+
+  const NodePattern *FindMatchNode(const std::string &variable) const { return FindNode(match_nodes_, variable); }
+
+  // Takes everything up to the end of the statement, the first `:Name` is the label (or the edge type).
+  void ParseIndex() {
+    Advance();  // INDEX
+    while (current_.type != TokenType::END && !IsPunct(current_, ";")) {
+      if (IsPunct(current_, ":")) {
+        Advance();
+        if (current_.type == TokenType::IDENTIFIER) {
+          index_labels_.emplace_back(current_.text);
+        }
+        return;
+      }
+      Advance();
+    }
+  }
+
+  void ParseNode(std::vector<NodePattern> &nodes) {
+    Advance();  // (
+    std::string variable;
+    if (current_.type == TokenType::IDENTIFIER) {
+      variable = std::string(current_.text);
+      Advance();
+    }
+    auto &node = NodeFor(nodes, variable);
+    while (IsPunct(current_, ":")) {
+      Advance();
+      if (current_.type == TokenType::IDENTIFIER) {
+        node.labels.emplace_back(current_.text);
+        Advance();
+      }
+    }
+    if (IsPunct(current_, "{")) {
+      ParseProperties(node);
+    }
+    // Whatever is left (e.g. a parameter map) can't be keyed.
+    if (!IsPunct(current_, ")")) {
+      node.complete = false;
+    }
+    int depth = 1;
+    while (current_.type != TokenType::END && depth > 0) {
+      if (IsPunct(current_, "(")) {
+        ++depth;
+      } else if (IsPunct(current_, ")")) {
+        --depth;
+      }
+      Advance();
+    }
+  }
+
+  void ParseRelationship() {
+    merge_has_relationship_ = true;
+    Advance();  // [
+    if (current_.type == TokenType::IDENTIFIER) {
+      Advance();
+    }
+    if (IsPunct(current_, ":")) {
+      Advance();
+      if (current_.type == TokenType::IDENTIFIER) {
+        merge_relationship_types_.emplace_back(current_.text);
+      }
+    }
+    SkipBalanced("[", "]", /* already_open = */ true);
+  }
+
+  // Returns the normalized literal if the current token (or two in case of a negative number) is a simple literal.
+  // Equal values are normalized to the same text, e.g. 'a' and "a", or 1, 1.0 and 0x1.
+  std::optional<std::string> ParseLiteral() {
+    if (current_.type == TokenType::STRING) {
+      auto value = UnescapeString(current_.text);
+      Advance();
+      if (!value) return std::nullopt;
+      return "s:" + *value;
+    }
+    if (current_.type == TokenType::NUMBER) {
+      auto value = NormalizeNumber(current_.text, false);
+      Advance();
+      return value;
+    }
+    if (IsPunct(current_, "-")) {
+      Advance();
+      if (current_.type == TokenType::NUMBER) {
+        auto value = NormalizeNumber(current_.text, true);
+        Advance();
+        return value;
+      }
+      return std::nullopt;
+    }
+    if (IsKeyword(current_, "TRUE") || IsKeyword(current_, "FALSE")) {
+      auto value = IsKeyword(current_, "TRUE") ? "b:true"s : "b:false"s;
+      Advance();
+      return value;
+    }
+    return std::nullopt;
+  }
+
+  void ParseProperties(NodePattern &node) {
+    Advance();  // {
+    while (current_.type != TokenType::END && !IsPunct(current_, "}")) {
+      if (current_.type != TokenType::IDENTIFIER && current_.type != TokenType::STRING) {
+        node.complete = false;
+        break;
+      }
+      std::string property(current_.text);
+      Advance();
+      if (!IsPunct(current_, ":")) {
+        node.complete = false;
+        break;
+      }
+      Advance();
+      auto value = ParseLiteral();
+      if (value && (IsPunct(current_, ",") || IsPunct(current_, "}"))) {
+        node.properties.emplace_back(std::move(property), std::move(*value));
+      } else {
+        node.complete = false;
+        SkipExpression();
+      }
+      if (IsPunct(current_, ",")) {
+        Advance();
+      }
+    }
+    SkipBalanced("{", "}", /* already_open = */ true);
+  }
+
+  // Skips until ',' or '}' on the current nesting level.
+  void SkipExpression() {
+    int depth = 0;
+    while (current_.type != TokenType::END) {
+      if (IsPunct(current_, "(") || IsPunct(current_, "[") || IsPunct(current_, "{")) {
+        ++depth;
+      } else if (IsPunct(current_, ")") || IsPunct(current_, "]") || IsPunct(current_, "}")) {
+        if (depth == 0) return;
+        --depth;
+      } else if (IsPunct(current_, ",") && depth == 0) {
+        return;
+      }
+      Advance();
+    }
+  }
+
+  void SkipBalanced(std::string_view open, std::string_view close, bool already_open = false) {
+    int depth = already_open ? 1 : 0;
+    if (!already_open) {
+      if (!IsPunct(current_, open)) return;
+      depth = 1;
+      Advance();
+    }
+    while (current_.type != TokenType::END && depth > 0) {
+      if (IsPunct(current_, open)) {
+        ++depth;
+      } else if (IsPunct(current_, close)) {
+        --depth;
+      }
+      Advance();
+    }
+  }
+
+  // Only conjunctions of `var.prop = literal` are understood, anything else makes the WHERE equalities unreliable.
+  void ParseWhere() {
+    struct Equality {
+      std::string variable;
+      std::string property;
+      std::string value;
+    };
+    std::vector<Equality> equalities;
+    bool reliable = true;
+    while (!AtClauseEnd()) {
+      if (IsKeyword(current_, "OR") || IsKeyword(current_, "XOR") || IsKeyword(current_, "NOT")) {
+        reliable = false;
+        Advance();
+        continue;
+      }
+      if (current_.type != TokenType::IDENTIFIER) {
+        Advance();
+        continue;
+      }
+      std::string variable(current_.text);
+      Advance();
+      if (!IsPunct(current_, ".")) continue;
+      Advance();
+      if (current_.type != TokenType::IDENTIFIER) continue;
+      std::string property(current_.text);
+      Advance();
+      if (!IsPunct(current_, "=")) continue;
+      Advance();
+      if (auto value = ParseLiteral(); value) {
+        equalities.push_back(
+            Equality{.variable = std::move(variable), .property = std::move(property), .value = *value});
+      }
+    }
+    if (!reliable) return;
+    for (auto &equality : equalities) {
+      for (auto &node : match_nodes_) {
+        if (node.variable == equality.variable) {
+          node.properties.emplace_back(std::move(equality.property), std::move(equality.value));
+          break;
+        }
+      }
+    }
+  }
+
+  static void AppendKeys(const NodePattern &node, std::vector<Key> &keys) {
+    for (const auto &[property, value] : node.properties) {
+      if (node.labels.empty()) {
+        keys.push_back(MakeKey("", property, value));
+      }
+      for (const auto &label : node.labels) {
+        keys.push_back(MakeKey(label, property, value));
+      }
+    }
+  }
+
+  template <typename T>
+  static void SortUnique(std::vector<T> &values) {
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+  }
+
+  QueryKeys BuildKeys() const {
+    QueryKeys keys;
+    for (const auto &node : match_nodes_) {
+      keys.match_labels.insert(keys.match_labels.end(), node.labels.begin(), node.labels.end());
+      keys.has_unlabeled_node = keys.has_unlabeled_node || node.labels.empty();
+      if (node.properties.empty()) {
+        keys.match_keyed = false;
+        continue;
+      }
+      AppendKeys(node, keys.match);
+    }
+    for (const auto &node : merge_nodes_) {
+      if (FindMatchNode(node.variable)) {
+        continue;
+      }
+      keys.merge_labels.insert(keys.merge_labels.end(), node.labels.begin(), node.labels.end());
+      keys.has_unlabeled_node = keys.has_unlabeled_node || node.labels.empty();
+      keys.merge_keyed = keys.merge_keyed && node.complete && !node.properties.empty();
+      AppendKeys(node, keys.merge_vertices);
+    }
+    for (const auto &node : create_nodes_) {
+      if (FindMatchNode(node.variable) || FindNode(merge_nodes_, node.variable)) {
+        continue;
+      }
+      // A new vertex without a label can only be found by an unlabeled pattern, so it doesn't need a key.
+      if (node.labels.empty()) {
+        continue;
+      }
+      keys.create_labels.insert(keys.create_labels.end(), node.labels.begin(), node.labels.end());
+      keys.create_keyed = keys.create_keyed && node.complete && !node.properties.empty();
+      AppendKeys(node, keys.create);
+    }
+    SortUnique(keys.match);
+    SortUnique(keys.merge_vertices);
+    SortUnique(keys.create);
+    SortUnique(keys.match_labels);
+    SortUnique(keys.merge_labels);
+    SortUnique(keys.create_labels);
+    keys.merge = BuildMergeKey();
+    keys.merge_has_relationship = merge_has_relationship_;
+    keys.has_side_effects = has_side_effects_;
+    keys.index_labels = index_labels_;
+    return keys;
+  }
+
+  // The property which identifies the vertices: merge_key_property_ if it's set, otherwise the only property of the
+  // pattern. Not set if the pattern doesn't have it as a literal.
+  const std::pair<std::string, std::string> *KeyProperty(const NodePattern &node) const {
+    if (!node.complete) {
+      return nullptr;
+    }
+    if (merge_key_property_.empty()) {
+      return node.properties.size() == 1 ? &node.properties.front() : nullptr;
+    }
+    for (const auto &property : node.properties) {
+      if (property.first == merge_key_property_) {
+        return &property;
+      }
+    }
+    return nullptr;
+  }
+
+  // A MERGE finds the vertex another one created if its labels and properties are a subset of the other's, so the two
+  // have to share the key: the label and the key property. Every such pair of single label patterns with the key
+  // property gets the same key, the patterns with more labels (or without the key property) are left out.
+  std::optional<Key> NodeShardKey(const NodePattern &node) const {
+    auto labels = node.labels;
+    SortUnique(labels);
+    const auto *property = KeyProperty(node);
+    if (labels.size() != 1 || !property) {
+      return std::nullopt;
+    }
+    return MakeKey(labels.front(), property->first, property->second);
+  }
+
+  // A matched vertex can be found through any of its labels, only the key property identifies it.
+  std::optional<Key> EndpointShardKey(const NodePattern &node) const {
+    const auto *property = KeyProperty(node);
+    if (!property) {
+      return std::nullopt;
+    }
+    return MakeKey("", property->first, property->second);
+  }
+
+  static Key CombineKeys(Key seed, Key key) { return seed ^ (key + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)); }
+
+  std::optional<Key> BuildMergeKey() const {
+    if (merge_nodes_.empty()) {
+      return std::nullopt;
+    }
+    if (!merge_has_relationship_) {
+      // Two MERGE queries with different keys run concurrently, a single node per query is the only way to be sure
+      // they don't create the same vertex twice.
+      const auto &node = merge_nodes_.front();
+      if (merge_nodes_.size() != 1 || FindMatchNode(node.variable)) {
+        return std::nullopt;
+      }
+      return NodeShardKey(node);
+    }
+    // A relationship can only be merged in parallel if its endpoints already exist (they are matched).
+    std::vector<Key> endpoint_keys;
+    for (const auto &node : merge_nodes_) {
+      const auto *bound = FindMatchNode(node.variable);
+      if (!bound || !node.labels.empty() || !node.properties.empty()) {
+        return std::nullopt;
+      }
+      auto bound_key = EndpointShardKey(*bound);
+      if (!bound_key) {
+        return std::nullopt;
+      }
+      endpoint_keys.push_back(*bound_key);
+    }
+    // In any order, (a)-[:R]-(b) and (b)<-[:R]-(a) can be the same relationship.
+    SortUnique(endpoint_keys);
+    Key key = 0;
+    for (const auto endpoint_key : endpoint_keys) {
+      key = CombineKeys(key, endpoint_key);
+    }
+    for (const auto &type : merge_relationship_types_) {
+      key = CombineKeys(key, MakeKey(type, "", ""));
+    }
+    return key;
+  }
+
+  Lexer lexer_;
+  Token current_;
+  ClauseKind clause_{ClauseKind::NONE};
+  std::vector<NodePattern> match_nodes_;
+  std::vector<NodePattern> merge_nodes_;
+  std::vector<NodePattern> create_nodes_;
+  std::vector<std::string> merge_relationship_types_;
+  std::vector<std::string> index_labels_;
+  std::string_view merge_key_property_;
+  bool merge_has_relationship_{false};
+  bool has_side_effects_{false};
+};
+
+}  // namespace
+
+Key MakeKey(std::string_view label, std::string_view property, std::string_view value) {
+  constexpr uint64_t kOffsetBasis = 14695981039346656037ULL;
+  constexpr uint64_t kPrime = 1099511628211ULL;
+  uint64_t hash = kOffsetBasis;
+  auto mix = [&hash](std::string_view part) {
+    for (auto c : part) {
+      hash ^= static_cast<unsigned char>(c);
+      hash *= kPrime;
+    }
+    // Separator, so that ("ab", "c") and ("a", "bc") differ.
+    hash ^= 0xff;
+    hash *= kPrime;
+  };
+  mix(label);
+  mix(property);
+  mix(value);
+  return hash;
+}
+
+QueryKeys ExtractKeys(std::string_view query, std::string_view merge_key_property) {
+  return PatternParser(query, merge_key_property).Parse();
+}
+
+}  // namespace query::keys
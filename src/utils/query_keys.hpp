@@ -0,0 +1,90 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// A tiny pattern scanner on top of the clause state machine from query_type.hpp. The state machine only tells which
+// clauses a query has, this one looks into the node patterns to figure out which vertices a query touches. It
+// understands the shape of the queries produced by DUMP DATABASE and by the usual import scripts, e.g.
+//   MATCH (n:Paper {id: 1}), (m:Paper {id: 2}) CREATE (n)-[:CITES]->(m);
+//   MATCH (u:__mg_vertex__), (v:__mg_vertex__) WHERE u.__mg_id__ = 0 AND v.__mg_id__ = 1 CREATE (u)-[:R]->(v);
+// Anything more complicated (expressions, OR in WHERE, ...) is simply not keyed, callers have to be conservative.
+
+namespace query::keys {
+
+/// Hash of a (label, property, value) triple. Two node patterns with the same key very likely point to the same
+/// vertex.
+using Key = uint64_t;
+
+/// Stable (FNV-1a) hash of a (label, property, value) triple.
+Key MakeKey(std::string_view label, std::string_view property, std::string_view value);
+
+struct NodePattern {
+  std::string variable;
+  std::vector<std::string> labels;
+  /// Property name and normalized literal value pairs, equal literals are normalized to the same text (1 and 1.0,
+  /// 'a' and "a").
+  std::vector<std::pair<std::string, std::string>> properties;
+  /// Set if all the properties of the pattern are literals, i.e. a vertex created out of it has exactly them.
+  bool complete{true};
+};
+
+struct QueryKeys {
+  /// Keys of the node patterns under MATCH (including the WHERE equalities on the matched variables).
+  std::vector<Key> match;
+  /// Set if every node pattern under MATCH got at least one key.
+  bool match_keyed{true};
+  /// Shard key of the MERGE clauses, every MERGE which might find the vertex (or the relationship) another one creates
+  /// gets the same key. For a node it's the label and the key property (see ExtractKeys) of the merged node, for a
+  /// relationship the key properties of the matched endpoints in any order and the type. It's only set if the query
+  /// can be executed independently of the MERGE queries with a different key, i.e. it either merges a single node with
+  /// a single label or only relationships between matched nodes, and the key properties are literals.
+  std::optional<Key> merge;
+  /// Set if some MERGE pattern contains a relationship.
+  bool merge_has_relationship{false};
+
+  /// Keys of the vertices created under CREATE (node patterns not bound by MATCH or MERGE).
+  std::vector<Key> create;
+  /// Set if every created vertex is fully described by literals.
+  bool create_keyed{true};
+  /// Keys of the merged node patterns which are not bound by MATCH.
+  std::vector<Key> merge_vertices;
+  /// Set if every merged (not bound) node pattern is fully described by literals.
+  bool merge_keyed{true};
+
+  /// Sorted labels of the node patterns, per clause (for CREATE and MERGE only of the not bound ones).
+  std::vector<std::string> match_labels;
+  std::vector<std::string> create_labels;
+  std::vector<std::string> merge_labels;
+  /// Set if a matched or merged node pattern has no label, it might touch any vertex.
+  bool has_unlabeled_node{false};
+  /// Set if the query has SET, DELETE, REMOVE, FOREACH or CALL (ON CREATE SET / ON MATCH SET under MERGE excluded).
+  bool has_side_effects{false};
+  /// Labels (or edge types) of CREATE INDEX / DROP INDEX statements.
+  std::vector<std::string> index_labels;
+};
+
+/// Splits a query into node patterns per clause and derives the keys. The MERGE key is made out of the
+/// merge_key_property of the nodes, or if it's empty, out of their only property (the nodes with more are not keyed).
+QueryKeys ExtractKeys(std::string_view query, std::string_view merge_key_property = {});
+
+}  // namespace query::keys
@@ -248,6 +248,9 @@ inline ClauseState NextState(char *quote, char c, const ClauseState state) {
   } else if (!*quote && (c == 'E' || c == 'e') && state == ClauseState::STORAGE_MOD) {
     return ClauseState::STORAGE_MODE;
 
+  } else if (state != ClauseState::NONE) {
+    // The character might start a new clause, e.g. `) CREATE (` is not `) REMOVE` but it's still a CREATE.
+    return NextState(quote, c, ClauseState::NONE);
   } else {
     return ClauseState::NONE;
   }
@@ -0,0 +1,159 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "scan.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MG_SCAN_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MG_SCAN_NEON
+#endif
+
+namespace utils::scan {
+
+namespace {
+
+// A matcher marks the bytes to find, both a single byte and a vector of them (0xFF in the matching lanes).
+
+bool IsControl(char c) { return static_cast<unsigned char>(c) < 0x20; }
+
+#ifdef MG_SCAN_SSE2
+using Vector = __m128i;
+
+Vector Load(const char *data) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(data)); }
+Vector Equal(Vector bytes, char c) { return _mm_cmpeq_epi8(bytes, _mm_set1_epi8(c)); }
+Vector Or(Vector a, Vector b) { return _mm_or_si128(a, b); }
+/// Unsigned bytes <= 0x1F: the unsigned maximum with 0x1F doesn't change 0x1F.
+Vector Control(Vector bytes) {
+  const auto limit = _mm_set1_epi8(0x1F);
+  return _mm_cmpeq_epi8(_mm_max_epu8(bytes, limit), limit);
+}
+#elif defined(MG_SCAN_NEON)
+using Vector = uint8x16_t;
+
+Vector Load(const char *data) { return vld1q_u8(reinterpret_cast<const uint8_t *>(data)); }
+Vector Equal(Vector bytes, char c) { return vceqq_u8(bytes, vdupq_n_u8(static_cast<uint8_t>(c))); }
+Vector Or(Vector a, Vector b) { return vorrq_u8(a, b); }
+Vector Control(Vector bytes) { return vcleq_u8(bytes, vdupq_n_u8(0x1F)); }
+#endif
+
+struct Quote {
+  static bool Match(char c) { return c == '"'; }
+#if defined(MG_SCAN_SSE2) || defined(MG_SCAN_NEON)
+  static Vector Match(Vector bytes) { return Equal(bytes, '"'); }
+#endif
+};
+
+struct LiteralSpecial {
+  static bool Match(char c) { return c == '"' || c == '\'' || c == '\\' || IsControl(c); }
+#if defined(MG_SCAN_SSE2) || defined(MG_SCAN_NEON)
+  static Vector Match(Vector bytes) {
+    return Or(Or(Equal(bytes, '"'), Equal(bytes, '\'')), Or(Equal(bytes, '\\'), Control(bytes)));
+  }
+#endif
+};
+
+struct JsonSpecial {
+  static bool Match(char c) { return c == '"' || c == '\\' || IsControl(c); }
+#if defined(MG_SCAN_SSE2) || defined(MG_SCAN_NEON)
+  static Vector Match(Vector bytes) { return Or(Or(Equal(bytes, '"'), Equal(bytes, '\\')), Control(bytes)); }
+#endif
+};
+
+template <class Matcher>
+size_t Find(std::string_view src, size_t pos) {
+  const auto *data = src.data();
+  const auto size = src.size();
+#if defined(MG_SCAN_SSE2)
+  for (; pos + 32 <= size; pos += 32) {
+    const auto low = static_cast<uint32_t>(_mm_movemask_epi8(Matcher::Match(Load(data + pos))));
+    const auto high = static_cast<uint32_t>(_mm_movemask_epi8(Matcher::Match(Load(data + pos + 16))));
+    if (const auto mask = low | (high << 16); mask != 0) {
+      return pos + std::countr_zero(mask);
+    }
+  }
+  for (; pos + 16 <= size; pos += 16) {
+    if (const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(Matcher::Match(Load(data + pos)))); mask != 0) {
+      return pos + std::countr_zero(mask);
+    }
+  }
+#elif defined(MG_SCAN_NEON)
+  for (; pos + 16 <= size; pos += 16) {
+    // Narrowed to 4 bits per byte, NEON has no movemask.
+    const auto matches = vreinterpretq_u16_u8(Matcher::Match(Load(data + pos)));
+    const auto mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(matches, 4)), 0);
+    if (mask != 0) {
+      return pos + std::countr_zero(mask) / 4;
+    }
+  }
+#endif
+  for (; pos < size; ++pos) {
+    if (Matcher::Match(data[pos])) return pos;
+  }
+  return size;
+}
+
+}  // namespace
+
+size_t FindQuote(std::string_view src, size_t pos) { return Find<Quote>(src, pos); }
+
+size_t FindLiteralSpecial(std::string_view src, size_t pos) { return Find<LiteralSpecial>(src, pos); }
+
+size_t FindJsonSpecial(std::string_view src, size_t pos) { return Find<JsonSpecial>(src, pos); }
+
+size_t FindNonAscii(std::string_view src, size_t pos) {
+  const auto *data = src.data();
+  const auto size = src.size();
+#if defined(MG_SCAN_SSE2)
+  // The movemask of the bytes themselves is their high bits.
+  for (; pos + 16 <= size; pos += 16) {
+    if (const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(Load(data + pos))); mask != 0) {
+      return pos + std::countr_zero(mask);
+    }
+  }
+#elif defined(MG_SCAN_NEON)
+  for (; pos + 16 <= size; pos += 16) {
+    if (vmaxvq_u8(Load(data + pos)) >= 0x80) break;
+  }
+#endif
+  // Cells are often shorter than a vector, so the rest is tested 8 bytes at a time by their high bits.
+  for (; pos + 8 <= size; pos += 8) {
+    uint64_t word;
+    std::memcpy(&word, data + pos, sizeof(word));
+    if (const auto high = word & 0x8080808080808080ULL; high != 0) {
+      return pos + (std::endian::native == std::endian::little ? std::countr_zero(high) : std::countl_zero(high)) / 8;
+    }
+  }
+  if (pos + 4 <= size) {
+    uint32_t word;
+    std::memcpy(&word, data + pos, sizeof(word));
+    if (const auto high = word & 0x80808080U; high != 0) {
+      return pos + (std::endian::native == std::endian::little ? std::countr_zero(high) : std::countl_zero(high)) / 8;
+    }
+    pos += 4;
+  }
+  for (; pos < size; ++pos) {
+    if (static_cast<unsigned char>(data[pos]) >= 0x80) return pos;
+  }
+  return size;
+}
+
+}  // namespace utils::scan
@@ -0,0 +1,41 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+// Kernels finding the next byte which needs escaping, 32 bytes at a time with SSE2 (every x86-64 CPU has it) or 16
+// with NEON, and a byte at a time elsewhere. The escaping functions copy the runs between the found bytes as a whole,
+// so a string without anything to escape is a single scan and a single append.
+
+namespace utils::scan {
+
+/// The position of the first '"' at or after pos, or src.size().
+size_t FindQuote(std::string_view src, size_t pos);
+
+/// The position of the first '"', '\'', '\\' or control character (< 0x20) at or after pos, or src.size(). Those are
+/// the bytes AppendEscaped may escape.
+size_t FindLiteralSpecial(std::string_view src, size_t pos);
+
+/// The position of the first '"', '\\' or control character (< 0x20) at or after pos, or src.size(). Those are the
+/// bytes a JSON string escapes.
+size_t FindJsonSpecial(std::string_view src, size_t pos);
+
+/// The position of the first byte >= 0x80 at or after pos, or src.size(). Everything before it is ASCII, one column
+/// per byte, see utf8::Width.
+size_t FindNonAscii(std::string_view src, size_t pos);
+
+}  // namespace utils::scan
@@ -0,0 +1,173 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "simulator.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "assert.hpp"
+
+namespace utils {
+
+namespace {
+// Connecting takes a few round trips.
+constexpr double kReconnectLatencyFactor = 10.0;
+
+// Vertices touched by the queries, two concurrent transactions touching the same vertex conflict.
+std::vector<query::keys::Key> TouchedKeys(const std::vector<query::keys::QueryKeys> &queries_keys) {
+  std::vector<query::keys::Key> keys;
+  for (const auto &query_keys : queries_keys) {
+    keys.insert(keys.end(), query_keys.match.begin(), query_keys.match.end());
+    keys.insert(keys.end(), query_keys.create.begin(), query_keys.create.end());
+    keys.insert(keys.end(), query_keys.merge_vertices.begin(), query_keys.merge_vertices.end());
+  }
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  return keys;
+}
+
+void AddVertices(const query::keys::QueryKeys &query_keys, std::unordered_set<query::keys::Key> &vertices) {
+  vertices.insert(query_keys.create.begin(), query_keys.create.end());
+  vertices.insert(query_keys.merge_vertices.begin(), query_keys.merge_vertices.end());
+}
+
+bool Intersects(const std::vector<query::keys::Key> &lhs, const std::vector<query::keys::Key> &rhs) {
+  std::vector<query::keys::Key> intersection;
+  std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(intersection));
+  return !intersection.empty();
+}
+}  // namespace
+
+Simulator::Simulator(SimulatorConfig config) : config_(config), generator_(config.seed) {}
+
+double Simulator::Random() { return static_cast<double>(generator_() >> 11) * 0x1.0p-53; }
+
+double &Simulator::Clock() { return task_time_ ? *task_time_ : now_; }
+
+void Simulator::Dispatch(const std::function<void()> &task) {
+  MG_ASSERT(!task_time_, "the simulator doesn't support dispatching from a task");
+  // New transactions start now at the earliest, older ones can't conflict with them anymore.
+  std::erase_if(committed_, [this](const auto &transaction) { return transaction.end <= now_; });
+  task_time_ = now_;
+  task();
+  for (const auto &readiness_token : task_notifications_) {
+    events_.push(Event{.time = *task_time_, .sequence = sequence_++, .readiness_token = readiness_token});
+  }
+  task_notifications_.clear();
+  task_time_.reset();
+}
+
+void Simulator::Notify(ReadinessToken readiness_token) {
+  MG_ASSERT(task_time_, "the simulator only supports notifications from a task");
+  task_notifications_.push_back(readiness_token);
+}
+
+void Simulator::Backoff(int64_t max_ms) { Clock() += Random() * static_cast<double>(max_ms); }
+
+query::BatchResult Simulator::ExecuteBatch(const query::Batch &batch) {
+  auto &clock = Clock();
+  const auto begin = clock;
+  double duration = 0.0;
+  for (uint64_t i = 0; i < batch.queries.size(); ++i) {
+    duration += config_.query_latency_ms * (0.5 + Random());
+  }
+  // Begin + commit.
+  const auto end = begin + duration + 2 * config_.query_latency_ms;
+
+  if (Random() < config_.drop_probability) {
+    clock = begin + duration / 2;
+    stats_.drops++;
+    return query::BatchResult{.is_executed = false,
+                              .results = {},
+                              .error = query::BatchError::CONNECTION,
+                              .failed_query = std::nullopt,
+                              .error_message = "simulated connection drop"};
+  }
+  clock = end;
+  std::vector<query::keys::QueryKeys> queries_keys;
+  queries_keys.reserve(batch.queries.size());
+  for (const auto &query : batch.queries) {
+    queries_keys.push_back(query::keys::ExtractKeys(query.query));
+  }
+  auto keys = TouchedKeys(queries_keys);
+  const auto conflict =
+      Random() < config_.conflict_probability ||
+      std::any_of(committed_.begin(), committed_.end(), [&](const auto &transaction) {
+        return transaction.begin < end && begin < transaction.end && Intersects(transaction.keys, keys);
+      });
+  if (conflict) {
+    stats_.conflicts++;
+    return query::BatchResult{.is_executed = false,
+                              .results = {},
+                              .error = query::BatchError::CONFLICT,
+                              .failed_query = std::nullopt,
+                              .error_message = "simulated serialization error"};
+  }
+  // A query creates nothing if a matched vertex is neither in the database nor created earlier in the batch.
+  std::unordered_set<query::keys::Key> created;
+  auto exists = [&](const auto key) { return vertices_.contains(key) || created.contains(key); };
+  for (uint64_t i = 0; i < queries_keys.size(); ++i) {
+    const auto &match = queries_keys[i].match;
+    if (!std::all_of(match.begin(), match.end(), exists)) {
+      if (!batch.check_created) {
+        continue;
+      }
+      return query::BatchResult{.is_executed = false,
+                                .results = {},
+                                .error = query::BatchError::NOT_CREATED,
+                                .failed_query = i,
+                                .error_message = "simulated nothing created"};
+    }
+    AddVertices(queries_keys[i], created);
+  }
+  vertices_.insert(created.begin(), created.end());
+  committed_.push_back(Transaction{.begin = begin, .end = end, .keys = std::move(keys)});
+  stats_.committed_transactions++;
+  stats_.committed_queries += batch.queries.size();
+  return query::BatchResult{.is_executed = true,
+                            .results = {},
+                            .error = query::BatchError::NONE,
+                            .failed_query = std::nullopt,
+                            .error_message = {}};
+}
+
+void Simulator::ExecuteQuery(const std::string &query) {
+  Restore(query);
+  Clock() += config_.query_latency_ms;
+  stats_.committed_transactions++;
+  stats_.committed_queries++;
+}
+
+void Simulator::Restore(const std::string &query) { AddVertices(query::keys::ExtractKeys(query), vertices_); }
+
+void Simulator::Reconnect() { Clock() += kReconnectLatencyFactor * config_.query_latency_ms; }
+
+bool Simulator::Tick(const Notifier &notifier) {
+  if (events_.empty()) {
+    // MG_ASSERT is gone in release builds and Await would spin forever.
+    console::EchoFailure("Simulation failure", "waiting for a notification that will never come");
+    std::exit(1);
+  }
+  auto event = events_.top();
+  events_.pop();
+  now_ = std::max(now_, event.time);
+  notifier.Notify(event.readiness_token);
+  return true;
+}
+
+std::chrono::duration<double> Simulator::Now() const { return std::chrono::duration<double, std::milli>(now_); }
+
+}  // namespace utils
@@ -0,0 +1,121 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "notifier.hpp"
+#include "query_keys.hpp"
+#include "utils.hpp"
+
+// A deterministic, single threaded stand-in for the thread pool + Bolt sessions used by the batched import. Tasks are
+// executed right away on the dispatching thread, but the time they spend executing queries or sleeping is virtual.
+// Notifications sent by a task are delivered (through the Notifier tick_simulator hook) only once the virtual clock
+// reaches the end of the task, so the scheduler sees the completions in the virtual time order, without a database and
+// without any nondeterminism coming from threads. Since a task runs to the end when it's dispatched, out of two
+// overlapping transactions touching the same vertex the one dispatched later is the one that aborts. The simulated
+// database knows which vertex keys (label, property, value) were created, a query matching a key that isn't there creates
+// nothing.
+
+namespace utils {
+
+struct SimulatorConfig {
+  uint64_t seed{0};
+  /// Mean virtual time of a single query, the actual one is uniform in [0.5, 1.5] * mean.
+  double query_latency_ms{1.0};
+  /// Probability that a transaction fails with a serialization error, on top of the conflicts between the concurrent
+  /// transactions touching the same vertices.
+  double conflict_probability{0.0};
+  /// Probability that the connection drops in the middle of a transaction.
+  double drop_probability{0.0};
+};
+
+struct SimulatorStats {
+  uint64_t committed_transactions{0};
+  uint64_t committed_queries{0};
+  uint64_t conflicts{0};
+  uint64_t drops{0};
+};
+
+class Simulator {
+ public:
+  explicit Simulator(SimulatorConfig config);
+
+  /// Runs the task now, the notifications it sends are delivered at its virtual end.
+  void Dispatch(const std::function<void()> &task);
+  void Notify(ReadinessToken readiness_token);
+  /// Sleeps for a random virtual time up to max_ms.
+  void Backoff(int64_t max_ms);
+
+  query::BatchResult ExecuteBatch(const query::Batch &batch);
+  /// Autocommit query, never fails.
+  void ExecuteQuery(const std::string &query);
+  /// A query committed before the import was resumed, its vertices are in the database already.
+  void Restore(const std::string &query);
+  void Reconnect();
+
+  /// Delivers the next notification and moves the virtual clock to it, meant to be installed as the notifier ticker.
+  bool Tick(const Notifier &notifier);
+
+  /// Virtual time since the start.
+  std::chrono::duration<double> Now() const;
+  const SimulatorStats &Stats() const { return stats_; }
+
+ private:
+  struct Event {
+    double time;
+    uint64_t sequence;
+    ReadinessToken readiness_token;
+  };
+  struct EventLater {
+    bool operator()(const Event &lhs, const Event &rhs) const {
+      return lhs.time > rhs.time || (lhs.time == rhs.time && lhs.sequence > rhs.sequence);
+    }
+  };
+  struct Transaction {
+    double begin;
+    double end;
+    std::vector<query::keys::Key> keys;
+  };
+
+  /// Uniform in [0, 1), the same on every platform (unlike std::uniform_real_distribution).
+  double Random();
+  /// The virtual time of the running task, or the global one if no task is running.
+  double &Clock();
+
+  SimulatorConfig config_;
+  SimulatorStats stats_;
+  std::mt19937_64 generator_;
+  double now_{0.0};
+  std::optional<double> task_time_;
+  std::vector<ReadinessToken> task_notifications_;
+  std::priority_queue<Event, std::vector<Event>, EventLater> events_;
+  uint64_t sequence_{0};
+  /// Committed transactions which might still overlap with the new ones.
+  std::vector<Transaction> committed_;
+  /// Keys of the created (or merged) vertices.
+  std::unordered_set<query::keys::Key> vertices_;
+};
+
+}  // namespace utils
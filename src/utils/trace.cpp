@@ -0,0 +1,128 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "trace.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace utils::trace {
+
+namespace {
+
+struct Event {
+  const char *name;
+  int64_t begin;
+  int64_t duration;
+};
+
+struct ThreadBuffer {
+  uint64_t tid;
+  /// Only contended while flushing.
+  std::mutex lock;
+  std::vector<Event> events;
+};
+
+struct Registry {
+  std::chrono::steady_clock::time_point start{std::chrono::steady_clock::now()};
+  std::string path;
+  std::mutex lock;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+};
+
+Registry &GetRegistry() {
+  static Registry registry;
+  return registry;
+}
+
+ThreadBuffer &GetThreadBuffer() {
+  thread_local ThreadBuffer *buffer = nullptr;
+  if (!buffer) {
+    auto &registry = GetRegistry();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    auto &new_buffer = registry.buffers.emplace_back(std::make_unique<ThreadBuffer>());
+    new_buffer->tid = registry.buffers.size();
+    buffer = new_buffer.get();
+  }
+  return *buffer;
+}
+
+}  // namespace
+
+int64_t Now() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                               GetRegistry().start)
+      .count();
+}
+
+void Enable(const std::string &path) {
+  auto &registry = GetRegistry();
+  registry.path = path;
+  registry.start = std::chrono::steady_clock::now();
+  // The enabling thread gets tid 1.
+  GetThreadBuffer();
+  enabled = true;
+  // SIGINT/SIGTERM end the process with quick_exit, which doesn't run the atexit handlers.
+  std::atexit(Flush);
+#ifndef __APPLE__
+  std::at_quick_exit(Flush);
+#endif /* __APPLE__ */
+}
+
+void Complete(const char *name, int64_t begin) {
+  const auto end = Now();
+  auto &buffer = GetThreadBuffer();
+  std::lock_guard<std::mutex> guard(buffer.lock);
+  buffer.events.push_back(Event{.name = name, .begin = begin, .duration = end - begin});
+}
+
+void Flush() {
+  static std::atomic<bool> flushed{false};
+  if (!IsEnabled() || flushed.exchange(true)) {
+    return;
+  }
+  auto &registry = GetRegistry();
+  std::lock_guard<std::mutex> guard(registry.lock);
+  std::ofstream trace(registry.path, std::ios::trunc);
+  if (!trace.is_open()) {
+    return;
+  }
+  trace << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  auto separator = [&first]() {
+    if (first) {
+      first = false;
+      return "\n";
+    }
+    return ",\n";
+  };
+  for (const auto &buffer : registry.buffers) {
+    trace << separator() << R"({"ph":"M","name":"thread_name","pid":1,"tid":)" << buffer->tid
+          << R"(,"args":{"name":")" << (buffer->tid == 1 ? "main" : "worker " + std::to_string(buffer->tid - 1))
+          << "\"}}";
+    std::lock_guard<std::mutex> buffer_guard(buffer->lock);
+    for (const auto &event : buffer->events) {
+      trace << separator() << R"({"ph":"X","cat":"mgconsole","name":")" << event.name << R"(","pid":1,"tid":)"
+            << buffer->tid << ",\"ts\":" << event.begin << ",\"dur\":" << event.duration << '}';
+    }
+  }
+  trace << "\n]}\n";
+}
+
+}  // namespace utils::trace
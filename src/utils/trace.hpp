@@ -0,0 +1,69 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Chrome / Perfetto trace events (https://ui.perfetto.dev, chrome://tracing). Each thread records complete ("X")
+// events into its own buffer, the buffers are written to the trace file at exit. Disabled tracing costs a relaxed
+// atomic load per span, so the spans stay compiled into the release builds.
+
+namespace utils::trace {
+
+inline std::atomic<bool> enabled{false};
+
+inline bool IsEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+/// Microseconds since the trace was enabled.
+int64_t Now();
+
+/// Starts collecting the events, they are written to the path at exit (or by Flush).
+void Enable(const std::string &path);
+
+/// Writes all the events collected so far, only the first call writes them.
+void Flush();
+
+/// Records a span which began at begin (see Now) and ends now, name has to be a string literal.
+void Complete(const char *name, int64_t begin);
+
+/// Records the scope as a span.
+class Span {
+ public:
+  explicit Span(const char *name) {
+    if (IsEnabled()) [[unlikely]] {
+      name_ = name;
+      begin_ = Now();
+    }
+  }
+  Span(const Span &) = delete;
+  Span &operator=(const Span &) = delete;
+  Span(Span &&) = delete;
+  Span &operator=(Span &&) = delete;
+  ~Span() {
+    if (name_) [[unlikely]] {
+      Complete(name_, begin_);
+    }
+  }
+
+ private:
+  const char *name_{nullptr};
+  int64_t begin_{0};
+};
+
+}  // namespace utils::trace
@@ -0,0 +1,37 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+// Terminal display width of UTF-8 text, the number of columns it takes. Most characters take one column, the East
+// Asian wide and fullwidth ones (CJK, Hangul, emoji) take two, and the combining marks and format characters take
+// none. The text is validated while it's decoded, each byte which isn't part of a valid UTF-8 sequence takes one
+// column (a terminal shows it as a replacement character). The ASCII runs are skipped with scan::FindNonAscii, a
+// vector at a time, so measuring ASCII text is a single scan.
+
+namespace utils::utf8 {
+
+/// The number of terminal columns the text takes.
+uint64_t Width(std::string_view text);
+
+/// The longest prefix of the text which is at most max_width columns wide, without cutting a character. Returns its
+/// size in bytes and its width.
+std::pair<size_t, uint64_t> Prefix(std::string_view text, uint64_t max_width);
+
+}  // namespace utils::utf8
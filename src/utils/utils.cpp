@@ -16,17 +16,24 @@
 #include <string.h>
 
 #include <algorithm>
+#include <charconv>
 #include <chrono>
+#include <cerrno>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <cstdio>
+#include <functional>
 #include <ios>
 #include <iostream>
+#include <numeric>
 #include <ostream>
 #include <string>
 #include <string_view>
+#include <tuple>
 #include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include "assert.hpp"
 
 #ifdef __APPLE__
@@ -54,10 +61,21 @@
 #include <gflags/gflags.h>
 #include <replxx.h>
 
+#include "bolt_record.hpp"
+#include "checkpoint.hpp"
 #include "constants.hpp"
 #include "date.hpp"
+// After date.hpp, its unqualified format() calls would find the format namespace.
+#include "arrow.hpp"
+#include "json.hpp"
 #include "mgclient.h"
+#include "output.hpp"
+#include "parallel_format.hpp"
+#include "perf_counters.hpp"
 #include "query_type.hpp"
+#include "scan.hpp"
+#include "trace.hpp"
+#include "utf8.hpp"
 #include "utils.hpp"
 
 namespace utils {
@@ -99,59 +117,134 @@ std::string Trim(const std::string &s) {
 }
 
 std::string Replace(std::string src, const std::string &match, const std::string &replacement) {
-  for (size_t pos = src.find(match); pos != std::string::npos; pos = src.find(match, pos + replacement.size())) {
-    src.erase(pos, match.length()).insert(pos, replacement);
+  auto pos = src.find(match);
+  if (match.empty() || pos == std::string::npos) {
+    return src;
   }
-  return src;
+  std::string ret;
+  ret.reserve(src.size());
+  size_t begin = 0;
+  for (; pos != std::string::npos; pos = src.find(match, begin)) {
+    ret.append(src, begin, pos - begin).append(replacement);
+    begin = pos + match.size();
+  }
+  ret.append(src, begin);
+  return ret;
 }
 
 std::string Escape(const std::string &src) {
   std::string ret;
-  ret.reserve(src.size() + 2);
-  ret.append(1, '"');
-  for (auto c : src) {
+  AppendEscaped(ret, src);
+  return ret;
+}
+
+void AppendEscaped(std::string &buffer, std::string_view src) {
+  buffer.reserve(buffer.size() + src.size() + 2);
+  buffer.push_back('"');
+  for (size_t pos = 0;;) {
+    const auto special = scan::FindLiteralSpecial(src, pos);
+    buffer.append(src.data() + pos, special - pos);
+    if (special == src.size()) break;
+    const auto c = src[special];
     if (c == '\\' || c == '\'' || c == '"') {
-      ret.append(1, '\\');
-      ret.append(1, c);
+      buffer.push_back('\\');
+      buffer.push_back(c);
     } else if (c == '\b') {
-      ret.append("\\b");
+      buffer.append("\\b");
     } else if (c == '\f') {
-      ret.append("\\f");
+      buffer.append("\\f");
     } else if (c == '\n') {
-      ret.append("\\n");
+      buffer.append("\\n");
     } else if (c == '\r') {
-      ret.append("\\r");
+      buffer.append("\\r");
     } else if (c == '\t') {
-      ret.append("\\t");
+      buffer.append("\\t");
     } else {
-      ret.append(1, c);
+      // The other control characters stay as they are.
+      buffer.push_back(c);
     }
+    pos = special + 1;
   }
-  ret.append(1, '"');
-  return ret;
+  buffer.push_back('"');
+}
+
+void AppendInteger(std::string &buffer, int64_t value) {
+  char digits[24];
+  const auto [end, ec] = std::to_chars(std::begin(digits), std::end(digits), value);
+  buffer.append(digits, end);
+}
+
+void AppendFloat(std::string &buffer, double value) {
+  // The shortest representation which parses back to the same value.
+  char digits[32];
+  const auto [end, ec] = std::to_chars(std::begin(digits), std::end(digits), value);
+  buffer.append(digits, end);
+}
+
+namespace {
+
+/// Non-negative value, padded with zeros to the width.
+void AppendPadded(std::string &buffer, int64_t value, size_t width) {
+  char digits[24];
+  const auto [end, ec] = std::to_chars(std::begin(digits), std::end(digits), value);
+  const auto size = static_cast<size_t>(end - digits);
+  if (size < width) buffer.append(width - size, '0');
+  buffer.append(digits, end);
 }
 
-template <typename T, std::enable_if_t<std::is_arithmetic<T>::value, T> = true>
-void PrintIfNotZero(std::ostream &os, T value, std::string_view suffix = "") {
+void AppendIfNotZero(std::string &buffer, int64_t value, std::string_view suffix) {
   if (value) {
-    os << value << suffix;
+    AppendInteger(buffer, value);
+    buffer.append(suffix);
   }
 }
 
+/// The same as streaming date::year_month_day, e.g. 1999-05-05.
+void AppendDays(std::string &buffer, int64_t days) {
+  const auto ymd = date::year_month_day(date::sys_days(date::days(days)));
+  AppendInteger(buffer, static_cast<int>(ymd.year()));
+  buffer.push_back('-');
+  AppendPadded(buffer, static_cast<unsigned>(ymd.month()), 2);
+  buffer.push_back('-');
+  AppendPadded(buffer, static_cast<unsigned>(ymd.day()), 2);
+}
+
+/// The same as streaming date::hh_mm_ss<std::chrono::nanoseconds>, e.g. 23:56:23.000000000.
+void AppendNanoseconds(std::string &buffer, int64_t nanoseconds) {
+  constexpr int64_t kSecond = 1'000'000'000;
+  if (nanoseconds < 0) {
+    buffer.push_back('-');
+    nanoseconds = -nanoseconds;
+  }
+  const auto seconds = nanoseconds / kSecond;
+  AppendPadded(buffer, seconds / 3600, 2);
+  buffer.push_back(':');
+  AppendPadded(buffer, seconds / 60 % 60, 2);
+  buffer.push_back(':');
+  AppendPadded(buffer, seconds % 60, 2);
+  buffer.push_back('.');
+  AppendPadded(buffer, nanoseconds % kSecond, 9);
+}
+
+}  // namespace
+
+void AppendStringUnescaped(std::string &buffer, const mg_string *str) {
+  buffer.append(mg_string_data(str), mg_string_size(str));
+}
+
 void PrintStringUnescaped(std::ostream &os, const mg_string *str) {
   os.write(mg_string_data(str), mg_string_size(str));
 }
 
-std::string GetMemgraphSpecificType(const mg_value *mg_val) {
-  std::string type;
+std::string_view GetMemgraphSpecificType(const mg_value *mg_val) {
   if (mg_val && mg_value_get_type(mg_val) == MG_VALUE_TYPE_STRING) {
     auto *type_val_mg_str = mg_value_string(mg_val);
-    type = std::string(mg_string_data(type_val_mg_str), mg_string_size(type_val_mg_str));
+    return std::string_view(mg_string_data(type_val_mg_str), mg_string_size(type_val_mg_str));
   }
-  return type;
+  return {};
 }
 
-bool PrintIfMemgraphSpecificType(std::ostream &os, const mg_map *map) {
+bool AppendIfMemgraphSpecificType(std::string &buffer, const mg_map *map) {
   // Current format is
   // { "__type": "<type_name>", "__value": <actual value> }
   static const char kTypeKey[] = "__type";
@@ -166,144 +259,120 @@ bool PrintIfMemgraphSpecificType(std::ostream &os, const mg_map *map) {
   if (memgraph_type == kMgEnum) {
     auto *enum_value = mg_map_at(map, kValue);
     if (mg_value_get_type(enum_value) == MG_VALUE_TYPE_STRING) {
-      PrintStringUnescaped(os, mg_value_string(enum_value));
+      AppendStringUnescaped(buffer, mg_value_string(enum_value));
       return true;
     }
   }
   return false;
 }
 
-void PrintValue(std::ostream &os, const mg_string *str) {
-  os << utils::Escape(std::string(mg_string_data(str), mg_string_size(str)));
+void AppendValue(std::string &buffer, const mg_string *str) {
+  AppendEscaped(buffer, std::string_view(mg_string_data(str), mg_string_size(str)));
 }
 
-void PrintValue(std::ostream &os, const mg_list *list) {
-  os << "[";
+void AppendValue(std::string &buffer, const mg_list *list) {
+  buffer.push_back('[');
   for (uint32_t i = 0; i < mg_list_size(list); ++i) {
     if (i > 0) {
-      os << ", ";
+      buffer.append(", ");
     }
-    PrintValue(os, mg_list_at(list, i));
+    AppendValue(buffer, mg_list_at(list, i));
   }
-  os << "]";
+  buffer.push_back(']');
 }
 
-void PrintValue(std::ostream &os, const mg_map *map) {
-  if (PrintIfMemgraphSpecificType(os, map)) {
+void AppendValue(std::string &buffer, const mg_map *map) {
+  if (AppendIfMemgraphSpecificType(buffer, map)) {
     return;
   }
 
-  os << "{";
+  buffer.push_back('{');
   for (uint32_t i = 0; i < mg_map_size(map); ++i) {
     if (i > 0) {
-      os << ", ";
+      buffer.append(", ");
     }
-    PrintStringUnescaped(os, mg_map_key_at(map, i));
-    os << ": ";
-    PrintValue(os, mg_map_value_at(map, i));
+    AppendStringUnescaped(buffer, mg_map_key_at(map, i));
+    buffer.append(": ");
+    AppendValue(buffer, mg_map_value_at(map, i));
   }
-  os << "}";
+  buffer.push_back('}');
 }
 
-void PrintValue(std::ostream &os, const mg_node *node) {
-  os << "(";
+void AppendValue(std::string &buffer, const mg_node *node) {
+  buffer.push_back('(');
   for (uint32_t i = 0; i < mg_node_label_count(node); ++i) {
-    os << ":";
-    PrintStringUnescaped(os, mg_node_label_at(node, i));
+    buffer.push_back(':');
+    AppendStringUnescaped(buffer, mg_node_label_at(node, i));
   }
   const mg_map *props = mg_node_properties(node);
   if (mg_node_label_count(node) > 0 && mg_map_size(props) > 0) {
-    os << " ";
+    buffer.push_back(' ');
   }
   if (mg_map_size(props) > 0) {
-    PrintValue(os, props);
+    AppendValue(buffer, props);
   }
-  os << ")";
+  buffer.push_back(')');
 }
 
-void PrintValue(std::ostream &os, const mg_relationship *rel) {
-  os << "[:";
-  PrintStringUnescaped(os, mg_relationship_type(rel));
+void AppendValue(std::string &buffer, const mg_relationship *rel) {
+  buffer.append("[:");
+  AppendStringUnescaped(buffer, mg_relationship_type(rel));
   const mg_map *props = mg_relationship_properties(rel);
   if (mg_map_size(props) > 0) {
-    os << " ";
-    PrintValue(os, props);
+    buffer.push_back(' ');
+    AppendValue(buffer, props);
   }
-  os << "]";
+  buffer.push_back(']');
 }
 
-void PrintValue(std::ostream &os, const mg_unbound_relationship *rel) {
-  os << "[:";
-  PrintStringUnescaped(os, mg_unbound_relationship_type(rel));
+void AppendValue(std::string &buffer, const mg_unbound_relationship *rel) {
+  buffer.append("[:");
+  AppendStringUnescaped(buffer, mg_unbound_relationship_type(rel));
   const mg_map *props = mg_unbound_relationship_properties(rel);
   if (mg_map_size(props) > 0) {
-    os << " ";
-    PrintValue(os, props);
+    buffer.push_back(' ');
+    AppendValue(buffer, props);
   }
-  os << "]";
+  buffer.push_back(']');
 }
 
-void PrintValue(std::ostream &os, const mg_path *path) {
-  PrintValue(os, mg_path_node_at(path, 0));
+void AppendValue(std::string &buffer, const mg_path *path) {
+  AppendValue(buffer, mg_path_node_at(path, 0));
   for (uint32_t i = 0; i < mg_path_length(path); ++i) {
     if (mg_path_relationship_reversed_at(path, i)) {
-      os << "<-";
+      buffer.append("<-");
     } else {
-      os << "-";
+      buffer.push_back('-');
     }
-    PrintValue(os, mg_path_relationship_at(path, i));
+    AppendValue(buffer, mg_path_relationship_at(path, i));
     if (mg_path_relationship_reversed_at(path, i)) {
-      os << "-";
+      buffer.push_back('-');
     } else {
-      os << "->";
+      buffer.append("->");
     }
-    PrintValue(os, mg_path_node_at(path, i + 1));
+    AppendValue(buffer, mg_path_node_at(path, i + 1));
   }
 }
 
-void PrintValue(std::ostream &os, const mg_date *date) {
-  const auto days = date::days(mg_date_days(date));
-  const auto sys_days = date::sys_days(days);
-  const auto ymd = date::year_month_day(sys_days);
-  os << ymd;
-}
+void AppendValue(std::string &buffer, const mg_date *date) { AppendDays(buffer, mg_date_days(date)); }
 
-void PrintValue(std::ostream &os, const mg_local_time *local_time) {
-  namespace chrono = std::chrono;
-  const auto nanos = chrono::nanoseconds(mg_local_time_nanoseconds(local_time));
-  const auto hms = date::hh_mm_ss(nanos);
-  os << hms;
+void AppendValue(std::string &buffer, const mg_local_time *local_time) {
+  AppendNanoseconds(buffer, mg_local_time_nanoseconds(local_time));
 }
 
-void PrintValue(std::ostream &os, const mg_local_date_time *local_date_time) {
+void AppendValue(std::string &buffer, const mg_local_date_time *local_date_time) {
   namespace chrono = std::chrono;
   const auto seconds = chrono::seconds(mg_local_date_time_seconds(local_date_time));
   const auto days = chrono::duration_cast<date::days>(seconds);
-  const auto date = mg_date_make(days.count());
-
   const auto nanoseconds =
       chrono::duration_cast<chrono::nanoseconds>(seconds) - chrono::duration_cast<chrono::nanoseconds>(days);
-  const auto time = mg_local_time_make(nanoseconds.count() + mg_local_date_time_nanoseconds(local_date_time));
 
-  PrintValue(os, date);
-  os << " ";
-  PrintValue(os, time);
+  AppendDays(buffer, days.count());
+  buffer.push_back(' ');
+  AppendNanoseconds(buffer, nanoseconds.count() + mg_local_date_time_nanoseconds(local_date_time));
 }
 
-void PrintSeconds(std::ostream &os, std::chrono::seconds ss, std::chrono::microseconds mis) {
-  if (ss.count() == 0 && mis.count() < 0) {
-    os << '-';
-  }
-  os << ss.count();
-}
-
-void PrintMicroseconds(std::ostream &os, std::chrono::microseconds mis) {
-  if (mis.count() != 0) {
-    os << "." << std::setw(6) << std::setfill('0') << std::fixed << std::abs(mis.count());
-  }
-}
-
-void PrintValue(std::ostream &os, const mg_duration *duration) {
+void AppendValue(std::string &buffer, const mg_duration *duration) {
   // Currently we are ignoring months for duration
   // const auto months = date::months(mg_duration_months(duration));
   namespace chrono = std::chrono;
@@ -320,95 +389,143 @@ void PrintValue(std::ostream &os, const mg_duration *duration) {
   const auto ss = chrono::duration_cast<chrono::seconds>(time - hh - mm);
   const auto mis = chrono::duration_cast<chrono::microseconds>(time - hh - mm - ss);
 
-  os << "P";
-  PrintIfNotZero(os, days.count(), "D");
+  buffer.push_back('P');
+  AppendIfNotZero(buffer, days.count(), "D");
 
   if (has_subdays) {
-    os << "T";
+    buffer.push_back('T');
   }
 
-  PrintIfNotZero(os, hh.count(), "H");
-  PrintIfNotZero(os, mm.count(), "M");
+  AppendIfNotZero(buffer, hh.count(), "H");
+  AppendIfNotZero(buffer, mm.count(), "M");
   if (ss.count() == 0 && mis.count() == 0) {
     return;
   }
-  PrintSeconds(os, ss, mis);
-  PrintMicroseconds(os, mis);
-  os << "S";
+  if (ss.count() == 0 && mis.count() < 0) {
+    buffer.push_back('-');
+  }
+  AppendInteger(buffer, ss.count());
+  if (mis.count() != 0) {
+    buffer.push_back('.');
+    AppendPadded(buffer, std::abs(mis.count()), 6);
+  }
+  buffer.push_back('S');
 }
 
-void PrintValue(std::ostream &os, const mg_point_2d *value) {
-  os << "POINT({ x:" << mg_point_2d_x(value) << ","
-     << " y:" << mg_point_2d_y(value) << ","
-     << " srid:" << mg_point_2d_srid(value) << " })";
+void AppendValue(std::string &buffer, const mg_point_2d *value) {
+  buffer.append("POINT({ x:");
+  AppendFloat(buffer, mg_point_2d_x(value));
+  buffer.append(", y:");
+  AppendFloat(buffer, mg_point_2d_y(value));
+  buffer.append(", srid:");
+  AppendInteger(buffer, mg_point_2d_srid(value));
+  buffer.append(" })");
 }
 
-void PrintValue(std::ostream &os, const mg_point_3d *value) {
-  os << "POINT({ x:" << mg_point_3d_x(value) << ","
-     << " y:" << mg_point_3d_y(value) << ","
-     << " z:" << mg_point_3d_z(value) << ","
-     << " srid:" << mg_point_3d_srid(value) << " })";
+void AppendValue(std::string &buffer, const mg_point_3d *value) {
+  buffer.append("POINT({ x:");
+  AppendFloat(buffer, mg_point_3d_x(value));
+  buffer.append(", y:");
+  AppendFloat(buffer, mg_point_3d_y(value));
+  buffer.append(", z:");
+  AppendFloat(buffer, mg_point_3d_z(value));
+  buffer.append(", srid:");
+  AppendInteger(buffer, mg_point_3d_srid(value));
+  buffer.append(" })");
 }
 
-void PrintValue(std::ostream &os, const mg_value *value) {
+void AppendValue(std::string &buffer, const mg_value *value) {
   switch (mg_value_get_type(value)) {
     case MG_VALUE_TYPE_NULL:
-      os << "Null";
+      buffer.append("Null");
       return;
     case MG_VALUE_TYPE_BOOL:
-      os << (mg_value_bool(value) ? "true" : "false");
+      buffer.append(mg_value_bool(value) ? "true" : "false");
       return;
     case MG_VALUE_TYPE_INTEGER:
-      os << mg_value_integer(value);
+      AppendInteger(buffer, mg_value_integer(value));
       return;
     case MG_VALUE_TYPE_FLOAT:
-      os << mg_value_float(value);
+      AppendFloat(buffer, mg_value_float(value));
       return;
     case MG_VALUE_TYPE_STRING:
-      PrintValue(os, mg_value_string(value));
+      AppendValue(buffer, mg_value_string(value));
       return;
     case MG_VALUE_TYPE_LIST:
-      PrintValue(os, mg_value_list(value));
+      AppendValue(buffer, mg_value_list(value));
       return;
     case MG_VALUE_TYPE_MAP:
-      PrintValue(os, mg_value_map(value));
+      AppendValue(buffer, mg_value_map(value));
       return;
     case MG_VALUE_TYPE_NODE:
-      PrintValue(os, mg_value_node(value));
+      AppendValue(buffer, mg_value_node(value));
       return;
     case MG_VALUE_TYPE_RELATIONSHIP:
-      PrintValue(os, mg_value_relationship(value));
+      AppendValue(buffer, mg_value_relationship(value));
       return;
     case MG_VALUE_TYPE_UNBOUND_RELATIONSHIP:
-      PrintValue(os, mg_value_unbound_relationship(value));
+      AppendValue(buffer, mg_value_unbound_relationship(value));
       return;
     case MG_VALUE_TYPE_PATH:
-      PrintValue(os, mg_value_path(value));
+      AppendValue(buffer, mg_value_path(value));
       return;
     case MG_VALUE_TYPE_DATE:
-      PrintValue(os, mg_value_date(value));
+      AppendValue(buffer, mg_value_date(value));
       return;
     case MG_VALUE_TYPE_LOCAL_TIME:
-      PrintValue(os, mg_value_local_time(value));
+      AppendValue(buffer, mg_value_local_time(value));
       return;
     case MG_VALUE_TYPE_LOCAL_DATE_TIME:
-      PrintValue(os, mg_value_local_date_time(value));
+      AppendValue(buffer, mg_value_local_date_time(value));
       return;
     case MG_VALUE_TYPE_DURATION:
-      PrintValue(os, mg_value_duration(value));
+      AppendValue(buffer, mg_value_duration(value));
       return;
     case MG_VALUE_TYPE_POINT_2D:
-      PrintValue(os, mg_value_point_2d(value));
+      AppendValue(buffer, mg_value_point_2d(value));
       return;
     case MG_VALUE_TYPE_POINT_3D:
-      PrintValue(os, mg_value_point_3d(value));
+      AppendValue(buffer, mg_value_point_3d(value));
       return;
     default:
-      os << "{unknown value}";
+      buffer.append("{unknown value}");
       break;
   }
 }
 
+namespace {
+template <class T>
+void PrintThroughBuffer(std::ostream &os, const T *value) {
+  std::string buffer;
+  AppendValue(buffer, value);
+  os << buffer;
+}
+}  // namespace
+
+void PrintValue(std::ostream &os, const mg_string *str) { PrintThroughBuffer(os, str); }
+
+void PrintValue(std::ostream &os, const mg_map *map) { PrintThroughBuffer(os, map); }
+
+void PrintValue(std::ostream &os, const mg_node *node) { PrintThroughBuffer(os, node); }
+
+void PrintValue(std::ostream &os, const mg_relationship *rel) { PrintThroughBuffer(os, rel); }
+
+void PrintValue(std::ostream &os, const mg_unbound_relationship *rel) { PrintThroughBuffer(os, rel); }
+
+void PrintValue(std::ostream &os, const mg_path *path) { PrintThroughBuffer(os, path); }
+
+void PrintValue(std::ostream &os, const mg_date *date) { PrintThroughBuffer(os, date); }
+
+void PrintValue(std::ostream &os, const mg_local_time *local_time) { PrintThroughBuffer(os, local_time); }
+
+void PrintValue(std::ostream &os, const mg_local_date_time *local_date_time) {
+  PrintThroughBuffer(os, local_date_time);
+}
+
+void PrintValue(std::ostream &os, const mg_duration *duration) { PrintThroughBuffer(os, duration); }
+
+void PrintValue(std::ostream &os, const mg_value *value) { PrintThroughBuffer(os, value); }
+
 }  // namespace utils
 
 namespace {
@@ -543,6 +660,21 @@ void ColorHook(const char *input, ReplxxColor *colors, int size, void *) {
   }
 }
 
+std::vector<std::string> ParseHeader(const mg_result *result) {
+  std::vector<std::string> header;
+  const mg_list *columns = mg_result_columns(result);
+  for (uint32_t i = 0; i < mg_list_size(columns); ++i) {
+    const mg_value *field = mg_list_at(columns, i);
+    if (mg_value_get_type(field) == MG_VALUE_TYPE_STRING) {
+      header.push_back(std::string(mg_string_data(mg_value_string(field)), mg_string_size(mg_value_string(field))));
+    } else {
+      auto &name = header.emplace_back();
+      utils::AppendValue(name, field);
+    }
+  }
+  return header;
+}
+
 std::map<std::string, std::int64_t> ParseStats(const mg_value *mg_stats) {
   const mg_map *stats_map = mg_value_map(mg_stats);
   std::map<std::string, std::int64_t> stats{};
@@ -735,14 +867,43 @@ void SetStdinEcho(bool enable = true) {
 
 std::optional<std::string> GetLine() {
   std::string line;
-  std::getline(std::cin, line);
-  if (std::cin.eof()) return std::nullopt;
+  while (true) {
+    std::string part;
+    std::getline(std::cin, part);
+    line += part;
+    if (!std::cin.eof()) break;
+    // A signal without SA_RESTART interrupts the read, the input ends there once the stop is requested.
+    if (!std::ferror(stdin) || errno != EINTR || IsStopRequested()) return std::nullopt;
+    std::clearerr(stdin);
+    std::cin.clear();
+  }
   mgconsole_global_line_number++;
+  // The returned line is the default text followed by the line read from the input.
+  mgconsole_global_line_offset = mgconsole_global_input_offset;
+  mgconsole_global_line_prefix_size = mgconsole_global_default_text.size();
+  mgconsole_global_input_offset += line.size() + 1;
   line = mgconsole_global_default_text + line;
   mgconsole_global_default_text = "";
   return line;
 }
 
+bool SeekInput(uint64_t offset, int64_t line_number) {
+  std::cin.clear();
+  if (!std::cin.seekg(static_cast<std::streamoff>(offset))) {
+    std::cin.clear();
+    return false;
+  }
+  // The rest of the line is read as a whole line, hence the line before.
+  mgconsole_global_line_number = line_number - 1;
+  mgconsole_global_input_offset = offset;
+  mgconsole_global_line_offset = offset;
+  mgconsole_global_line_prefix_size = 0;
+  mgconsole_global_default_text = "";
+  mgconsole_global_default_text_offset = offset;
+  mgconsole_global_query_end_offset = offset;
+  return true;
+}
+
 ParseLineResult ParseLine(const std::string &line, char *quote, bool *escaped, bool collect_info) {
   bool is_done = false;
   std::stringstream parsed_line;
@@ -833,15 +994,38 @@ std::optional<Query> GetQuery(Replxx *replxx_instance, bool collect_info) {
   bool escaped = false;
   std::optional<console::ParseLineInfo> line_info;
 
-  auto ret = console::ParseLine(mgconsole_global_default_text, &quote, &escaped, collect_info);
-  if (ret.is_done) {
-    auto idx = ret.line.size() + 1;
-    mgconsole_global_default_text = utils::Trim(mgconsole_global_default_text.substr(idx));
+  const auto begin_offset = mgconsole_global_query_end_offset;
+  // Sets the default text to the trimmed rest of the line, text_offset is the input offset of the rest.
+  auto set_default_text = [](const std::string &rest, uint64_t text_offset) {
+    mgconsole_global_default_text = utils::Trim(rest);
+    auto leading = std::find_if(rest.begin(), rest.end(), [](unsigned char c) { return !isspace(c); });
+    mgconsole_global_default_text_offset = text_offset + (leading - rest.begin());
+  };
+  // Non-empty queries move the end offset, so that the empty ones are a part of the next query.
+  auto finish_query = [&begin_offset](std::string query, uint64_t end_offset, std::optional<QueryInfo> info) {
+    if (query.empty()) {
+      end_offset = begin_offset;
+    }
+    mgconsole_global_query_end_offset = end_offset;
     mgconsole_global_query_index++;
+    utils::perf::AddQueries(utils::perf::Phase::PARSE, 1);
     return Query{.line_number = mgconsole_global_line_number,
                  .index = mgconsole_global_query_index,
-                 .query = ret.line,
-                 .info = QueryInfoFromParseLineInfo(ret.info)};
+                 .query = std::move(query),
+                 .info = std::move(info),
+                 .begin_offset = begin_offset,
+                 .end_offset = end_offset};
+  };
+
+  auto ret = [&]() {
+    utils::perf::Scope scope(utils::perf::Phase::PARSE);
+    return console::ParseLine(mgconsole_global_default_text, &quote, &escaped, collect_info);
+  }();
+  if (ret.is_done) {
+    auto idx = ret.line.size() + 1;
+    const auto end_offset = mgconsole_global_default_text_offset + idx;
+    set_default_text(mgconsole_global_default_text.substr(idx), end_offset);
+    return finish_query(std::move(ret.line), end_offset, QueryInfoFromParseLineInfo(ret.info));
   } else {
     line_info = ret.info;
   }
@@ -850,8 +1034,17 @@ std::optional<Query> GetQuery(Replxx *replxx_instance, bool collect_info) {
   std::optional<std::string> line;
   int line_cnt = 0;
   auto is_done = false;
+  uint64_t end_offset = begin_offset;
+  // Input offset of a position in the line returned by console::GetLine.
+  auto input_offset = [](uint64_t position) {
+    if (position < mgconsole_global_line_prefix_size) {
+      return mgconsole_global_default_text_offset + position;
+    }
+    return mgconsole_global_line_offset + (position - mgconsole_global_line_prefix_size);
+  };
   while (!is_done) {
     if (!console::is_a_tty(STDIN_FILENO)) {
+      utils::perf::Scope scope(utils::perf::Phase::READ);
       line = console::GetLine();
     } else {
       line = console::ReadLine(replxx_instance, line_cnt == 0 ? constants::kPrompt : constants::kMultilinePrompt);
@@ -874,7 +1067,11 @@ std::optional<Query> GetQuery(Replxx *replxx_instance, bool collect_info) {
     }
     if (!line) return std::nullopt;
     if (line->empty()) continue;
-    auto ret = console::ParseLine(*line, &quote, &escaped, collect_info);
+    auto ret = [&]() {
+      utils::perf::Scope scope(utils::perf::Phase::PARSE);
+      return console::ParseLine(*line, &quote, &escaped, collect_info);
+    }();
+    utils::perf::AddBytes(utils::perf::Phase::PARSE, line->size());
     if (collect_info) {
       MG_ASSERT(line_info, "line_info should be defined");
       MG_ASSERT(ret.info, "returned line info should be defined");
@@ -889,24 +1086,25 @@ std::optional<Query> GetQuery(Replxx *replxx_instance, bool collect_info) {
       // Query is multiline so append newline.
       query << "\n";
     }
+    end_offset = input_offset(char_count);
     if (char_count < line->size()) {
-      mgconsole_global_default_text = utils::Trim(line->substr(char_count));
+      set_default_text(line->substr(char_count), end_offset);
     }
     ++line_cnt;
   }
-  mgconsole_global_query_index++;
-  return Query{.line_number = mgconsole_global_line_number,
-               .index = mgconsole_global_query_index,
-               .query = query.str(),
-               .info = QueryInfoFromParseLineInfo(line_info)};
+  return finish_query(query.str(), end_offset, QueryInfoFromParseLineInfo(line_info));
 }
 
 void PrintQueryInfo(const Query &query) {
   std::cout << "line: " << query.line_number << " index: " << query.index << " query: " << query.query << std::endl;
 }
 
-QueryResult ExecuteQuery(mg_session *session, const std::string &query) {
-  int status = mg_session_run(session, query.c_str(), nullptr, nullptr, nullptr, nullptr);
+QueryResult ExecuteQuery(mg_session *session, const std::string &query, RecordSink *sink) {
+  int status = 0;
+  {
+    utils::trace::Span span("run");
+    status = utils::bolt_record::Run(session, query.c_str(), nullptr);
+  }
   auto start = std::chrono::system_clock::now();
   if (status != 0) {
     if (mg_session_status(session) == MG_SESSION_BAD) {
@@ -927,7 +1125,10 @@ QueryResult ExecuteQuery(mg_session *session, const std::string &query) {
     mg_value_destroy(n_val);
     throw utils::ClientFatalException(mg_session_error(session));
   }
-  status = mg_session_pull(session, pull_information.get());
+  // Until all the records are fetched.
+  std::optional<utils::trace::Span> pull_span;
+  pull_span.emplace("pull");
+  status = utils::bolt_record::Pull(session, pull_information.get());
   if (status != 0) {
     if (mg_session_status(session) == MG_SESSION_BAD) {
       throw utils::ClientFatalException(mg_session_error(session));
@@ -938,13 +1139,32 @@ QueryResult ExecuteQuery(mg_session *session, const std::string &query) {
 
   QueryResult ret;
   mg_result *result;
-  while ((status = mg_session_fetch(session, &result)) == 1) {
-    ret.records.push_back(mg_memory::MakeCustomUnique<mg_list>(mg_list_copy(mg_result_row(result))));
-    if (!ret.records.back()) {
-      std::cerr << "out of memory";
-      std::abort();
+  {
+    utils::perf::Scope scope(utils::perf::Phase::FETCH);
+    while ((status = utils::bolt_record::Fetch(session, &result)) == 1) {
+      ++ret.num_records;
+      if (sink) {
+        // The formatting of the streamed records isn't a part of the fetching.
+        scope.Switch(utils::perf::Phase::FORMAT);
+        const auto format_start = std::chrono::steady_clock::now();
+        // The columns are known from the first record on.
+        if (ret.num_records == 1) {
+          ret.header = ParseHeader(result);
+          sink->Header(ret.header);
+        }
+        sink->Record(mg_result_row(result));
+        ret.format_time += std::chrono::steady_clock::now() - format_start;
+        scope.Switch(utils::perf::Phase::FETCH);
+        continue;
+      }
+      ret.records.push_back(mg_memory::MakeCustomUnique<mg_list>(mg_list_copy(mg_result_row(result))));
+      if (!ret.records.back()) {
+        std::cerr << "out of memory";
+        std::abort();
+      }
     }
   }
+  pull_span.reset();
   if (status != 0) {
     if (mg_session_status(session) == MG_SESSION_BAD) {
       throw utils::ClientFatalException(mg_session_error(session));
@@ -953,19 +1173,8 @@ QueryResult ExecuteQuery(mg_session *session, const std::string &query) {
     }
   }
 
-  {
-    const mg_list *header = mg_result_columns(result);
-    for (uint32_t i = 0; i < mg_list_size(header); ++i) {
-      const mg_value *field = mg_list_at(header, i);
-      if (mg_value_get_type(field) == MG_VALUE_TYPE_STRING) {
-        ret.header.push_back(
-            std::string(mg_string_data(mg_value_string(field)), mg_string_size(mg_value_string(field))));
-      } else {
-        std::stringstream field_stream;
-        utils::PrintValue(field_stream, field);
-        ret.header.push_back(field_stream.str());
-      }
-    }
+  if (ret.num_records == 0 || !sink) {
+    ret.header = ParseHeader(result);
   }
 
   const mg_map *summary = mg_result_summary(result);
@@ -1001,23 +1210,60 @@ void PrintBatchesInfo(const std::vector<Batch> &batches) {
   }
 }
 
+bool IsConflictError(std::string_view message) {
+  // NOTE: Memgraph doesn't send error codes which would tell this, so the messages are matched, e.g.
+  //   "Cannot resolve conflicting transactions. You can retry this transaction when the conflicting transaction is
+  //   finished".
+  for (const auto &pattern : constants::kConflictErrorPatterns) {
+    if (message.find(pattern) != std::string_view::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
+namespace {
+BatchResult FailedBatch(mg_session *session, std::string message, std::optional<uint64_t> failed_query = std::nullopt) {
+  BatchError error = BatchError::QUERY;
+  if (session == nullptr || mg_session_status(session) == MG_SESSION_BAD) {
+    error = BatchError::CONNECTION;
+  } else if (IsConflictError(message)) {
+    error = BatchError::CONFLICT;
+  }
+  return BatchResult{.is_executed = false,
+                     .results = {},
+                     .error = error,
+                     .failed_query = failed_query,
+                     .error_message = std::move(message)};
+}
+}  // namespace
+
 BatchResult ExecuteBatch(mg_session *session, const Batch &batch) {
   if (session == nullptr) {
     std::cout << "Session uninitialized" << std::endl;
-    return BatchResult{.is_executed = false};
+    return FailedBatch(session, "Session uninitialized");
   }
   mg_result *result;
-  auto begin_status = mg_session_begin_transaction(session, nullptr);
+  int begin_status = 0;
+  {
+    utils::trace::Span span("begin");
+    begin_status = utils::bolt_record::Begin(session);
+  }
   if (begin_status != 0) {
     auto error = mg_session_error(session);
     std::cout << "Unable to start transaction: " << error << std::endl;
-    return BatchResult{.is_executed = false};
+    return FailedBatch(session, error);
   }
   uint64_t nodes_created = 0;
   uint64_t edges_created = 0;
+  uint64_t query_i = 0;
+  // The first query which created nothing, the one to blame if the batch is rolled back.
+  std::optional<uint64_t> not_created;
   try {
-    for (const auto &query : batch.queries) {
+    for (; query_i < batch.queries.size(); ++query_i) {
+      const auto &query = batch.queries[query_i];
       auto ret = ExecuteQuery(session, query.query);
+      const auto created = nodes_created + edges_created;
       if (ret.stats) {
         auto const &stats = *ret.stats;
         if (stats.find("nodes-created") != stats.end()) {
@@ -1027,101 +1273,96 @@ BatchResult ExecuteBatch(mg_session *session, const Batch &batch) {
           edges_created += stats.at("relationships-created");
         }
       }
+      if (!not_created && nodes_created + edges_created == created) {
+        not_created = query_i;
+      }
     }
   } catch (std::exception &e) {
     std::cout << "Execution exception " << e.what() << std::endl;
-    mg_session_rollback_transaction(session, &result);
-    return BatchResult{.is_executed = false};
+    utils::trace::Span span("rollback");
+    utils::bolt_record::Rollback(session, &result);
+    return FailedBatch(session, e.what(), query_i);
   }
   // NOTE: An assumption here is that each query in a batch has at least one CREATE.
-  if (nodes_created + edges_created >= batch.queries.size()) {
-    mg_session_commit_transaction(session, &result);
+  if (!batch.check_created || nodes_created + edges_created >= batch.queries.size()) {
+    utils::trace::Span span("commit");
+    if (utils::bolt_record::Commit(session, &result) != 0) {
+      auto error = mg_session_error(session);
+      std::cout << "Unable to commit transaction: " << error << std::endl;
+      return FailedBatch(session, error);
+    }
   } else {
     std::cout << "Rollback transaction because nodes+edges=" << nodes_created + edges_created
               << " batch index: " << batch.index << " batch size: " << batch.queries.size() << std::endl;
-    mg_session_rollback_transaction(session, &result);
-    return BatchResult{.is_executed = false};
-  }
-  return BatchResult{.is_executed = true};
+    utils::trace::Span span("rollback");
+    utils::bolt_record::Rollback(session, &result);
+    // E.g. the endpoints of an edge are not there yet, they might be committed by some other batch.
+    return BatchResult{.is_executed = false,
+                       .results = {},
+                       .error = BatchError::NOT_CREATED,
+                       .failed_query = not_created,
+                       .error_message = "nothing created, a matched node might be missing"};
+  }
+  return BatchResult{.is_executed = true,
+                     .results = {},
+                     .error = BatchError::NONE,
+                     .failed_query = std::nullopt,
+                     .error_message = {},
+                     .nodes_created = nodes_created,
+                     .relationships_created = edges_created};
 }
 
 }  // namespace query
 
 namespace format {
 
-void PrintHeaderTabular(const std::vector<std::string> &data, int total_width, int column_width, int num_columns,
-                        bool all_columns_fit, int margin = 1) {
-  if (!all_columns_fit) num_columns -= 1;
-  std::string data_output = std::string(total_width, ' ');
-  for (auto i = 0; i < total_width; i += column_width) {
-    data_output[i] = '|';
-    int idx = i / column_width;
-    if (idx < num_columns) {
-      std::string field_str = data[idx];
-      if ((int)field_str.size() > column_width - 2 * margin - 1) {
-        field_str.erase(column_width - 2 * margin - 1, std::string::npos);
-        field_str.replace(field_str.size() - 3, 3, "...");
-      }
-      data_output.replace(i + 1 + margin, field_str.size(), field_str);
-    }
-  }
-  if (!all_columns_fit) {
-    data_output.replace(total_width - column_width, 3, "...");
-  }
-  data_output[total_width - 1] = '|';
-  std::cout << data_output << std::endl;
+namespace {
+constexpr uint64_t kTabularMinColumnWidth = 5;
+/// "| ..." in place of the columns which don't fit on the screen.
+constexpr uint64_t kTabularEllipsisWidth = 5;
+}  // namespace
+
+bool OutputOptions::IsStreaming() const {
+  return (output_format == constants::kTabularFormat && tabular_sample_rows > 0) ||
+         output_format == constants::kCsvFormat || output_format == constants::kJsonlFormat ||
+         output_format == constants::kArrowFormat;
 }
 
-/// Helper function for determining maximum length of data.
-/// @param data List of mg_values representing row.
-/// @param margin Column margin width.
-/// @return length needed for representing max size element in @p data list.
-/// Plus one is added because of column start character '|'.
-uint64_t GetMaxColumnWidth(const mg_memory::MgListPtr &data, int margin = 1) {
-  uint64_t column_width = 0;
-  for (uint32_t i = 0; i < mg_list_size(data.get()); ++i) {
-    std::stringstream field;
-    utils::PrintValue(field, mg_list_at(data.get(), i));
-    column_width = std::max(column_width, static_cast<uint64_t>(field.str().size() + 2 * margin));
+void TabularCells::Append(const mg_list *record) {
+  // Each cell ends where the text was after formatting it.
+  for (uint32_t i = 0; i < mg_list_size(record); ++i) {
+    const auto start = text.size();
+    utils::AppendValue(text, mg_list_at(record, i));
+    widths.push_back(utils::utf8::Width(std::string_view(text).substr(start)));
+    offsets.push_back(text.size());
   }
-  return column_width + 1;
+  rows.push_back(offsets.size() - 1);
 }
 
-uint64_t GetMaxColumnWidth(const std::vector<std::string> &data, int margin = 1) {
-  uint64_t column_width = 0;
-  for (const auto &field : data) {
-    column_width = std::max(column_width, static_cast<uint64_t>(field.size() + 2 * margin));
-  }
-  return column_width + 1;
+void TabularCells::Clear() {
+  text.clear();
+  offsets.resize(1);
+  widths.clear();
+  rows.resize(1);
 }
 
-void PrintRowTabular(const mg_memory::MgListPtr &data, int total_width, int column_width, int num_columns,
-                     bool all_columns_fit, int margin = 1) {
-  if (!all_columns_fit) num_columns -= 1;
-  std::string data_output = std::string(total_width, ' ');
-  for (auto i = 0; i < total_width; i += column_width) {
-    data_output[i] = '|';
-    int idx = i / column_width;
-    if (idx < num_columns) {
-      std::stringstream field;
-      utils::PrintValue(field, mg_list_at(data.get(), idx));  // convert Value to string
-      std::string field_str(field.str());
-      if ((int)field_str.size() > column_width - 2 * margin - 1) {
-        field_str.erase(column_width - 2 * margin - 1, std::string::npos);
-        field_str.replace(field_str.size() - 3, 3, "...");
-      }
-      data_output.replace(i + 1 + margin, field_str.size(), field_str);
-    }
-  }
-  if (!all_columns_fit) {
-    data_output.replace(total_width - column_width, 3, "...");
+TabularCells FormatTabularCells(const std::vector<mg_memory::MgListPtr> &records) {
+  TabularCells cells;
+  cells.rows.reserve(records.size() + 1);
+  for (const auto &record : records) {
+    cells.Append(record.get());
   }
-  data_output[total_width - 1] = '|';
-  std::cout << data_output << std::endl;
+  return cells;
 }
 
-void PrintTabular(const std::vector<std::string> &header, const std::vector<mg_memory::MgListPtr> &records,
-                  const bool fit_to_screen) {
+uint64_t TabularLayout::TotalWidth() const {
+  uint64_t total_width = std::accumulate(widths.begin(), widths.end(), static_cast<uint64_t>(1));
+  if (!all_columns_fit) total_width += kTabularEllipsisWidth;
+  return total_width;
+}
+
+TabularLayout MakeTabularLayout(const std::vector<std::string> &header, const TabularCells &cells,
+                                bool fit_to_screen, int margin) {
   // lifted from replxx io.cxx
   auto get_screen_columns = []() {
     int cols(0);
@@ -1139,74 +1380,197 @@ void PrintTabular(const std::vector<std::string> &header, const std::vector<mg_m
     return (cols > 0) ? cols : 80;
   };
 
-  auto window_columns = get_screen_columns();
-  bool all_columns_fit = true;
-
-  auto num_columns = header.size();
-  auto column_width = GetMaxColumnWidth(header);
-  for (size_t i = 0; i < records.size(); ++i) {
-    column_width = std::max(column_width, GetMaxColumnWidth(records[i]));
-  }
-  column_width = std::max(static_cast<uint64_t>(5),
-                          column_width);  // set column width to min 5
-  auto total_width = column_width * num_columns + 1;
-
-  // Fit to screen width.
-  if (fit_to_screen && total_width > window_columns) {
-    uint64_t lo = 5;
-    uint64_t hi = column_width;
-    uint64_t last = 5;
-    while (lo < hi) {
-      uint64_t mid = lo + (hi - lo) / 2;
-      uint64_t width = mid * num_columns + 1;
-      if (width <= window_columns) {
-        last = mid;
-        lo = mid + 1;
-      } else {
-        hi = mid - 1;
-      }
+  TabularLayout layout;
+  // Plus one is added because of column start character '|'.
+  for (const auto &field : header) {
+    layout.widths.push_back(utils::utf8::Width(field) + 2 * margin + 1);
+  }
+  for (uint64_t row = 0; row < cells.NumRows(); ++row) {
+    const auto num_cells = std::min(cells.NumCells(row), static_cast<uint64_t>(layout.widths.size()));
+    for (uint64_t column = 0; column < num_cells; ++column) {
+      layout.widths[column] =
+          std::max(layout.widths[column], static_cast<uint64_t>(cells.Width(row, column) + 2 * margin + 1));
     }
-    column_width = last;
-    total_width = column_width * num_columns + 1;
-    // All columns do not fit on screen.
-    while (total_width > window_columns && num_columns > 1) {
-      num_columns -= 1;
-      total_width = column_width * num_columns + 1;
-      all_columns_fit = false;
+  }
+  for (auto &width : layout.widths) {
+    width = std::max(kTabularMinColumnWidth, width);
+  }
+
+  const uint64_t window_columns = get_screen_columns();
+  if (!fit_to_screen || layout.TotalWidth() <= window_columns) {
+    return layout;
+  }
+  // Find the widest cap of the column widths that fits, so that only the widest columns are narrowed.
+  auto capped_width = [&layout](uint64_t cap) {
+    uint64_t total_width = 1;
+    for (auto width : layout.widths) total_width += std::min(width, cap);
+    return total_width;
+  };
+  uint64_t lo = kTabularMinColumnWidth;
+  uint64_t hi = *std::max_element(layout.widths.begin(), layout.widths.end());
+  uint64_t last = kTabularMinColumnWidth;
+  while (lo <= hi) {
+    uint64_t mid = lo + (hi - lo) / 2;
+    if (capped_width(mid) <= window_columns) {
+      last = mid;
+      lo = mid + 1;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  for (auto &width : layout.widths) {
+    width = std::min(width, last);
+  }
+  // All columns do not fit on screen.
+  while (layout.TotalWidth() > window_columns && layout.widths.size() > 1) {
+    layout.widths.pop_back();
+    layout.all_columns_fit = false;
+  }
+  return layout;
+}
+
+namespace {
+/// field_at returns the field and its display width.
+void PrintFieldsTabular(const TabularLayout &layout,
+                        const std::function<std::pair<std::string_view, uint64_t>(uint64_t)> &field_at,
+                        uint64_t num_fields, int margin) {
+  auto &data_output = utils::output::Buffer();
+  // Offsets in the line are relative to the start of the line in the output buffer.
+  const auto start = data_output.size();
+  data_output.append(layout.TotalWidth(), ' ');
+  uint64_t i = start;
+  for (uint64_t idx = 0; idx < layout.widths.size(); ++idx) {
+    const auto column_width = layout.widths[idx];
+    data_output[i] = '|';
+    if (idx < num_fields) {
+      const auto [field, width] = field_at(idx);
+      const auto max_width = column_width - 2 * margin - 1;
+      auto size = field.size();
+      auto shown_width = width;
+      uint64_t dots = 0;
+      if (width > max_width) {
+        dots = std::min(max_width, static_cast<uint64_t>(3));
+        std::tie(size, shown_width) = utils::utf8::Prefix(field, max_width - dots);
+      }
+      // Multi-byte characters take more bytes than columns, the line grows by the difference.
+      const auto extra = size - shown_width;
+      if (extra > 0) data_output.insert(i + 1 + margin, extra, ' ');
+      data_output.replace(i + 1 + margin, size, field.data(), size);
+      if (dots > 0) data_output.replace(i + 1 + margin + size, dots, dots, '.');
+      i += extra;
     }
+    i += column_width;
+  }
+  if (!layout.all_columns_fit) {
+    data_output[i] = '|';
+    data_output.replace(i + 1 + margin, 3, "...");
   }
+  data_output.back() = '|';
+  data_output.push_back('\n');
+  utils::output::Commit();
+}
+}  // namespace
 
-  auto line_fill = std::string(total_width, '-');
-  for (auto i = 0u; i < total_width; i += column_width) {
+void PrintLineTabular(const TabularLayout &layout) {
+  auto &line_fill = utils::output::Buffer();
+  const auto start = line_fill.size();
+  line_fill.append(layout.TotalWidth(), '-');
+  uint64_t i = start;
+  for (auto width : layout.widths) {
     line_fill[i] = '+';
+    i += width;
   }
-  line_fill[total_width - 1] = '+';
-  std::cout << line_fill << std::endl;
-  // Print Header.
-  PrintHeaderTabular(header, total_width, column_width, num_columns, all_columns_fit);
-  std::cout << line_fill << std::endl;
-  // Print Records.
-  for (size_t i = 0; i < records.size(); ++i) {
-    PrintRowTabular(records[i], total_width, column_width, num_columns, all_columns_fit);
+  line_fill[i] = '+';
+  line_fill.back() = '+';
+  line_fill.push_back('\n');
+  utils::output::Commit();
+}
+
+void PrintHeaderTabular(const std::vector<std::string> &data, const TabularLayout &layout, int margin) {
+  PrintFieldsTabular(
+      layout,
+      [&data](uint64_t idx) { return std::pair(std::string_view(data[idx]), utils::utf8::Width(data[idx])); },
+      data.size(), margin);
+}
+
+void PrintRowTabular(const TabularCells &cells, uint64_t row, const TabularLayout &layout, int margin) {
+  PrintFieldsTabular(
+      layout, [&cells, row](uint64_t idx) { return std::pair(cells.Cell(row, idx), cells.Width(row, idx)); },
+      cells.NumCells(row), margin);
+}
+
+void PrintTabular(const std::vector<std::string> &header, const std::vector<mg_memory::MgListPtr> &records,
+                  const bool fit_to_screen) {
+  // Each cell is formatted once, both for the width and for the output.
+  const auto cells = FormatTabularCells(records);
+  const auto layout = MakeTabularLayout(header, cells, fit_to_screen);
+  PrintLineTabular(layout);
+  PrintHeaderTabular(header, layout);
+  PrintLineTabular(layout);
+  for (uint64_t i = 0; i < cells.NumRows(); ++i) {
+    PrintRowTabular(cells, i, layout);
+  }
+  PrintLineTabular(layout);
+}
+
+void TabularStream::Header(const std::vector<std::string> &header) { header_ = header; }
+
+void TabularStream::Record(const mg_list *record) {
+  cells_.Append(record);
+  if (layout_) {
+    PrintRowTabular(cells_, 0, *layout_);
+    cells_.Clear();
+  } else if (cells_.NumRows() == sample_rows_) {
+    PrintSample();
+  }
+}
+
+void TabularStream::PrintSample() {
+  layout_ = MakeTabularLayout(header_, cells_, fit_to_screen_);
+  PrintLineTabular(*layout_);
+  PrintHeaderTabular(header_, *layout_);
+  PrintLineTabular(*layout_);
+  for (uint64_t i = 0; i < cells_.NumRows(); ++i) {
+    PrintRowTabular(cells_, i, *layout_);
+  }
+  cells_.Clear();
+  // The first rows are shown right away, the rest is written in kBufferSize chunks.
+  utils::output::Flush();
+}
+
+void TabularStream::Finish() {
+  if (!layout_) {
+    // Nothing is printed for an empty result.
+    if (cells_.NumRows() == 0) return;
+    PrintSample();
   }
-  std::cout << line_fill << std::endl;
+  PrintLineTabular(*layout_);
+  utils::output::Flush();
+}
+
+void AppendCsvQuoted(std::string &buffer, std::string_view field, const CsvOptions &csv_opts) {
+  const std::string_view escape = csv_opts.doublequote ? std::string_view("\"") : csv_opts.escapechar;
+  buffer.reserve(buffer.size() + field.size() + 2);
+  buffer.push_back('"');
+  for (size_t pos = 0;;) {
+    const auto quote = utils::scan::FindQuote(field, pos);
+    buffer.append(field.data() + pos, quote - pos);
+    if (quote == field.size()) break;
+    buffer.append(escape);
+    buffer.push_back('"');
+    pos = quote + 1;
+  }
+  buffer.push_back('"');
 }
 
 std::vector<std::string> FormatCsvFields(const mg_memory::MgListPtr &fields, const CsvOptions &csv_opts) {
   std::vector<std::string> formatted;
   formatted.reserve(mg_list_size(fields.get()));
+  std::string value;
   for (uint32_t i = 0; i < mg_list_size(fields.get()); ++i) {
-    std::stringstream field_stream;
-    utils::PrintValue(field_stream, mg_list_at(fields.get(), i));
-    std::string formatted_field(field_stream.str());
-    if (csv_opts.doublequote) {
-      formatted_field = utils::Replace(formatted_field, "\"", "\"\"");
-    } else {
-      formatted_field = utils::Replace(formatted_field, "\"", csv_opts.escapechar + "\"");
-    }
-    formatted_field.insert(0, 1, '"');
-    formatted_field.append(1, '"');
-    formatted.push_back(formatted_field);
+    value.clear();
+    utils::AppendValue(value, mg_list_at(fields.get(), i));
+    AppendCsvQuoted(formatted.emplace_back(), value, csv_opts);
   }
   return formatted;
 }
@@ -1214,31 +1578,93 @@ std::vector<std::string> FormatCsvFields(const mg_memory::MgListPtr &fields, con
 std::vector<std::string> FormatCsvHeader(const std::vector<std::string> &fields, const CsvOptions &csv_opts) {
   std::vector<std::string> formatted;
   formatted.reserve(fields.size());
-  for (auto formatted_field : fields) {
-    if (csv_opts.doublequote) {
-      formatted_field = utils::Replace(formatted_field, "\"", "\"\"");
-    } else {
-      formatted_field = utils::Replace(formatted_field, "\"", csv_opts.escapechar + "\"");
-    }
-    formatted_field.insert(0, 1, '"');
-    formatted_field.append(1, '"');
-    formatted.push_back(formatted_field);
+  for (const auto &field : fields) {
+    AppendCsvQuoted(formatted.emplace_back(), field, csv_opts);
   }
   return formatted;
 }
 
+void AppendCsvRows(std::string &buffer, std::span<const mg_memory::MgListPtr> records, const CsvOptions &csv_opts) {
+  // Reused by the fields, the values are quoted straight into the buffer.
+  std::string value;
+  for (const auto &record : records) {
+    for (uint32_t i = 0; i < mg_list_size(record.get()); ++i) {
+      if (i > 0) buffer.append(csv_opts.delimiter);
+      value.clear();
+      utils::AppendValue(value, mg_list_at(record.get(), i));
+      AppendCsvQuoted(buffer, value, csv_opts);
+    }
+    buffer.push_back('\n');
+  }
+}
+
+namespace {
+void PrintCsvHeader(const std::vector<std::string> &header, const CsvOptions &csv_opts) {
+  auto &out = utils::output::Buffer();
+  for (size_t i = 0; i < header.size(); ++i) {
+    if (i > 0) out.append(csv_opts.delimiter);
+    AppendCsvQuoted(out, header[i], csv_opts);
+  }
+  out.push_back('\n');
+  utils::output::Commit();
+}
+
+ParallelFormatter::FormatChunk CsvChunkFormatter(const CsvOptions &csv_opts) {
+  return [csv_opts](std::string &buffer, ParallelFormatter::Rows rows) { AppendCsvRows(buffer, rows, csv_opts); };
+}
+}  // namespace
+
 void PrintCsv(const std::vector<std::string> &header, const std::vector<mg_memory::MgListPtr> &records,
-              const CsvOptions &csv_opts) {
+              const CsvOptions &csv_opts, uint64_t workers) {
   // Print Header.
-  auto formatted_header = FormatCsvHeader(header, csv_opts);
-  utils::PrintIterable(std::cout, formatted_header, csv_opts.delimiter);
-  std::cout << std::endl;
+  PrintCsvHeader(header, csv_opts);
   // Print Records.
-  for (size_t i = 0; i < records.size(); ++i) {
-    auto formatted_row = FormatCsvFields(records[i], csv_opts);
-    utils::PrintIterable(std::cout, formatted_row, csv_opts.delimiter);
-    std::cout << std::endl;
+  ParallelFormatter formatter(CsvChunkFormatter(csv_opts), workers);
+  for (size_t i = 0; i < records.size(); i += kFormatChunkRows) {
+    formatter.Add(std::span(records).subspan(i, std::min(kFormatChunkRows, records.size() - i)));
+  }
+  formatter.Finish();
+}
+
+std::vector<std::string> MakeJsonKeys(const std::vector<std::string> &header) {
+  std::vector<std::string> keys;
+  keys.reserve(header.size());
+  for (const auto &column : header) {
+    auto &key = keys.emplace_back();
+    utils::json::AppendString(key, column);
+    key.push_back(':');
+  }
+  return keys;
+}
+
+void AppendJsonlRows(std::string &buffer, std::span<const mg_memory::MgListPtr> records,
+                     const std::vector<std::string> &keys) {
+  for (const auto &record : records) {
+    buffer.push_back('{');
+    for (uint32_t i = 0; i < mg_list_size(record.get()) && i < keys.size(); ++i) {
+      if (i > 0) buffer.push_back(',');
+      buffer.append(keys[i]);
+      utils::json::AppendValue(buffer, mg_list_at(record.get(), i));
+    }
+    buffer.append("}\n");
+  }
+}
+
+namespace {
+ParallelFormatter::FormatChunk JsonlChunkFormatter(const std::vector<std::string> &header) {
+  return [keys = MakeJsonKeys(header)](std::string &buffer, ParallelFormatter::Rows rows) {
+    AppendJsonlRows(buffer, rows, keys);
+  };
+}
+}  // namespace
+
+void PrintJsonl(const std::vector<std::string> &header, const std::vector<mg_memory::MgListPtr> &records,
+                uint64_t workers) {
+  ParallelFormatter formatter(JsonlChunkFormatter(header), workers);
+  for (size_t i = 0; i < records.size(); i += kFormatChunkRows) {
+    formatter.Add(std::span(records).subspan(i, std::min(kFormatChunkRows, records.size() - i)));
   }
+  formatter.Finish();
 }
 
 void PrintCypherl(const std::vector<std::string> &header, const std::vector<mg_memory::MgListPtr> &records) {
@@ -1255,21 +1681,88 @@ void PrintCypherl(const std::vector<std::string> &header, const std::vector<mg_m
                   << std::endl;
         std::exit(1);
       }
-      const auto *query_ptr = mg_value_string(value_ptr);
-      std::cout << std::string(mg_string_data(query_ptr), mg_string_size(query_ptr)) << std::endl;
+      auto &out = utils::output::Buffer();
+      utils::AppendStringUnescaped(out, mg_value_string(value_ptr));
+      out.push_back('\n');
+      utils::output::Commit();
     }
   }
 }
 
 void Output(const std::vector<std::string> &header, const std::vector<mg_memory::MgListPtr> &records,
             const OutputOptions &out_opts, const CsvOptions &csv_opts) {
+  utils::perf::Scope scope(utils::perf::Phase::FORMAT);
   if (out_opts.output_format == constants::kTabularFormat) {
     PrintTabular(header, records, out_opts.fit_to_screen);
   } else if (out_opts.output_format == constants::kCsvFormat) {
-    PrintCsv(header, records, csv_opts);
+    PrintCsv(header, records, csv_opts, out_opts.format_workers);
   } else if (out_opts.output_format == constants::kCypherlFormat) {
     PrintCypherl(header, records);
+  } else if (out_opts.output_format == constants::kJsonlFormat) {
+    PrintJsonl(header, records, out_opts.format_workers);
+  } else if (out_opts.output_format == constants::kArrowFormat) {
+    PrintArrow(header, records, out_opts.arrow_batch_rows);
+  }
+  utils::output::Flush();
+}
+
+ChunkedStream::ChunkedStream(Start start, uint64_t workers) : start_(std::move(start)), workers_(workers) {
+  chunk_.reserve(kFormatChunkRows);
+}
+
+ChunkedStream::~ChunkedStream() = default;
+
+void ChunkedStream::Header(const std::vector<std::string> &header) {
+  formatter_ = std::make_unique<ParallelFormatter>(start_(header), workers_);
+}
+
+void ChunkedStream::Record(const mg_list *record) {
+  chunk_.push_back(mg_memory::MakeCustomUnique<mg_list>(mg_list_copy(record)));
+  if (!chunk_.back()) {
+    std::cerr << "out of memory";
+    std::abort();
+  }
+  if (chunk_.size() == kFormatChunkRows) {
+    formatter_->Add(std::move(chunk_));
+    chunk_.clear();
+    chunk_.reserve(kFormatChunkRows);
+  }
+}
+
+void ChunkedStream::Finish() {
+  if (!formatter_) {
+    // No records.
+    return;
+  }
+  if (!chunk_.empty()) {
+    formatter_->Add(std::move(chunk_));
+    chunk_.clear();
+  }
+  formatter_->Finish();
+  utils::output::Flush();
+}
+
+std::unique_ptr<query::RecordSink> MakeRecordSink(const OutputOptions &out_opts, const CsvOptions &csv_opts) {
+  if (!out_opts.IsStreaming()) {
+    return nullptr;
+  }
+  if (out_opts.output_format == constants::kCsvFormat) {
+    return std::make_unique<ChunkedStream>(
+        [csv_opts](const std::vector<std::string> &header) {
+          PrintCsvHeader(header, csv_opts);
+          return CsvChunkFormatter(csv_opts);
+        },
+        out_opts.format_workers);
+  }
+  if (out_opts.output_format == constants::kJsonlFormat) {
+    return std::make_unique<ChunkedStream>(
+        [](const std::vector<std::string> &header) { return JsonlChunkFormatter(header); },
+        out_opts.format_workers);
+  }
+  if (out_opts.output_format == constants::kArrowFormat) {
+    return std::make_unique<ArrowStream>(out_opts.arrow_batch_rows);
   }
+  return std::make_unique<TabularStream>(out_opts);
 }
 
 }  // namespace format
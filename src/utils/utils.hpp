@@ -17,11 +17,14 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <functional>
 #include <iostream>
 #include <map>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #ifdef _WIN32
@@ -118,13 +121,15 @@ std::string Trim(const std::string &s);
 /**
  * replaces all occurences of <match> in <src> with <replacement>.
  */
-// todo: this could be implemented much more efficiently.
 std::string Replace(std::string src, const std::string &match, const std::string &replacement);
 
 /// escapes all whitespace and quotation characters to produce a string
 /// which can be used as a string literal.
 std::string Escape(const std::string &src);
 
+/// Escape which appends to the buffer.
+void AppendEscaped(std::string &buffer, std::string_view src);
+
 /**
  * outputs a collection of items to the given stream, separating them with the
  * given delimiter.
@@ -147,6 +152,43 @@ inline void PrintIterable(tstream &stream, const titerable &iterable, const std:
   }
 }
 
+/// The Append* functions format the values in the same way as PrintValue, but they append to a buffer which can be
+/// reused between the values (clear() keeps its capacity), and the numbers are formatted by std::to_chars instead of
+/// the locale aware streams. Floats are written in the shortest form which parses back to the same value.
+void AppendInteger(std::string &buffer, int64_t value);
+
+void AppendFloat(std::string &buffer, double value);
+
+void AppendStringUnescaped(std::string &buffer, const mg_string *str);
+
+void AppendValue(std::string &buffer, const mg_string *str);
+
+void AppendValue(std::string &buffer, const mg_list *list);
+
+void AppendValue(std::string &buffer, const mg_map *map);
+
+void AppendValue(std::string &buffer, const mg_node *node);
+
+void AppendValue(std::string &buffer, const mg_relationship *rel);
+
+void AppendValue(std::string &buffer, const mg_unbound_relationship *rel);
+
+void AppendValue(std::string &buffer, const mg_path *path);
+
+void AppendValue(std::string &buffer, const mg_date *date);
+
+void AppendValue(std::string &buffer, const mg_local_time *local_time);
+
+void AppendValue(std::string &buffer, const mg_local_date_time *local_date_time);
+
+void AppendValue(std::string &buffer, const mg_duration *duration);
+
+void AppendValue(std::string &buffer, const mg_point_2d *value);
+
+void AppendValue(std::string &buffer, const mg_point_3d *value);
+
+void AppendValue(std::string &buffer, const mg_value *value);
+
 void PrintStringUnescaped(std::ostream &os, const mg_string *str);
 
 void PrintValue(std::ostream &os, const mg_string *str);
@@ -180,6 +222,13 @@ static std::string mgconsole_global_default_text;
 // The following variables are used to track the line number and index (number specifying order) of the processed query.
 [[maybe_unused]] static int64_t mgconsole_global_line_number{0};
 [[maybe_unused]] static int64_t mgconsole_global_query_index{0};
+// Byte offsets in the input: the next unread byte, the start of the last line (see console::GetLine for the prefix),
+// the first byte of the default text and the end of the last non-empty query.
+[[maybe_unused]] static uint64_t mgconsole_global_input_offset{0};
+[[maybe_unused]] static uint64_t mgconsole_global_line_offset{0};
+[[maybe_unused]] static uint64_t mgconsole_global_line_prefix_size{0};
+[[maybe_unused]] static uint64_t mgconsole_global_default_text_offset{0};
+[[maybe_unused]] static uint64_t mgconsole_global_query_end_offset{0};
 
 namespace console {
 
@@ -206,6 +255,10 @@ void SetStdinEcho(bool enable);
 
 std::optional<std::string> GetLine();
 
+/// Continues reading the input from the given byte offset, which has to be the end of a query. line_number is the line
+/// the offset is on. Returns false if the input can't be seeked (e.g. it's a pipe).
+bool SeekInput(uint64_t offset, int64_t line_number);
+
 struct ParseLineInfo {
   query::line::CollectedClauses collected_clauses;
 };
@@ -283,6 +336,10 @@ struct Query {
   int64_t index{0};
   std::string query{""};
   std::optional<QueryInfo> info{std::nullopt};
+  /// [begin_offset, end_offset) is the part of the input the query was read from, the end is right after the ';'. The
+  /// ranges of consecutive non-empty queries are adjacent (empty queries and comments belong to the next query).
+  uint64_t begin_offset{0};
+  uint64_t end_offset{0};
 };
 void PrintQueryInfo(const Query &);
 
@@ -300,28 +357,76 @@ struct Batch {
   bool is_executed = false;
   int64_t backoff = 1;
   int64_t attempts = 0;
+  /// Sorted vertex keys (see query_keys.hpp) touched by the batch, empty if keys were not collected.
+  std::vector<uint64_t> keys;
+  /// Set if the batch touches vertices which couldn't be keyed, such batch conflicts with any other batch.
+  bool unkeyed = false;
+  /// If set, ExecuteBatch rolls the batch back unless the queries created at least one node or relationship each.
+  /// E.g. MERGE doesn't create anything when the pattern already exists.
+  bool check_created = true;
 };
 void PrintBatchesInfo(const std::vector<Batch> &);
 
 struct QueryResult {
   std::vector<std::string> header;
   std::vector<mg_memory::MgListPtr> records;
+  /// Number of the fetched records, also when they were passed to a RecordSink instead of stored in records.
+  uint64_t num_records{0};
   std::chrono::duration<double> wall_time;
+  /// Time spent formatting the records passed to the RecordSink, a part of wall_time.
+  std::chrono::nanoseconds format_time{0};
   std::optional<std::map<std::string, std::string>> notification;
   std::optional<std::map<std::string, std::int64_t>> stats;
   std::optional<std::map<std::string, double>> execution_info;
 };
 
+/// Why a batch wasn't executed.
+enum class BatchError {
+  NONE,
+  /// Serialization error, conflicting transactions, ... -> the same batch passes once the other transactions finish.
+  CONFLICT,
+  /// A query created nothing, e.g. the endpoints of an edge aren't there yet -> the same batch might pass once some
+  /// other batch commits them, or never if they are missing.
+  NOT_CREATED,
+  /// The query itself is wrong (syntax, constraint violation, ...) -> the same batch will fail again.
+  QUERY,
+  /// The session is broken -> reconnect.
+  CONNECTION,
+};
+
 struct BatchResult {
   bool is_executed;
   std::vector<QueryResult> results;
+  BatchError error{BatchError::NONE};
+  /// Position of the failed query inside the batch if the batch failed because of a single query.
+  std::optional<uint64_t> failed_query{std::nullopt};
+  std::string error_message{};
+  /// From the stats of the committed queries.
+  uint64_t nodes_created{0};
+  uint64_t relationships_created{0};
 };
 
+/// Returns true if the database error message says the transaction might pass if retried.
+bool IsConflictError(std::string_view message);
+
 // Depends on the global static string because of ...; MATCH
 // The extra part is preserved for the next GetQuery call
 std::optional<Query> GetQuery(Replxx *replxx_instance, bool collect_info = false);
 
-QueryResult ExecuteQuery(mg_session *session, const std::string &query);
+/// Receives the records while they are fetched, so that they don't have to be kept in memory.
+class RecordSink {
+ public:
+  virtual ~RecordSink() = default;
+  /// Called before the first record.
+  virtual void Header(const std::vector<std::string> &header) = 0;
+  /// The record is valid only during the call.
+  virtual void Record(const mg_list *record) = 0;
+  /// Called by the user of the sink once the query is done.
+  virtual void Finish() = 0;
+};
+
+/// If sink is set, the records are passed to it instead of stored in QueryResult::records.
+QueryResult ExecuteQuery(mg_session *session, const std::string &query, RecordSink *sink = nullptr);
 BatchResult ExecuteBatch(mg_session *session, const Batch &batch);
 
 }  // namespace query
@@ -345,40 +450,158 @@ struct CsvOptions {
 };
 
 struct OutputOptions {
-  OutputOptions(std::string out_format, const bool fit_to_scr)
-      : output_format(std::move(out_format)), fit_to_screen(fit_to_scr) {}
+  OutputOptions(std::string out_format, const bool fit_to_scr, const uint64_t sample_rows = 0,
+                const uint64_t workers = 0, const uint64_t batch_rows = 65536)
+      : output_format(std::move(out_format)),
+        fit_to_screen(fit_to_scr),
+        tabular_sample_rows(sample_rows),
+        format_workers(workers),
+        arrow_batch_rows(batch_rows) {}
+
+  /// The output is printed while the records are fetched, see MakeRecordSink.
+  bool IsStreaming() const;
 
   std::string output_format;
   bool fit_to_screen;
+  /// If not 0, the widths of the tabular columns are estimated from that many first records.
+  uint64_t tabular_sample_rows;
+  /// Threads formatting the CSV output, 0 means the number of cores.
+  uint64_t format_workers;
+  /// The records in each Arrow record batch.
+  uint64_t arrow_batch_rows;
 };
 
-void PrintHeaderTabular(const std::vector<std::string> &data, int total_width, int column_width, int num_columns,
-                        bool all_columns_fit, int margin);
+/// The cells of the records, each one formatted once into a shared buffer.
+struct TabularCells {
+  /// The text of the cell c of the row r is [offsets[k], offsets[k + 1]) where k = rows[r] + c.
+  std::string_view Cell(uint64_t row, uint64_t column) const {
+    const auto k = rows[row] + column;
+    return std::string_view(text).substr(offsets[k], offsets[k + 1] - offsets[k]);
+  }
+  /// The display width of the cell, see utf8::Width.
+  uint64_t Width(uint64_t row, uint64_t column) const { return widths[rows[row] + column]; }
+  uint64_t NumRows() const { return rows.size() - 1; }
+  uint64_t NumCells(uint64_t row) const { return rows[row + 1] - rows[row]; }
+
+  /// Formats the values of the record as the next row.
+  void Append(const mg_list *record);
+  void Clear();
+
+  std::string text;
+  std::vector<uint64_t> offsets{0};
+  /// The display width of each cell, measured once when it's formatted.
+  std::vector<uint64_t> widths;
+  /// Index of the first cell of each row, plus the end of the last row.
+  std::vector<uint64_t> rows{0};
+};
+
+TabularCells FormatTabularCells(const std::vector<mg_memory::MgListPtr> &records);
 
-/// Helper function for determining maximum length of data.
-/// @param data List of mg_values representing row.
+/// Widths of the printed tabular columns, each one includes the margins and the column start character '|'.
+struct TabularLayout {
+  std::vector<uint64_t> widths;
+  /// If not all columns fit on the screen, the rest is replaced by a "..." column.
+  bool all_columns_fit{true};
+
+  uint64_t TotalWidth() const;
+};
+
+/// Each column is as wide as its widest cell (at least 5 columns), measured in terminal columns rather than bytes. With
+/// fit_to_screen, the widest columns are narrowed first, and the columns which still don't fit are left out.
+/// @param header The column names.
+/// @param cells The formatted cells of the (sampled) records.
 /// @param margin Column margin width.
-/// @return length needed for representing max size element in @p data list.
-/// Plus one is added because of column start character '|'.
-uint64_t GetMaxColumnWidth(const mg_memory::MgListPtr &data, int margin);
+TabularLayout MakeTabularLayout(const std::vector<std::string> &header, const TabularCells &cells,
+                                bool fit_to_screen, int margin = 1);
+
+void PrintLineTabular(const TabularLayout &layout);
 
-uint64_t GetMaxColumnWidth(const std::vector<std::string> &data, int margin);
+void PrintHeaderTabular(const std::vector<std::string> &data, const TabularLayout &layout, int margin = 1);
 
-void PrintRowTabular(const mg_memory::MgListPtr &data, int total_width, int column_width, int num_columns,
-                     bool all_columns_fit, int margin);
+/// Cells wider than the column are truncated and end with "...", never in the middle of a character.
+void PrintRowTabular(const TabularCells &cells, uint64_t row, const TabularLayout &layout, int margin = 1);
 
 void PrintTabular(const std::vector<std::string> &header, const std::vector<mg_memory::MgListPtr> &records,
                   const bool fit_to_screen);
 
+/// Appends the field in double quotes, the quotes in it are escaped with CsvOptions::escapechar or doubled.
+void AppendCsvQuoted(std::string &buffer, std::string_view field, const CsvOptions &csv_opts);
+
 std::vector<std::string> FormatCsvFields(const mg_memory::MgListPtr &fields, const CsvOptions &csv_opts);
 
 std::vector<std::string> FormatCsvHeader(const std::vector<std::string> &fields, const CsvOptions &csv_opts);
 
+/// Appends the CSV lines of the records to the buffer, thread-safe.
+void AppendCsvRows(std::string &buffer, std::span<const mg_memory::MgListPtr> records, const CsvOptions &csv_opts);
+
+/// Appends a JSON object per record, {"<column>": <value>, ...}, see json.hpp. keys are the JSON encoded column names
+/// followed by ':' (MakeJsonKeys), thread-safe.
+void AppendJsonlRows(std::string &buffer, std::span<const mg_memory::MgListPtr> records,
+                     const std::vector<std::string> &keys);
+
+std::vector<std::string> MakeJsonKeys(const std::vector<std::string> &header);
+
+/// The records are formatted in chunks on workers threads (0 means the number of cores), see ParallelFormatter.
 void PrintCsv(const std::vector<std::string> &header, const std::vector<mg_memory::MgListPtr> &records,
-              const CsvOptions &csv_opts);
+              const CsvOptions &csv_opts, uint64_t workers = 0);
+
+/// The records are formatted in chunks on workers threads (0 means the number of cores), see ParallelFormatter.
+void PrintJsonl(const std::vector<std::string> &header, const std::vector<mg_memory::MgListPtr> &records,
+                uint64_t workers = 0);
 
 void Output(const std::vector<std::string> &header, const std::vector<mg_memory::MgListPtr> &records,
             const OutputOptions &out_opts, const CsvOptions &csv_opts);
+
+/// Prints the tabular output while the records are fetched, without keeping them in memory. The widths of the
+/// columns are estimated from the first OutputOptions::tabular_sample_rows records, the longer cells of the later
+/// records are truncated.
+class TabularStream : public query::RecordSink {
+ public:
+  explicit TabularStream(const OutputOptions &out_opts)
+      : sample_rows_(out_opts.tabular_sample_rows), fit_to_screen_(out_opts.fit_to_screen) {}
+
+  void Header(const std::vector<std::string> &header) override;
+  void Record(const mg_list *record) override;
+  /// Prints the end of the table (or the whole table if there were less records than the sample).
+  void Finish() override;
+
+ private:
+  void PrintSample();
+
+  uint64_t sample_rows_;
+  bool fit_to_screen_;
+  std::vector<std::string> header_;
+  /// The sampled records, and after the layout is known, the record being printed.
+  TabularCells cells_;
+  std::optional<TabularLayout> layout_;
+};
+
+class ParallelFormatter;
+
+/// Prints the output while the records are fetched. The records are grouped into chunks which are formatted in
+/// parallel, see ParallelFormatter.
+class ChunkedStream : public query::RecordSink {
+ public:
+  /// Called with the header, prints what comes before the records and returns the formatter of the chunks.
+  using Start = std::function<std::function<void(std::string &, std::span<const mg_memory::MgListPtr>)>(
+      const std::vector<std::string> &header)>;
+
+  ChunkedStream(Start start, uint64_t workers);
+  ~ChunkedStream() override;
+
+  void Header(const std::vector<std::string> &header) override;
+  void Record(const mg_list *record) override;
+  void Finish() override;
+
+ private:
+  Start start_;
+  uint64_t workers_;
+  std::unique_ptr<ParallelFormatter> formatter_;
+  std::vector<mg_memory::MgListPtr> chunk_;
+};
+
+/// The sink printing the output while the records are fetched, nullptr if the output format needs the whole result.
+std::unique_ptr<query::RecordSink> MakeRecordSink(const OutputOptions &out_opts, const CsvOptions &csv_opts);
 }  // namespace format
 
 Replxx *InitAndSetupReplxx();
@@ -0,0 +1,275 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mgclient.h"
+
+#include "utils/utils.hpp"
+
+// Synthetic data for the microbenchmarks. Every builder returns a freshly allocated value owned by the caller, the
+// compound ones take the ownership of their parts (same as the mgclient *_make functions they call).
+namespace fixtures {
+
+inline mg_map *MakeProperties(int count) {
+  auto *map = mg_map_make_empty(count);
+  for (int i = 0; i < count; ++i) {
+    auto key = "property_" + std::to_string(i);
+    if (i % 2 == 0) {
+      mg_map_insert(map, key.c_str(), mg_value_make_integer(i * 1000));
+    } else {
+      mg_map_insert(map, key.c_str(), mg_value_make_string("a \"quoted\" string,\twith\nspecial characters"));
+    }
+  }
+  return map;
+}
+
+inline mg_node *MakeNode(int64_t id, int label_count = 2, int property_count = 4) {
+  std::vector<mg_string *> labels;
+  for (int i = 0; i < label_count; ++i) {
+    labels.push_back(mg_string_make(("Label" + std::to_string(i)).c_str()));
+  }
+  return mg_node_make(id, labels.size(), labels.data(), MakeProperties(property_count));
+}
+
+inline mg_relationship *MakeRelationship(int64_t id, int property_count = 2) {
+  return mg_relationship_make(id, id, id + 1, mg_string_make("CONNECTED_TO"), MakeProperties(property_count));
+}
+
+inline mg_unbound_relationship *MakeUnboundRelationship(int64_t id, int property_count = 2) {
+  return mg_unbound_relationship_make(id, mg_string_make("CONNECTED_TO"), MakeProperties(property_count));
+}
+
+/// A path going through `length` relationships, (n0)-[r0]->(n1)-[r1]->...
+inline mg_path *MakePath(int length) {
+  std::vector<mg_node *> nodes;
+  std::vector<mg_unbound_relationship *> relationships;
+  std::vector<int64_t> sequence;
+  for (int i = 0; i <= length; ++i) {
+    nodes.push_back(MakeNode(i, 1, 1));
+  }
+  for (int i = 0; i < length; ++i) {
+    relationships.push_back(MakeUnboundRelationship(i, 1));
+    // Relationship indices are 1-based, positive ones are traversed in their direction.
+    sequence.push_back(i + 1);
+    sequence.push_back(i + 1);
+  }
+  return mg_path_make(nodes.size(), nodes.data(), relationships.size(), relationships.data(), sequence.size(),
+                      sequence.data());
+}
+
+enum class ValueType {
+  NULL_VALUE,
+  BOOL,
+  INTEGER,
+  FLOAT,
+  STRING,
+  LIST,
+  MAP,
+  NODE,
+  RELATIONSHIP,
+  UNBOUND_RELATIONSHIP,
+  PATH,
+  DATE,
+  LOCAL_TIME,
+  LOCAL_DATE_TIME,
+  DURATION,
+  POINT_2D,
+  POINT_3D,
+};
+
+inline mg_value *MakeValue(ValueType type) {
+  switch (type) {
+    case ValueType::NULL_VALUE:
+      return mg_value_make_null();
+    case ValueType::BOOL:
+      return mg_value_make_bool(1);
+    case ValueType::INTEGER:
+      return mg_value_make_integer(1234567890123);
+    case ValueType::FLOAT:
+      return mg_value_make_float(3.14159265358979);
+    case ValueType::STRING:
+      return mg_value_make_string("a \"quoted\" string,\twith\nspecial characters");
+    case ValueType::LIST: {
+      auto *list = mg_list_make_empty(16);
+      for (int i = 0; i < 16; ++i) {
+        mg_list_append(list, i % 2 ? mg_value_make_integer(i) : mg_value_make_string("item"));
+      }
+      return mg_value_make_list(list);
+    }
+    case ValueType::MAP:
+      return mg_value_make_map(MakeProperties(16));
+    case ValueType::NODE:
+      return mg_value_make_node(MakeNode(42));
+    case ValueType::RELATIONSHIP:
+      return mg_value_make_relationship(MakeRelationship(42));
+    case ValueType::UNBOUND_RELATIONSHIP:
+      return mg_value_make_unbound_relationship(MakeUnboundRelationship(42));
+    case ValueType::PATH:
+      return mg_value_make_path(MakePath(8));
+    case ValueType::DATE:
+      return mg_value_make_date(mg_date_make(19000));
+    case ValueType::LOCAL_TIME:
+      return mg_value_make_local_time(mg_local_time_make(45296789000000));
+    case ValueType::LOCAL_DATE_TIME:
+      return mg_value_make_local_date_time(mg_local_date_time_make(1641651296, 789000000));
+    case ValueType::DURATION:
+      return mg_value_make_duration(mg_duration_make(14, 3, 45296, 789000000));
+    case ValueType::POINT_2D:
+      // WGS-84 longitude and latitude.
+      return mg_value_make_point_2d(mg_point_2d_make(4326, 15.9819, 45.815));
+    case ValueType::POINT_3D:
+      // WGS-84 3D, with the height.
+      return mg_value_make_point_3d(mg_point_3d_make(4979, 15.9819, 45.815, 158.0));
+  }
+  return mg_value_make_null();
+}
+
+/// A result row, columns cycle through a mix of scalars, a node and a relationship.
+inline mg_memory::MgListPtr MakeRow(int64_t index, int columns) {
+  auto row = mg_memory::MakeCustomUnique<mg_list>(mg_list_make_empty(columns));
+  for (int i = 0; i < columns; ++i) {
+    switch (i % 5) {
+      case 0:
+        mg_list_append(row.get(), mg_value_make_integer(index));
+        break;
+      case 1:
+        mg_list_append(row.get(), mg_value_make_string("a \"quoted\" string, with a comma"));
+        break;
+      case 2:
+        mg_list_append(row.get(), mg_value_make_float(index * 0.5));
+        break;
+      case 3:
+        mg_list_append(row.get(), mg_value_make_node(MakeNode(index, 1, 2)));
+        break;
+      case 4:
+        mg_list_append(row.get(), mg_value_make_relationship(MakeRelationship(index, 1)));
+        break;
+    }
+  }
+  return row;
+}
+
+inline std::vector<mg_memory::MgListPtr> MakeRecords(int rows, int columns) {
+  std::vector<mg_memory::MgListPtr> records;
+  records.reserve(rows);
+  for (int i = 0; i < rows; ++i) {
+    records.push_back(MakeRow(i, columns));
+  }
+  return records;
+}
+
+/// Rows where every column is a value of the same type.
+inline std::vector<mg_memory::MgListPtr> MakeRecordsOf(ValueType type, int rows, int columns) {
+  std::vector<mg_memory::MgListPtr> records;
+  records.reserve(rows);
+  for (int i = 0; i < rows; ++i) {
+    auto row = mg_memory::MakeCustomUnique<mg_list>(mg_list_make_empty(columns));
+    for (int j = 0; j < columns; ++j) {
+      mg_list_append(row.get(), MakeValue(type));
+    }
+    records.push_back(std::move(row));
+  }
+  return records;
+}
+
+/// Prose of the given length, like a description property. If special_every isn't 0, every special_every-th character
+/// is a quote or a newline, which the output formats escape.
+inline std::string MakeText(int length, int special_every) {
+  static constexpr std::string_view kWords = "lorem ipsum dolor sit amet consectetur adipiscing elit sed do eiusmod ";
+  std::string text;
+  text.reserve(length);
+  for (int i = 0; i < length; ++i) {
+    if (special_every > 0 && i % special_every == special_every - 1) {
+      text.push_back(i % 2 ? '"' : '\n');
+    } else {
+      text.push_back(kWords[i % kWords.size()]);
+    }
+  }
+  return text;
+}
+
+/// Which characters MakeScriptText writes.
+enum class Script { ASCII, LATIN, CJK };
+
+/// Text of about the given length in bytes: plain ASCII, Latin with an accented letter (two bytes, one column) in every
+/// word, or CJK (three bytes, two columns per character).
+inline std::string MakeScriptText(int length, Script script) {
+  static constexpr std::string_view kWords[] = {
+      "lorem ipsum dolor sit amet ",
+      "l\xc3\xb6rem ips\xc3\xbcm dol\xc3\xb2r sit am\xc3\xa9t ",
+      // Tokyo and Seoul.
+      "\xe6\x9d\xb1\xe4\xba\xac\xe9\x83\xbd \xec\x84\x9c\xec\x9a\xb8 ",
+  };
+  const auto words = kWords[static_cast<int>(script)];
+  std::string text;
+  while (text.size() < static_cast<size_t>(length)) {
+    text.append(words);
+  }
+  return text;
+}
+
+/// Rows with the same string in every cell.
+inline std::vector<mg_memory::MgListPtr> MakeStringRecords(int rows, int columns, const std::string &text) {
+  std::vector<mg_memory::MgListPtr> records;
+  records.reserve(rows);
+  for (int i = 0; i < rows; ++i) {
+    auto row = mg_memory::MakeCustomUnique<mg_list>(mg_list_make_empty(columns));
+    for (int j = 0; j < columns; ++j) {
+      mg_list_append(row.get(), mg_value_make_string(text.c_str()));
+    }
+    records.push_back(std::move(row));
+  }
+  return records;
+}
+
+/// Rows of text values, see MakeText.
+inline std::vector<mg_memory::MgListPtr> MakeTextRecords(int rows, int columns, int length, int special_every) {
+  return MakeStringRecords(rows, columns, MakeText(length, special_every));
+}
+
+inline std::vector<std::string> MakeHeader(int columns) {
+  std::vector<std::string> header;
+  for (int i = 0; i < columns; ++i) {
+    header.push_back("column_" + std::to_string(i));
+  }
+  return header;
+}
+
+/// A cypherl import, vertices first and then edges, every third query spans multiple lines and some of them have
+/// comments and quoted semicolons.
+inline std::string MakeCypherl(int queries) {
+  std::string cypherl;
+  for (int i = 0; i < queries; ++i) {
+    auto id = std::to_string(i);
+    if (i < queries / 4) {
+      cypherl += "CREATE (:Node {id: " + id + ", name: \"node; " + id + "\"});\n";
+    } else if (i % 3 == 0) {
+      cypherl += "// Edge " + id + "\nMATCH (a:Node {id: " + std::to_string(i % 100) + "}),\n      (b:Node {id: " + id +
+                 "})\nCREATE (a)-[:E {weight: " + id + "}]->(b);\n";
+    } else {
+      cypherl += "MATCH (a:Node {id: " + std::to_string(i % 100) + "}), (b:Node {id: " + id +
+                 "}) CREATE (a)-[:E]->(b);\n";
+    }
+  }
+  return cypherl;
+}
+
+}  // namespace fixtures
@@ -0,0 +1,358 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// Microbenchmarks of the client hot paths: input parsing and the value/output formatting. The database isn't needed,
+// the values are built by the fixtures. Run with --benchmark_out=<file> --benchmark_out_format=json to get the JSON
+// results (or build the mgconsole_bench_json target).
+
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <gflags/gflags.h>
+
+#include "fixtures.hpp"
+#include "utils/arrow.hpp"
+#include "utils/compression.hpp"
+#include "utils/json.hpp"
+#include "utils/output.hpp"
+#include "utils/parallel_format.hpp"
+#include "utils/query_type.hpp"
+#include "utils/utf8.hpp"
+#include "utils/utils.hpp"
+
+DEFINE_bool(term_colors, false, "Use terminal colors syntax highlighting.");
+
+namespace {
+
+/// Counts and drops everything written to it, the formatting is measured and not the terminal.
+class NullBuffer : public std::streambuf {
+ protected:
+  int overflow(int c) override { return c; }
+  std::streamsize xsputn(const char *, std::streamsize n) override { return n; }
+};
+
+const std::string kLine =
+    "MATCH (a:Node {id: 17}), (b:Node {name: \"it's; quoted\"}) CREATE (a)-[:E {w: 'x\\'y'}]->(b) REMOVE b.tmp;";
+
+void BM_ParseLine(benchmark::State &state) {
+  const bool collect_info = state.range(0);
+  for (auto _ : state) {
+    char quote = '\0';
+    bool escaped = false;
+    auto result = console::ParseLine(kLine, &quote, &escaped, collect_info);
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetBytesProcessed(state.iterations() * kLine.size());
+}
+BENCHMARK(BM_ParseLine)->ArgName("collect_info")->Arg(0)->Arg(1);
+
+void BM_GetQuery(benchmark::State &state) {
+  const bool collect_info = state.range(1);
+  const auto input = fixtures::MakeCypherl(state.range(0));
+  auto *cin_buffer = std::cin.rdbuf();
+  int64_t queries = 0;
+  for (auto _ : state) {
+    std::istringstream stream(input);
+    std::cin.rdbuf(stream.rdbuf());
+    std::cin.clear();
+    while (auto query = query::GetQuery(nullptr, collect_info)) {
+      benchmark::DoNotOptimize(query);
+      ++queries;
+    }
+  }
+  std::cin.rdbuf(cin_buffer);
+  std::cin.clear();
+  state.SetBytesProcessed(state.iterations() * input.size());
+  state.SetItemsProcessed(queries);
+}
+BENCHMARK(BM_GetQuery)->ArgNames({"queries", "collect_info"})->Args({1000, 0})->Args({1000, 1});
+
+void BM_NextState(benchmark::State &state) {
+  for (auto _ : state) {
+    char quote = '\0';
+    auto clause_state = query::line::ClauseState::NONE;
+    for (const char c : kLine) {
+      clause_state = query::line::NextState(&quote, c, clause_state);
+    }
+    benchmark::DoNotOptimize(clause_state);
+  }
+  state.SetBytesProcessed(state.iterations() * kLine.size());
+}
+BENCHMARK(BM_NextState);
+
+void BM_PrintValue(benchmark::State &state, fixtures::ValueType type) {
+  auto *value = fixtures::MakeValue(type);
+  NullBuffer buffer;
+  std::ostream os(&buffer);
+  for (auto _ : state) {
+    utils::PrintValue(os, value);
+  }
+  mg_value_destroy(value);
+}
+BENCHMARK_CAPTURE(BM_PrintValue, null, fixtures::ValueType::NULL_VALUE);
+BENCHMARK_CAPTURE(BM_PrintValue, bool, fixtures::ValueType::BOOL);
+BENCHMARK_CAPTURE(BM_PrintValue, integer, fixtures::ValueType::INTEGER);
+BENCHMARK_CAPTURE(BM_PrintValue, float, fixtures::ValueType::FLOAT);
+BENCHMARK_CAPTURE(BM_PrintValue, string, fixtures::ValueType::STRING);
+BENCHMARK_CAPTURE(BM_PrintValue, list, fixtures::ValueType::LIST);
+BENCHMARK_CAPTURE(BM_PrintValue, map, fixtures::ValueType::MAP);
+BENCHMARK_CAPTURE(BM_PrintValue, node, fixtures::ValueType::NODE);
+BENCHMARK_CAPTURE(BM_PrintValue, relationship, fixtures::ValueType::RELATIONSHIP);
+BENCHMARK_CAPTURE(BM_PrintValue, unbound_relationship, fixtures::ValueType::UNBOUND_RELATIONSHIP);
+BENCHMARK_CAPTURE(BM_PrintValue, path, fixtures::ValueType::PATH);
+BENCHMARK_CAPTURE(BM_PrintValue, date, fixtures::ValueType::DATE);
+BENCHMARK_CAPTURE(BM_PrintValue, local_time, fixtures::ValueType::LOCAL_TIME);
+BENCHMARK_CAPTURE(BM_PrintValue, local_date_time, fixtures::ValueType::LOCAL_DATE_TIME);
+BENCHMARK_CAPTURE(BM_PrintValue, duration, fixtures::ValueType::DURATION);
+BENCHMARK_CAPTURE(BM_PrintValue, point_2d, fixtures::ValueType::POINT_2D);
+BENCHMARK_CAPTURE(BM_PrintValue, point_3d, fixtures::ValueType::POINT_3D);
+
+/// The cells formatted the way the output used to do it, into a fresh stringstream each.
+void BM_FormatCellsStringStream(benchmark::State &state, fixtures::ValueType type) {
+  const auto records = fixtures::MakeRecordsOf(type, 100, 5);
+  for (auto _ : state) {
+    for (const auto &row : records) {
+      for (uint32_t i = 0; i < mg_list_size(row.get()); ++i) {
+        std::stringstream field;
+        utils::PrintValue(field, mg_list_at(row.get(), i));
+        auto text = field.str();
+        benchmark::DoNotOptimize(text);
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * records.size());
+}
+BENCHMARK_CAPTURE(BM_FormatCellsStringStream, float, fixtures::ValueType::FLOAT);
+BENCHMARK_CAPTURE(BM_FormatCellsStringStream, map, fixtures::ValueType::MAP);
+BENCHMARK_CAPTURE(BM_FormatCellsStringStream, node, fixtures::ValueType::NODE);
+
+/// The same cells appended to a reused buffer.
+void BM_FormatCellsAppend(benchmark::State &state, fixtures::ValueType type) {
+  const auto records = fixtures::MakeRecordsOf(type, 100, 5);
+  std::string buffer;
+  for (auto _ : state) {
+    for (const auto &row : records) {
+      for (uint32_t i = 0; i < mg_list_size(row.get()); ++i) {
+        buffer.clear();
+        utils::AppendValue(buffer, mg_list_at(row.get(), i));
+        benchmark::DoNotOptimize(buffer.data());
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * records.size());
+}
+BENCHMARK_CAPTURE(BM_FormatCellsAppend, float, fixtures::ValueType::FLOAT);
+BENCHMARK_CAPTURE(BM_FormatCellsAppend, map, fixtures::ValueType::MAP);
+BENCHMARK_CAPTURE(BM_FormatCellsAppend, node, fixtures::ValueType::NODE);
+
+void BM_PrintTabular(benchmark::State &state) {
+  const auto header = fixtures::MakeHeader(state.range(1));
+  const auto records = fixtures::MakeRecords(state.range(0), state.range(1));
+  for (auto _ : state) {
+    format::PrintTabular(header, records, false);
+  }
+  state.SetItemsProcessed(state.iterations() * records.size());
+}
+BENCHMARK(BM_PrintTabular)->ArgNames({"rows", "columns"})->Args({1000, 5})->Args({100, 20});
+
+/// Text cells measured by their display width, fitted to the screen they're truncated.
+void BM_PrintTabularText(benchmark::State &state) {
+  const auto header = fixtures::MakeHeader(5);
+  const auto records =
+      fixtures::MakeStringRecords(1000, 5, fixtures::MakeScriptText(64, static_cast<fixtures::Script>(state.range(0))));
+  for (auto _ : state) {
+    format::PrintTabular(header, records, state.range(1));
+  }
+  state.SetItemsProcessed(state.iterations() * records.size());
+}
+BENCHMARK(BM_PrintTabularText)
+    ->ArgNames({"script", "fit_to_screen"})
+    ->Args({0, 0})
+    ->Args({1, 0})
+    ->Args({2, 0})
+    ->Args({0, 1})
+    ->Args({2, 1});
+
+void BM_FormatCsvFields(benchmark::State &state) {
+  const auto records = fixtures::MakeRecords(state.range(0), 5);
+  const format::CsvOptions csv_opts(",", "\\", true);
+  for (auto _ : state) {
+    for (const auto &row : records) {
+      auto fields = format::FormatCsvFields(row, csv_opts);
+      benchmark::DoNotOptimize(fields);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * records.size());
+}
+BENCHMARK(BM_FormatCsvFields)->ArgName("rows")->Arg(1000);
+
+/// Text-heavy values, mostly nothing to escape.
+void BM_AppendCsvRows(benchmark::State &state) {
+  const auto records = fixtures::MakeTextRecords(100, 5, state.range(0), state.range(1));
+  const format::CsvOptions csv_opts(",", "\\", true);
+  std::string buffer;
+  int64_t bytes = 0;
+  for (auto _ : state) {
+    buffer.clear();
+    format::AppendCsvRows(buffer, records, csv_opts);
+    benchmark::DoNotOptimize(buffer.data());
+    bytes += buffer.size();
+  }
+  state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_AppendCsvRows)
+    ->ArgNames({"length", "special_every"})
+    ->Args({64, 0})
+    ->Args({1024, 0})
+    ->Args({1024, 100})
+    ->Args({1024, 8});
+
+/// The whole CSV output of a large result, the chunks are formatted on the workers and written in order. The wall time
+/// is measured, the formatting runs on the workers.
+void BM_PrintCsvWorkers(benchmark::State &state) {
+  const auto header = fixtures::MakeHeader(5);
+  const auto records = fixtures::MakeRecords(16 * format::kFormatChunkRows, 5);
+  const format::CsvOptions csv_opts(",", "\\", true);
+  for (auto _ : state) {
+    format::PrintCsv(header, records, csv_opts, state.range(0));
+    utils::output::Flush();
+  }
+  state.SetItemsProcessed(state.iterations() * records.size());
+}
+BENCHMARK(BM_PrintCsvWorkers)->ArgName("workers")->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+
+void BM_JsonAppendString(benchmark::State &state) {
+  const auto text = fixtures::MakeText(state.range(0), state.range(1));
+  std::string buffer;
+  for (auto _ : state) {
+    buffer.clear();
+    utils::json::AppendString(buffer, text);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_JsonAppendString)
+    ->ArgNames({"length", "special_every"})
+    ->Args({64, 0})
+    ->Args({1024, 0})
+    ->Args({1024, 100})
+    ->Args({1024, 8});
+
+void BM_Utf8Width(benchmark::State &state) {
+  const auto text = fixtures::MakeScriptText(state.range(0), static_cast<fixtures::Script>(state.range(1)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(utils::utf8::Width(text));
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_Utf8Width)
+    ->ArgNames({"length", "script"})
+    ->Args({16, 0})
+    ->Args({1024, 0})
+    ->Args({1024, 1})
+    ->Args({1024, 2});
+
+void BM_AppendJsonlRows(benchmark::State &state, fixtures::ValueType type) {
+  const auto header = fixtures::MakeHeader(5);
+  const auto records = fixtures::MakeRecordsOf(type, 100, 5);
+  const auto keys = format::MakeJsonKeys(header);
+  std::string buffer;
+  for (auto _ : state) {
+    buffer.clear();
+    format::AppendJsonlRows(buffer, records, keys);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+  state.SetItemsProcessed(state.iterations() * records.size());
+}
+BENCHMARK_CAPTURE(BM_AppendJsonlRows, float, fixtures::ValueType::FLOAT);
+BENCHMARK_CAPTURE(BM_AppendJsonlRows, map, fixtures::ValueType::MAP);
+BENCHMARK_CAPTURE(BM_AppendJsonlRows, node, fixtures::ValueType::NODE);
+
+void BM_ArrowWriter(benchmark::State &state, fixtures::ValueType type) {
+  const auto header = fixtures::MakeHeader(5);
+  const auto records = fixtures::MakeRecordsOf(type, 1000, 5);
+  std::string buffer;
+  for (auto _ : state) {
+    buffer.clear();
+    format::ArrowWriter writer(header, 256);
+    for (const auto &record : records) {
+      writer.Append(buffer, record.get());
+    }
+    writer.Finish(buffer);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+  state.SetItemsProcessed(state.iterations() * records.size());
+}
+BENCHMARK_CAPTURE(BM_ArrowWriter, float, fixtures::ValueType::FLOAT);
+BENCHMARK_CAPTURE(BM_ArrowWriter, string, fixtures::ValueType::STRING);
+BENCHMARK_CAPTURE(BM_ArrowWriter, map, fixtures::ValueType::MAP);
+
+void BM_Compress(benchmark::State &state, utils::compression::Type type) {
+  std::string block;
+  for (int i = 0; block.size() < utils::output::kBufferSize; ++i) {
+    block += "CREATE (:__mg_vertex__:`Person` {__mg_id__: " + std::to_string(i) + ", `name`: \"Person " +
+             std::to_string(i * 7919 % 1000) + "\"});\n";
+  }
+  std::string compressed;
+  for (auto _ : state) {
+    compressed.clear();
+    utils::compression::Compress(type, block, compressed);
+    benchmark::DoNotOptimize(compressed.data());
+  }
+  state.SetBytesProcessed(state.iterations() * block.size());
+}
+BENCHMARK_CAPTURE(BM_Compress, gzip, utils::compression::Type::GZIP);
+BENCHMARK_CAPTURE(BM_Compress, zstd, utils::compression::Type::ZSTD);
+
+void BM_Escape(benchmark::State &state) {
+  const std::string plain(state.range(0), 'a');
+  std::string special;
+  while (special.size() < plain.size()) {
+    special += "say \"hi\"\\\n\t";
+  }
+  special.resize(plain.size());
+  const auto &src = state.range(1) ? special : plain;
+  for (auto _ : state) {
+    auto escaped = utils::Escape(src);
+    benchmark::DoNotOptimize(escaped);
+  }
+  state.SetBytesProcessed(state.iterations() * src.size());
+}
+BENCHMARK(BM_Escape)->ArgNames({"size", "special"})->Args({64, 0})->Args({64, 1})->Args({4096, 0})->Args({4096, 1});
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  // GetQuery reads through replxx when the standard input is a terminal.
+#ifdef _WIN32
+  const char *null_device = "NUL";
+#else
+  const char *null_device = "/dev/null";
+#endif /* _WIN32 */
+  std::freopen(null_device, "r", stdin);
+  // The formatting is measured and not the terminal.
+  utils::output::OpenFile(null_device);
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
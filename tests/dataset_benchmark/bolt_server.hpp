@@ -0,0 +1,161 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "utils/packstream.hpp"
+
+// The server side of a Bolt connection, shared by the mock and the replay servers: the handshake and the message
+// framing, the messages themselves are up to the server.
+
+namespace bolt_server {
+
+namespace ps = utils::packstream;
+
+class Connection {
+ public:
+  explicit Connection(int fd) : fd_(fd) {}
+  Connection(const Connection &) = delete;
+  Connection &operator=(const Connection &) = delete;
+  ~Connection() { close(fd_); }
+
+  /// Agrees on the version, 4.x preferably since it has explicit transactions and no LOGON, 1 otherwise.
+  bool Handshake() {
+    std::string handshake;
+    if (!ReadExactly(20, &handshake) || handshake.compare(0, 4, "\x60\x60\xB0\x17") != 0) {
+      return false;
+    }
+    // Versions are [unused, range, minor, major].
+    std::string chosen(4, '\0');
+    for (size_t i = 4; i < 20; i += 4) {
+      const auto major = static_cast<uint8_t>(handshake[i + 3]);
+      if (major == 4 || (major == 1 && chosen[3] == 0)) {
+        chosen = std::string("\0\0", 2) + handshake[i + 2] + handshake[i + 3];
+        if (major == 4) {
+          break;
+        }
+      }
+    }
+    return Write(chosen) && chosen[3] != 0;
+  }
+
+  /// Reads the next message (without the chunking), false once the client is gone.
+  bool ReadMessage(std::string *message) {
+    message->clear();
+    std::string header;
+    while (ReadExactly(2, &header)) {
+      const size_t size = (static_cast<uint8_t>(header[0]) << 8) | static_cast<uint8_t>(header[1]);
+      if (size == 0) {
+        // Empty messages are NOOPs (keep-alives).
+        if (!message->empty()) {
+          return true;
+        }
+        continue;
+      }
+      std::string chunk;
+      if (!ReadExactly(size, &chunk)) {
+        return false;
+      }
+      message->append(chunk);
+    }
+    return false;
+  }
+
+  /// Sends an already encoded message.
+  bool Send(std::string_view message) { return Write(ps::ChunkMessage(message)); }
+
+  bool Respond(uint8_t signature, ps::List fields) {
+    std::string message;
+    ps::Encoder(&message).Write(ps::Value{ps::Structure{.signature = signature, .fields = std::move(fields)}});
+    return Send(message);
+  }
+
+  bool Success(ps::Map metadata = {}) { return Respond(ps::message::kSuccess, {ps::Value{std::move(metadata)}}); }
+
+  bool Failure(std::string_view code, std::string_view message) {
+    return Respond(ps::message::kFailure, {ps::Value{ps::Map{{"code", ps::Value{std::string(code)}},
+                                                             {"message", ps::Value{std::string(message)}}}}});
+  }
+
+ private:
+  bool ReadExactly(size_t size, std::string *data) {
+    data->resize(size);
+    for (size_t read = 0; read < size;) {
+      auto ret = recv(fd_, data->data() + read, size - read, 0);
+      if (ret <= 0) {
+        return false;
+      }
+      read += ret;
+    }
+    return true;
+  }
+
+  bool Write(std::string_view data) {
+    while (!data.empty()) {
+      auto ret = send(fd_, data.data(), data.size(), MSG_NOSIGNAL);
+      if (ret <= 0) {
+        return false;
+      }
+      data.remove_prefix(ret);
+    }
+    return true;
+  }
+
+  int fd_;
+};
+
+/// Accepts the connections on localhost forever, each one is handled by handler(fd, connection index) on its own
+/// thread. Returns only if the port can't be listened on.
+template <class Handler>
+int Serve(int port, Handler handler) {
+  int server = socket(AF_INET, SOCK_STREAM, 0);
+  int enable = 1;
+  setsockopt(server, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(port);
+  if (server < 0 || bind(server, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+      listen(server, SOMAXCONN) != 0) {
+    std::cerr << "Unable to listen on port " << port << ": " << std::strerror(errno) << std::endl;
+    return 1;
+  }
+  std::cerr << "Listening on 127.0.0.1:" << port << std::endl;
+
+  for (uint64_t connection = 0;; ++connection) {
+    int client = accept(server, nullptr, nullptr);
+    if (client < 0) {
+      continue;
+    }
+    setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    std::thread(handler, client, connection).detach();
+  }
+}
+
+}  // namespace bolt_server
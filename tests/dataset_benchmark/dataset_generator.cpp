@@ -0,0 +1,124 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// Generates a synthetic cypherl import to stdout: the indexes, then the nodes (CREATE or MERGE) and then the edges
+// (MATCH-CREATE), the same shape as the DUMP DATABASE output the import modes are made for. The output only depends
+// on the flags, so the same dataset can be regenerated anywhere instead of being downloaded.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+DEFINE_uint64(nodes, 10000, "Number of nodes.");
+DEFINE_uint64(edges, 50000, "Number of edges.");
+DEFINE_int32(labels, 4, "Number of node labels.");
+DEFINE_string(label_distribution, "uniform", "How the labels are assigned to the nodes, uniform or zipf.");
+DEFINE_validator(label_distribution, [](const char *, const std::string &value) {
+  return value == "uniform" || value == "zipf";
+});
+DEFINE_int32(edge_types, 2, "Number of edge types.");
+DEFINE_string(degree_distribution, "uniform",
+              "How the edge sources are picked, uniform or power-law (a few nodes get most of the edges, i.e. lots of "
+              "conflicting edges).");
+DEFINE_validator(degree_distribution, [](const char *, const std::string &value) {
+  return value == "uniform" || value == "power-law";
+});
+DEFINE_double(power_law_exponent, 3.0, "The larger, the more the power-law degrees are skewed towards a few nodes.");
+DEFINE_double(merge_ratio, 0.0, "Part of the nodes created by MERGE instead of CREATE.");
+DEFINE_bool(indexes, true, "Create a label-property index on the id of each label first.");
+DEFINE_int32(properties, 2, "Number of properties of each node besides the id.");
+DEFINE_uint64(seed, 42, "Random seed.");
+
+namespace {
+
+std::string Label(int64_t label) { return "Label" + std::to_string(label); }
+
+std::string Properties(uint64_t id, std::mt19937_64 &random) {
+  std::string properties = "id: " + std::to_string(id);
+  for (int i = 0; i < FLAGS_properties; ++i) {
+    properties += ", p" + std::to_string(i) + ": ";
+    if (i % 2 == 0) {
+      properties += std::to_string(random() % 1000000);
+    } else {
+      properties += "\"value " + std::to_string(random() % 1000) + "\"";
+    }
+  }
+  return properties;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  gflags::SetUsageMessage("Generates a synthetic cypherl dataset for the import benchmarks.");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  std::ios::sync_with_stdio(false);
+  if (FLAGS_nodes == 0 && FLAGS_edges > 0) {
+    std::cerr << "Edges need nodes." << std::endl;
+    return 1;
+  }
+  const int labels = std::max(FLAGS_labels, 1);
+  const int edge_types = std::max(FLAGS_edge_types, 1);
+  std::mt19937_64 random(FLAGS_seed);
+
+  if (FLAGS_indexes) {
+    for (int label = 0; label < labels; ++label) {
+      std::cout << "CREATE INDEX ON :" << Label(label) << "(id);\n";
+    }
+  }
+
+  std::vector<double> label_weights;
+  for (int label = 0; label < labels; ++label) {
+    label_weights.push_back(FLAGS_label_distribution == "zipf" ? 1.0 / (label + 1) : 1.0);
+  }
+  std::discrete_distribution<int> label_distribution(label_weights.begin(), label_weights.end());
+  std::bernoulli_distribution merge_distribution(std::clamp(FLAGS_merge_ratio, 0.0, 1.0));
+  // The edges have to match the nodes by the label as well to use the index.
+  std::vector<uint16_t> node_labels(FLAGS_nodes);
+  for (uint64_t id = 0; id < FLAGS_nodes; ++id) {
+    node_labels[id] = label_distribution(random);
+    if (merge_distribution(random)) {
+      std::cout << "MERGE (n:" << Label(node_labels[id]) << " {id: " << id << "}) SET n += {"
+                << Properties(id, random) << "};\n";
+    } else {
+      std::cout << "CREATE (:" << Label(node_labels[id]) << " {" << Properties(id, random) << "});\n";
+    }
+  }
+
+  std::uniform_int_distribution<uint64_t> node_distribution(0, FLAGS_nodes ? FLAGS_nodes - 1 : 0);
+  std::uniform_real_distribution<double> unit_distribution(0.0, 1.0);
+  for (uint64_t edge = 0; edge < FLAGS_edges; ++edge) {
+    uint64_t from = node_distribution(random);
+    if (FLAGS_degree_distribution == "power-law") {
+      // Inverse transform, the low ids get most of the edges.
+      from = std::min<uint64_t>(FLAGS_nodes * std::pow(unit_distribution(random), FLAGS_power_law_exponent),
+                                FLAGS_nodes - 1);
+    }
+    uint64_t to = node_distribution(random);
+    if (to == from && FLAGS_nodes > 1) {
+      to = (to + 1) % FLAGS_nodes;
+    }
+    std::cout << "MATCH (a:" << Label(node_labels[from]) << " {id: " << from << "}), (b:" << Label(node_labels[to])
+              << " {id: " << to << "}) CREATE (a)-[:TYPE" << random() % edge_types << " {weight: " << random() % 100
+              << "}]->(b);\n";
+  }
+  std::cout.flush();
+  return std::cout ? 0 : 1;
+}
@@ -0,0 +1,286 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// A local stand-in for Memgraph to benchmark the import modes without a database: it speaks enough Bolt for mgclient,
+// acknowledges every query after a configurable latency and can fail a part of them with a conflict. Nothing is
+// executed, the created nodes and relationships are estimated from the query text (the patterns with a label or
+// properties in a CREATE or MERGE clause are created ones, the bare variables were matched) and counted on commit, so
+// that "MATCH (n) RETURN count(n)" and "MATCH ()-[r]->() RETURN count(r)" can check an import. DETACH DELETE clears
+// the counts.
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <gflags/gflags.h>
+
+#include "bolt_server.hpp"
+
+DEFINE_int32(port, 7687, "Port to listen on.");
+DEFINE_int32(query_latency_us, 0, "How long each query (RUN) takes.");
+DEFINE_int32(commit_latency_us, 0, "How long each commit takes.");
+DEFINE_double(conflict_probability, 0.0,
+              "Probability that a query fails with a conflict (a transient error the import retries).");
+DEFINE_uint64(seed, 0, "Seed of the conflict injection, the connections get consecutive seeds.");
+
+namespace {
+
+namespace ps = bolt_server::ps;
+
+constexpr std::string_view kConflictMessage =
+    "Cannot resolve conflicting transactions. You can retry this transaction when the conflicting transaction is "
+    "finished";
+
+std::atomic<int64_t> committed_nodes{0};
+std::atomic<int64_t> committed_relationships{0};
+
+struct Counts {
+  int64_t nodes{0};
+  int64_t relationships{0};
+};
+
+/// What a query would return, only the count queries return something.
+struct Result {
+  std::string column;
+  std::optional<int64_t> count;
+  Counts created;
+  bool delete_all{false};
+};
+
+std::string ToUpper(std::string_view text) {
+  std::string upper(text);
+  std::transform(upper.begin(), upper.end(), upper.begin(), [](unsigned char c) { return std::toupper(c); });
+  return upper;
+}
+
+/// Position of the keyword as a whole word (outside of the quotes, the generated queries don't quote keywords).
+size_t FindKeyword(const std::string &upper, std::string_view keyword, size_t from = 0) {
+  for (auto pos = upper.find(keyword, from); pos != std::string::npos; pos = upper.find(keyword, pos + 1)) {
+    const bool word_begin = pos == 0 || !std::isalnum(static_cast<unsigned char>(upper[pos - 1]));
+    const auto end = pos + keyword.size();
+    const bool word_end = end == upper.size() || !std::isalnum(static_cast<unsigned char>(upper[end]));
+    if (word_begin && word_end) {
+      return pos;
+    }
+  }
+  return std::string::npos;
+}
+
+Counts EstimateCreated(const std::string &upper) {
+  Counts created;
+  auto write = std::min(FindKeyword(upper, "CREATE"), FindKeyword(upper, "MERGE"));
+  if (write == std::string::npos || FindKeyword(upper, "INDEX", write) != std::string::npos) {
+    return created;
+  }
+  char quote = '\0';
+  for (auto i = write; i < upper.size(); ++i) {
+    const char c = upper[i];
+    if (quote) {
+      if (c == '\\') {
+        ++i;
+      } else if (c == quote) {
+        quote = '\0';
+      }
+    } else if (c == '"' || c == '\'') {
+      quote = c;
+    } else if (c == '-' && i + 1 < upper.size() && upper[i + 1] == '[') {
+      ++created.relationships;
+    } else if (c == '(') {
+      auto j = i + 1;
+      while (j < upper.size() && (std::isalnum(static_cast<unsigned char>(upper[j])) || upper[j] == '_' ||
+                                  std::isspace(static_cast<unsigned char>(upper[j])))) {
+        ++j;
+      }
+      if (j < upper.size() && (upper[j] == ':' || upper[j] == '{')) {
+        ++created.nodes;
+      }
+    }
+  }
+  return created;
+}
+
+Result Execute(std::string_view query) {
+  Result result;
+  const auto upper = ToUpper(query);
+  if (FindKeyword(upper, "DETACH") != std::string::npos) {
+    result.delete_all = true;
+    return result;
+  }
+  auto ret = FindKeyword(upper, "RETURN");
+  if (ret != std::string::npos && upper.find("COUNT(", ret) != std::string::npos) {
+    const auto column_begin = query.find_first_not_of(' ', ret + 6);
+    const auto column_end = query.find_first_of(";\n", column_begin);
+    result.column = std::string(query.substr(column_begin, column_end - column_begin));
+    const bool relationships = upper.find("-[", 0) < ret;
+    result.count = relationships ? committed_relationships.load() : committed_nodes.load();
+    return result;
+  }
+  result.created = EstimateCreated(upper);
+  return result;
+}
+
+class Session {
+ public:
+  Session(int fd, uint64_t seed) : connection_(fd), random_(seed) {}
+
+  void Run() {
+    if (!connection_.Handshake()) {
+      return;
+    }
+    std::string message;
+    while (connection_.ReadMessage(&message)) {
+      std::string_view data(message);
+      auto request = ps::Decode(&data);
+      const auto *structure = request ? request->Get<ps::Structure>() : nullptr;
+      if (!structure || !Handle(*structure)) {
+        return;
+      }
+    }
+  }
+
+ private:
+  bool Handle(const ps::Structure &request) {
+    switch (request.signature) {
+      case ps::message::kHello:
+        return Success({{"server", ps::Value{std::string("Memgraph mock server")}},
+                        {"connection_id", ps::Value{std::string("mock")}}});
+      case ps::message::kGoodbye:
+        return false;
+      case ps::message::kReset:
+      case ps::message::kAckFailure:
+        failed_ = false;
+        Abort();
+        return Success();
+      default:
+        break;
+    }
+    if (failed_) {
+      return Respond(ps::message::kIgnored, {});
+    }
+    switch (request.signature) {
+      case ps::message::kBegin:
+        in_transaction_ = true;
+        return Success();
+      case ps::message::kRun:
+        return HandleRun(request);
+      case ps::message::kPull:
+        return HandlePull();
+      case ps::message::kDiscard:
+        result_.reset();
+        return Success({{"has_more", ps::Value{false}}});
+      case ps::message::kCommit:
+        if (FLAGS_commit_latency_us > 0) {
+          std::this_thread::sleep_for(std::chrono::microseconds(FLAGS_commit_latency_us));
+        }
+        committed_nodes += pending_.nodes;
+        committed_relationships += pending_.relationships;
+        pending_ = {};
+        in_transaction_ = false;
+        return Success();
+      case ps::message::kRollback:
+        Abort();
+        return Success();
+      default:
+        return Failure("Memgraph.ClientError.Request.Invalid", "Unsupported message");
+    }
+  }
+
+  bool HandleRun(const ps::Structure &request) {
+    const auto *query = request.fields.empty() ? nullptr : request.fields[0].Get<std::string>();
+    if (!query) {
+      return Failure("Memgraph.ClientError.Request.Invalid", "RUN without a query");
+    }
+    if (FLAGS_query_latency_us > 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(FLAGS_query_latency_us));
+    }
+    if (FLAGS_conflict_probability > 0 && std::bernoulli_distribution(FLAGS_conflict_probability)(random_)) {
+      return Failure("Memgraph.TransientError.MemgraphError.MemgraphError", kConflictMessage);
+    }
+    result_ = Execute(*query);
+    ps::List fields;
+    if (result_->count) {
+      fields.push_back(ps::Value{result_->column});
+    }
+    return Success({{"fields", ps::Value{std::move(fields)}}, {"t_first", ps::Value{int64_t{0}}}});
+  }
+
+  bool HandlePull() {
+    if (!result_) {
+      return Failure("Memgraph.ClientError.Request.Invalid", "PULL without RUN");
+    }
+    auto result = std::move(*result_);
+    result_.reset();
+    if (result.delete_all) {
+      committed_nodes = 0;
+      committed_relationships = 0;
+      pending_ = {};
+    }
+    if (result.count && !Respond(ps::message::kRecord, {ps::Value{ps::List{ps::Value{*result.count}}}})) {
+      return false;
+    }
+    ps::Map summary{{"has_more", ps::Value{false}}, {"type", ps::Value{std::string(result.count ? "r" : "rw")}}};
+    if (result.created.nodes || result.created.relationships) {
+      summary.emplace_back("stats", ps::Value{ps::Map{{"nodes-created", ps::Value{result.created.nodes}},
+                                                      {"relationships-created",
+                                                       ps::Value{result.created.relationships}}}});
+    }
+    if (in_transaction_) {
+      pending_.nodes += result.created.nodes;
+      pending_.relationships += result.created.relationships;
+    } else {
+      committed_nodes += result.created.nodes;
+      committed_relationships += result.created.relationships;
+    }
+    return Success(std::move(summary));
+  }
+
+  void Abort() {
+    pending_ = {};
+    in_transaction_ = false;
+    result_.reset();
+  }
+
+  bool Success(ps::Map metadata = {}) { return connection_.Success(std::move(metadata)); }
+
+  bool Failure(std::string_view code, std::string_view message) {
+    failed_ = true;
+    return connection_.Failure(code, message);
+  }
+
+  bool Respond(uint8_t signature, ps::List fields) { return connection_.Respond(signature, std::move(fields)); }
+
+  bolt_server::Connection connection_;
+  std::mt19937_64 random_;
+  bool failed_{false};
+  bool in_transaction_{false};
+  Counts pending_;
+  std::optional<Result> result_;
+};
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  gflags::SetUsageMessage("Mock Bolt server for the import benchmarks.");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  return bolt_server::Serve(FLAGS_port,
+                            [](int fd, uint64_t connection) { Session(fd, FLAGS_seed + connection).Run(); });
+}
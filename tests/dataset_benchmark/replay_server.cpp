@@ -0,0 +1,183 @@
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// Serves the sessions recorded by mgconsole --record-bolt back to mgconsole, to benchmark the client against real
+// result shapes and latencies without the database. Each connection gets the next recorded session. A request is
+// answered with the responses recorded after the next recorded request of the same kind (the ones in between are
+// skipped), each one sent after the same delay from the request as in the recording (divided by --speed), or right
+// away with --speed=0. The requests mgclient sends on its own (e.g. RESET) and the ones missing from the recording are
+// answered by the server itself.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "bolt_server.hpp"
+#include "utils/bolt_record.hpp"
+
+DEFINE_string(recording, "", "The file recorded by mgconsole --record-bolt.");
+DEFINE_int32(port, 7687, "Port to listen on.");
+DEFINE_double(speed, 1.0, "Replay speed relative to the recording, 0 sends the responses as fast as possible.");
+DEFINE_bool(loop, false, "Start again from the first recorded session once all of them were served.");
+
+namespace {
+
+namespace ps = bolt_server::ps;
+namespace record = utils::bolt_record;
+
+struct Message {
+  uint64_t timestamp;
+  uint8_t direction;
+  uint8_t signature;
+  std::string data;
+};
+
+using RecordedSession = std::vector<Message>;
+
+std::optional<uint8_t> Signature(std::string_view data) {
+  auto message = ps::Decode(&data);
+  const auto *structure = message ? message->Get<ps::Structure>() : nullptr;
+  if (!structure) {
+    return std::nullopt;
+  }
+  return structure->signature;
+}
+
+/// The sessions in the order they were started, nullopt if the file isn't a valid recording.
+std::optional<std::vector<RecordedSession>> Load(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  if (!file.good() && !file.eof()) {
+    return std::nullopt;
+  }
+  std::string_view rest(data);
+  if (rest.substr(0, record::kHeader.size()) != record::kHeader) {
+    return std::nullopt;
+  }
+  rest.remove_prefix(record::kHeader.size());
+  auto read = [&rest](int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+      value = (value << 8) | static_cast<uint8_t>(rest[i]);
+    }
+    rest.remove_prefix(bytes);
+    return value;
+  };
+
+  std::vector<RecordedSession> sessions;
+  std::map<uint64_t, size_t> session_indexes;
+  constexpr size_t kEntryHeaderSize = 4 + 8 + 1 + 4;
+  while (rest.size() >= kEntryHeaderSize) {
+    const auto session_id = read(4);
+    const auto timestamp = read(8);
+    const auto direction = static_cast<uint8_t>(read(1));
+    const auto size = read(4);
+    if (rest.size() < size) {
+      // The recording was cut off (e.g. mgconsole was killed).
+      break;
+    }
+    auto message = rest.substr(0, size);
+    rest.remove_prefix(size);
+    auto signature = Signature(message);
+    if (!signature) {
+      return std::nullopt;
+    }
+    auto [it, inserted] = session_indexes.emplace(session_id, sessions.size());
+    if (inserted) {
+      sessions.emplace_back();
+    }
+    sessions[it->second].push_back(Message{
+        .timestamp = timestamp, .direction = direction, .signature = *signature, .data = std::string(message)});
+  }
+  return sessions;
+}
+
+void Replay(int fd, const RecordedSession &session) {
+  bolt_server::Connection connection(fd);
+  if (!connection.Handshake()) {
+    return;
+  }
+  size_t next = 0;
+  std::string request;
+  while (connection.ReadMessage(&request)) {
+    const auto arrival = std::chrono::steady_clock::now();
+    const auto signature = Signature(request);
+    if (!signature || *signature == ps::message::kGoodbye) {
+      return;
+    }
+    auto recorded = next;
+    while (recorded < session.size() &&
+           (session[recorded].direction != record::kClient || session[recorded].signature != *signature)) {
+      ++recorded;
+    }
+    if (recorded == session.size()) {
+      bool ok = true;
+      if (*signature == ps::message::kHello) {
+        ok = connection.Success({{"server", ps::Value{std::string("Memgraph replay server")}}});
+      } else if (*signature == ps::message::kReset || *signature == ps::message::kAckFailure) {
+        ok = connection.Success();
+      } else {
+        ok = connection.Failure("Memgraph.ClientError.Request.Invalid", "The request isn't in the recording");
+      }
+      if (!ok) {
+        return;
+      }
+      continue;
+    }
+    const auto request_timestamp = session[recorded].timestamp;
+    for (next = recorded + 1; next < session.size() && session[next].direction == record::kServer; ++next) {
+      if (FLAGS_speed > 0) {
+        const auto delay = (session[next].timestamp - request_timestamp) / FLAGS_speed;
+        std::this_thread::sleep_until(arrival + std::chrono::microseconds(static_cast<int64_t>(delay)));
+      }
+      if (!connection.Send(session[next].data)) {
+        return;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  gflags::SetUsageMessage("Serves the Bolt sessions recorded by mgconsole --record-bolt.");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  auto sessions = Load(FLAGS_recording);
+  if (!sessions || sessions->empty()) {
+    std::cerr << "No recorded sessions in '" << FLAGS_recording << "'" << std::endl;
+    return 1;
+  }
+  std::cerr << "Loaded " << sessions->size() << " sessions" << std::endl;
+  std::atomic<uint64_t> served{0};
+  return bolt_server::Serve(FLAGS_port, [&sessions, &served](int fd, uint64_t) {
+    const auto index = served++;
+    if (index >= sessions->size() && !FLAGS_loop) {
+      close(fd);
+      return;
+    }
+    Replay(fd, (*sessions)[index % sessions->size()]);
+  });
+}
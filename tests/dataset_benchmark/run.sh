@@ -23,12 +23,27 @@ MGCONSOLE_BINARY="${MGCONSOLE_BINARY:-$DIR/../../build/src/mgconsole}"
 MGCONSOLE_SETUP="${MGCONSOLE_SETUP:-STORAGE MODE IN_MEMORY_ANALYTICAL;}"
 MGCONSOLE_BATCH_SIZE="${MGCONSOLE_BATCH_SIZE:-1000}"
 MGCONSOLE_WORKERS="${MGCONSOLE_WORKERS:-32}"
+MGCONSOLE_EDGE_SCHEDULING="${MGCONSOLE_EDGE_SCHEDULING:-arrival}"
+# With MGCONSOLE_OFFLINE=true, the datasets are generated and imported into the
+# mock Bolt server, no network or Memgraph needed (the throughput is the one of
+# the client plus the mock latencies, not of Memgraph).
+MGCONSOLE_OFFLINE="${MGCONSOLE_OFFLINE:-false}"
+MGCONSOLE_TOOLS_DIR="${MGCONSOLE_TOOLS_DIR:-$DIR/../../build/tests/dataset_benchmark}"
+MOCK_SERVER_PORT="${MOCK_SERVER_PORT:-7688}"
+MOCK_SERVER_QUERY_LATENCY_US="${MOCK_SERVER_QUERY_LATENCY_US:-50}"
+MOCK_SERVER_COMMIT_LATENCY_US="${MOCK_SERVER_COMMIT_LATENCY_US:-200}"
+MOCK_SERVER_CONFLICT_PROBABILITY="${MOCK_SERVER_CONFLICT_PROBABILITY:-0.0}"
 
 TIMEFORMAT=%R
 DATASETS=(
   "https://download.memgraph.com/datasets/cora-scientific-publications/cora-scientific-publications.cypherl.gz 2708 5278"
   "https://download.memgraph.com/datasets/marvel-cinematic-universe/marvel-cinematic-universe.cypherl.gz 21732 682943"
 )
+# <name> <nodes> <edges> <extra generator flags>
+GENERATED_DATASETS=(
+  "generated-uniform 10000 50000"
+  "generated-power-law 100000 500000 --degree-distribution=power-law --label-distribution=zipf --merge-ratio=0.2"
+)
 
 function check_dataset {
   expected_nodes=$1
@@ -59,18 +74,37 @@ measure_batched_parallel_import() {
   nodes=$1
   edges=$2
   echo "MATCH (n) DETACH DELETE n;" | $MGCONSOLE_BINARY
-  import_time=$( { time cat $dataset_cypherl | $MGCONSOLE_BINARY --import-mode="batched-parallel" --batch-size=$MGCONSOLE_BATCH_SIZE --workers-number=$MGCONSOLE_WORKERS; } 2>&1 )
+  import_time=$( { time cat $dataset_cypherl | $MGCONSOLE_BINARY --import-mode="batched-parallel" --batch-size=$MGCONSOLE_BATCH_SIZE --workers-number=$MGCONSOLE_WORKERS --edge-scheduling=$MGCONSOLE_EDGE_SCHEDULING 2>parallel_import.log; } 2>&1 )
   echo "$import_time"
 }
 
+if [[ $MGCONSOLE_OFFLINE == true ]]; then
+  $MGCONSOLE_TOOLS_DIR/mgconsole_mock_server --port=$MOCK_SERVER_PORT \
+    --query-latency-us=$MOCK_SERVER_QUERY_LATENCY_US --commit-latency-us=$MOCK_SERVER_COMMIT_LATENCY_US \
+    --conflict-probability=$MOCK_SERVER_CONFLICT_PROBABILITY 2>mock_server.log &
+  mock_server_pid=$!
+  trap "kill $mock_server_pid" EXIT
+  until (echo > /dev/tcp/127.0.0.1/$MOCK_SERVER_PORT) 2>/dev/null; do sleep 0.1; done
+  MGCONSOLE_BINARY="$MGCONSOLE_BINARY --port=$MOCK_SERVER_PORT"
+  DATASETS=("${GENERATED_DATASETS[@]}")
+fi
+
 echo "$MGCONSOLE_SETUP" | $MGCONSOLE_BINARY
 for dataset in "${DATASETS[@]}"; do
-  set -- $dataset; dataset_url=$1; nodes=$2; edges=$3
-  dataset_gz="$(basename $dataset_url)"
-  dataset_cypherl="$(basename $dataset_gz .gz)"
-  if [[ ! -f $dataset_cypherl ]]; then
-    wget $dataset_url -O $dataset_gz
-    gzip -df $dataset_gz
+  if [[ $MGCONSOLE_OFFLINE == true ]]; then
+    set -- $dataset; dataset_name=$1; nodes=$2; edges=$3; shift 3
+    dataset_cypherl="$dataset_name.cypherl"
+    if [[ ! -f $dataset_cypherl ]]; then
+      $MGCONSOLE_TOOLS_DIR/mgconsole_dataset_generator --nodes=$nodes --edges=$edges "$@" > $dataset_cypherl
+    fi
+  else
+    set -- $dataset; dataset_url=$1; nodes=$2; edges=$3
+    dataset_gz="$(basename $dataset_url)"
+    dataset_cypherl="$(basename $dataset_gz .gz)"
+    if [[ ! -f $dataset_cypherl ]]; then
+      wget $dataset_url -O $dataset_gz
+      gzip -df $dataset_gz
+    fi
   fi
 
   echo "$dataset_cypherl serial import..."
@@ -83,6 +117,7 @@ for dataset in "${DATASETS[@]}"; do
   check_dataset $nodes $edges
   parallel_tx=$(echo "($nodes + $edges)/$parallel_import_time" | bc -l)
 
-  echo "dataset | nodes | edges | serial (nodes+edges)/s | parallel (nodes+edges)/s | batch size | workers number"
-  echo "$dataset_cypherl | $nodes | $edges | $serial_tx | $parallel_tx | $MGCONSOLE_BATCH_SIZE | $MGCONSOLE_WORKERS"
+  echo "dataset | nodes | edges | serial (nodes+edges)/s | parallel (nodes+edges)/s | batch size | workers number | edge scheduling"
+  echo "$dataset_cypherl | $nodes | $edges | $serial_tx | $parallel_tx | $MGCONSOLE_BATCH_SIZE | $MGCONSOLE_WORKERS | $MGCONSOLE_EDGE_SCHEDULING"
+  tail -n 1 parallel_import.log
 done
@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+
+# mgconsole - console client for Memgraph database
+# Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+"""Reads the Arrow streams mgconsole printed for the queries of a test with pyarrow and prints their records the way
+--output-format=jsonl prints them, so that the Arrow output is checked against the JSONL expectations."""
+
+import datetime
+import json
+import math
+import sys
+
+import pyarrow as pa
+
+NANOSECONDS_PER_SECOND = 1_000_000_000
+
+
+def encode_float(value):
+    if math.isnan(value):
+        return '"NaN"'
+    if math.isinf(value):
+        return '"Infinity"' if value > 0 else '"-Infinity"'
+    return repr(value)
+
+
+def encode_string(value):
+    return json.dumps(value, ensure_ascii=False)
+
+
+def encode(value, arrow_type):
+    if value is None:
+        return "null"
+    if pa.types.is_string(arrow_type):
+        # The graph and spatial values are JSON encoded into the utf8 columns.
+        if value.startswith('{"__type":'):
+            return value
+        return encode_string(value)
+    if pa.types.is_boolean(arrow_type):
+        return "true" if value else "false"
+    if pa.types.is_integer(arrow_type):
+        return str(value)
+    if pa.types.is_floating(arrow_type):
+        return encode_float(value)
+    if pa.types.is_date32(arrow_type):
+        return '{"__type":"date","__value":"%s"}' % value.isoformat()
+    if pa.types.is_time64(arrow_type):
+        seconds, nanoseconds = divmod(value, NANOSECONDS_PER_SECOND)
+        return '{"__type":"local_time","__value":"%s.%09d"}' % (
+            datetime.time(seconds // 3600, seconds // 60 % 60, seconds % 60).isoformat(), nanoseconds)
+    if pa.types.is_timestamp(arrow_type):
+        seconds, nanoseconds = divmod(value, NANOSECONDS_PER_SECOND)
+        date_time = datetime.datetime(1970, 1, 1) + datetime.timedelta(seconds=seconds)
+        return '{"__type":"local_date_time","__value":"%s.%09d"}' % (date_time.isoformat(sep=" "), nanoseconds)
+    if pa.types.is_interval(arrow_type):
+        months, days, nanoseconds = value
+        seconds = int(nanoseconds / NANOSECONDS_PER_SECOND)
+        return '{"__type":"duration","months":%d,"days":%d,"seconds":%d,"nanoseconds":%d}' % (
+            months, days, seconds, nanoseconds - seconds * NANOSECONDS_PER_SECOND)
+    if pa.types.is_list(arrow_type):
+        return "[" + ",".join(encode(item, arrow_type.value_type) for item in value) + "]"
+    if pa.types.is_struct(arrow_type):
+        fields = (arrow_type.field(i) for i in range(arrow_type.num_fields))
+        return "{" + ",".join(encode_string(field.name) + ":" + encode(value[field.name], field.type)
+                              for field in fields) + "}"
+    raise TypeError(f"unexpected Arrow type {arrow_type}")
+
+
+def to_pylist(column):
+    # The nanoseconds would be lost in the Python times and datetimes.
+    if pa.types.is_time64(column.type) or pa.types.is_timestamp(column.type):
+        return column.view(pa.int64()).to_pylist()
+    return column.to_pylist()
+
+
+def main():
+    data = pa.py_buffer(sys.stdin.buffer.read())
+    stream = pa.BufferReader(data)
+    # A stream per query which returned records.
+    while stream.tell() < data.size:
+        reader = pa.ipc.open_stream(stream)
+        for batch in reader:
+            columns = [to_pylist(column) for column in batch.columns]
+            for row in range(batch.num_rows):
+                print("{" + ",".join(encode_string(field.name) + ":" + encode(column[row], field.type)
+                                     for field, column in zip(reader.schema, columns)) + "}")
+
+
+if __name__ == "__main__":
+    main()
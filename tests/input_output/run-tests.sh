@@ -16,6 +16,8 @@
 # You should have received a copy of the GNU General Public License
 # along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+# The arrow output checks need pyarrow (`pip install pyarrow`), they are skipped without it.
+
 ## Helper functions
 
 function wait_for_server {
@@ -30,6 +32,15 @@ function echo_info { printf "\033[1;36m~~ $1 ~~\033[0m\n"; }
 function echo_success { printf "\033[1;32m~~ $1 ~~\033[0m\n\n"; }
 function echo_failure { printf "\033[1;31m~~ $1 ~~\033[0m\n\n"; }
 
+# The ids depend on what the earlier tests created, the nodes and the relationships of the JSONL output are numbered in
+# the order they appear instead.
+function renumber_ids {
+    perl -pi -e 's/("__type":"(node|relationship)","id":)(\d+)/$1.Id($2, $3)/ge;
+        s/("(?:start|end)":)(\d+)/$1.Id("node", $2)/ge;
+        sub Id { my ($kind, $id) = @_; $ids{$kind}{$id} = keys %{$ids{$kind}} unless exists $ids{$kind}{$id};
+            $ids{$kind}{$id} }' $1
+}
+
 use_ssl=false
 if [ "$1" == "--use-ssl" ]; then
   use_ssl=true
@@ -113,6 +124,11 @@ echo_info "Running tests"
 echo  # Blank line
 
 client_flags="--use-ssl=$use_ssl"
+check_arrow=true
+if ! python3 -c "import pyarrow" &> /dev/null; then
+    echo_info "pyarrow isn't installed, skipping the arrow output checks"
+    check_arrow=false
+fi
 test_code=0
 for output_dir in ${DIR}/output_*; do
     for filename in ${DIR}/input/*; do
@@ -122,10 +138,15 @@ for output_dir in ${DIR}/output_*; do
 
         output_format=$(basename $output_dir)
         output_format=${output_format#*_}
-        run_flags="$client_flags --output-format=$output_format"
+        # An input can start with a `// flags: ...` comment, the extra flags of its test.
+        test_flags=$(sed -n '1s|^// flags: ||p' $filename)
+        run_flags="$client_flags --output-format=$output_format $test_flags"
 
         echo_info "Running test '$test_name' with $output_format output"
         $client_binary $run_flags < $filename > $tmpdir/$test_name
+        if [ "$output_format" == "jsonl" ]; then
+            renumber_ids $tmpdir/$test_name
+        fi
         diff -b $tmpdir/$test_name $output_dir/$output_name
         test_code=$?
         if [ $test_code -ne 0 ]; then
@@ -135,6 +156,23 @@ for output_dir in ${DIR}/output_*; do
             echo_success "Test '$test_name' with $output_format output passed"
         fi
 
+        # The Arrow output is read back with pyarrow and checked against the JSONL expectations.
+        if [ "$output_format" == "jsonl" ] && $check_arrow; then
+            $client_binary $client_flags <<< "MATCH (n) DETACH DELETE n;" &> /dev/null || exit 1
+            echo_info "Running test '$test_name' with arrow output"
+            $client_binary $client_flags --output-format=arrow $test_flags < $filename \
+                | python3 ${DIR}/arrow_to_jsonl.py > $tmpdir/$test_name.arrow
+            renumber_ids $tmpdir/$test_name.arrow
+            diff -b $tmpdir/$test_name.arrow $output_dir/$output_name
+            test_code=$?
+            if [ $test_code -ne 0 ]; then
+                echo_failure "Test '$test_name' with arrow output failed"
+                break
+            else
+                echo_success "Test '$test_name' with arrow output passed"
+            fi
+        fi
+
         # Clear database for each test.
         $client_binary $client_flags <<< "MATCH (n) DETACH DELETE n;" \
                                      &> /dev/null || exit 1
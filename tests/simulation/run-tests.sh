@@ -0,0 +1,148 @@
+#!/bin/bash
+
+# mgconsole - console client for Memgraph database
+# Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+# Runs the batched-parallel import against the simulated database (no Memgraph
+# needed) and checks that every query gets committed, that the runs are
+# deterministic, that only an edge to a missing node gets rejected and that an
+# import resumes from its checkpoint journal.
+
+function echo_info { printf "\033[1;36m~~ $1 ~~\033[0m\n"; }
+function echo_success { printf "\033[1;32m~~ $1 ~~\033[0m\n\n"; }
+function echo_failure { printf "\033[1;31m~~ $1 ~~\033[0m\n\n"; }
+
+if [ ! $# -eq 1 ]; then
+    echo "Usage: $0 [path to client binary]"
+    exit 1
+fi
+
+if [ ! -x $1 ]; then
+    echo_failure "mgconsole executable not found"
+    exit 1
+fi
+client_binary=$(realpath $1)
+
+tmpdir=$(mktemp -d)
+trap "rm -rf $tmpdir" EXIT
+
+## Dataset
+vertices=1000
+edges=3000
+for i in $(seq 0 $((vertices - 1))); do
+    echo "CREATE (:Node {id: $i});"
+done > $tmpdir/data.cypherl
+for i in $(seq 0 $((edges - 1))); do
+    # A few high-degree vertices to get some conflicts.
+    if [ $((i % 3)) -eq 0 ]; then from=$((i % 10)); else from=$(((i * 7919) % vertices)); fi
+    to=$(((i * 104729 + 13) % vertices))
+    echo "MATCH (a:Node {id: $from}), (b:Node {id: $to}) CREATE (a)-[:E]->(b);"
+done >> $tmpdir/data.cypherl
+total=$((vertices + edges))
+
+function run_simulation {
+    $client_binary --import-mode=batched-parallel --simulation --simulation-seed=7 \
+        --simulation-conflict-probability=0.05 --simulation-drop-probability=0.01 \
+        --batch-size=100 --workers-number=8 "$@" < $tmpdir/data.cypherl 2>&1 >/dev/null |
+        grep -E "^(Batched import|Simulation):"
+}
+
+function committed_queries {
+    sed -n 's/^Simulation: \([0-9]*\) queries committed.*/\1/p'
+}
+
+## Tests
+failed=false
+for scheduler in phased dag; do
+    for edge_scheduling in arrival conflict-aware; do
+        flags="--import-scheduler=$scheduler --edge-scheduling=$edge_scheduling"
+        echo_info "Simulating $flags"
+        first=$(run_simulation $flags)
+        second=$(run_simulation $flags)
+        echo "$first"
+        if [ "$first" != "$second" ]; then
+            echo_failure "Two runs with the same seed differ"
+            echo "$second"
+            failed=true
+            continue
+        fi
+        # The conflicts are retried until the batches pass, every query gets committed.
+        committed=$(echo "$first" | committed_queries)
+        if [ "$committed" != "$total" ]; then
+            echo_failure "Expected $total committed queries, got $committed"
+            failed=true
+        else
+            echo_success "Done"
+        fi
+    done
+done
+
+# With more workers than batches the window holds the whole input and the last batches are exactly full.
+echo_info "Simulating more workers than batches"
+committed=$(run_simulation --workers-number=64 | committed_queries)
+if [ "$committed" != "$total" ]; then
+    echo_failure "Expected $total committed queries, got $committed"
+    failed=true
+else
+    echo_success "Done"
+fi
+
+echo_info "Simulating an edge to a missing node"
+missing_line=$((vertices + 42))
+sed "${missing_line}s/.*/MATCH (a:Node {id: 1}), (b:Node {id: $vertices}) CREATE (a)-[:E]->(b);/" \
+    $tmpdir/data.cypherl > $tmpdir/missing.cypherl
+summary=$($client_binary --import-mode=batched-parallel --simulation --simulation-seed=7 \
+    --simulation-conflict-probability=0.05 --simulation-drop-probability=0.01 --batch-size=100 --workers-number=8 \
+    --max-batch-attempts=3 --reject-file=$tmpdir/rejected.cypherl < $tmpdir/missing.cypherl 2>&1 >/dev/null |
+    grep -E "^(Batched import|Simulation):")
+echo "$summary"
+rejected=$(echo "$summary" | sed -n 's/.* \([0-9]*\) queries rejected.*/\1/p')
+committed=$(echo "$summary" | committed_queries)
+if [ "$committed" != "$((total - 1))" ] || [ "$rejected" != "1" ] ||
+    [ "$(grep -c '^// line ' $tmpdir/rejected.cypherl)" != "1" ] ||
+    ! grep -q "^// line $missing_line: " $tmpdir/rejected.cypherl; then
+    echo_failure "Expected only line $missing_line to be rejected"
+    cat $tmpdir/rejected.cypherl
+    failed=true
+else
+    echo_success "Done"
+fi
+
+echo_info "Simulating an interrupted import resumed from the checkpoint journal"
+journal=$tmpdir/checkpoint.journal
+full=$(run_simulation --checkpoint-file=$journal | committed_queries)
+again=$(run_simulation --checkpoint-file=$journal --resume | committed_queries)
+# Pretend the import died half way through.
+head -n $(($(wc -l < $journal) / 2)) $journal > $journal.half
+cp $journal.half $journal
+rest=$(run_simulation --checkpoint-file=$journal --resume | committed_queries)
+# A pipe can't be seeked, the committed queries are skipped while reading.
+cp $journal.half $journal
+piped_rest=$(cat $tmpdir/data.cypherl | $client_binary --import-mode=batched-parallel --simulation \
+    --simulation-seed=7 --simulation-conflict-probability=0.05 --simulation-drop-probability=0.01 \
+    --batch-size=100 --workers-number=8 --checkpoint-file=$journal --resume 2>&1 >/dev/null | committed_queries)
+finished=$(run_simulation --checkpoint-file=$journal --resume | committed_queries)
+echo "full: $full, resumed: $again, resumed half: $rest (piped $piped_rest), resumed again: $finished"
+if [ "$full" != "$total" ] || [ "$again" != "0" ] || [ "$rest" -le 0 ] || [ "$rest" -ge "$total" ] ||
+    [ "$rest" != "$piped_rest" ] || [ "$finished" != "0" ]; then
+    echo_failure "The resumed import didn't continue where the journal ended"
+    failed=true
+else
+    echo_success "Done"
+fi
+
+if $failed; then
+    exit 1
+fi
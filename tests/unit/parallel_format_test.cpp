@@ -0,0 +1,53 @@
+// mgconsole - console client for Memgraph database
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "utils/parallel_format.hpp"
+
+namespace {
+
+std::vector<mg_memory::MgListPtr> MakeChunk() {
+  std::vector<mg_memory::MgListPtr> rows;
+  rows.push_back(mg_memory::MakeCustomUnique<mg_list>(mg_list_make_empty(0)));
+  return rows;
+}
+
+}  // namespace
+
+// A chunk formatted on a worker used to take the whole process down with std::terminate.
+TEST(ParallelFormatter, WorkerExceptionIsRethrown) {
+  format::ParallelFormatter formatter(
+      [](std::string &, format::ParallelFormatter::Rows) { throw std::runtime_error("unformattable value"); }, 2);
+  EXPECT_THROW(
+      {
+        for (int i = 0; i < 8; ++i) {
+          formatter.Add(MakeChunk());
+        }
+        formatter.Finish();
+      },
+      std::runtime_error);
+}
+
+TEST(ParallelFormatter, SingleChunkExceptionIsRethrown) {
+  format::ParallelFormatter formatter(
+      [](std::string &, format::ParallelFormatter::Rows) { throw std::runtime_error("unformattable value"); }, 1);
+  EXPECT_THROW(formatter.Add(MakeChunk()), std::runtime_error);
+}
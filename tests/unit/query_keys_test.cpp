@@ -0,0 +1,110 @@
+// mgconsole - console client for Memgraph database
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <optional>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "utils/query_keys.hpp"
+
+namespace {
+
+std::optional<query::keys::Key> MergeKey(const std::string &query, const std::string &merge_key_property = "") {
+  return query::keys::ExtractKeys(query, merge_key_property).merge;
+}
+
+}  // namespace
+
+// MERGEs of the same vertex have to land in the same lane, otherwise they run concurrently and create duplicates.
+
+TEST(QueryKeys, MergeLabels) {
+  auto key = MergeKey("MERGE (:User {id: 1});");
+  ASSERT_TRUE(key);
+  EXPECT_EQ(key, MergeKey("MERGE (:User:User {id: 1});"));
+  // Creates a different vertex than (:User {id: 1}) and doesn't find the one it creates.
+  EXPECT_NE(key, MergeKey("MERGE (:Admin {id: 1});"));
+  // (:User {id: 1}) would find the vertex it creates.
+  EXPECT_FALSE(MergeKey("MERGE (:Admin:User {id: 1});"));
+  EXPECT_FALSE(MergeKey("MERGE (:Admin:User {id: 1});", "id"));
+  // Finds the labeled vertices as well.
+  EXPECT_FALSE(MergeKey("MERGE ({id: 1});"));
+}
+
+TEST(QueryKeys, MergeKeyProperty) {
+  // Without a key property only a single property identifies the vertex, (:User {id: 1}) would find this one.
+  EXPECT_FALSE(MergeKey("MERGE (:User {id: 1, name: 'a'});"));
+  auto key = MergeKey("MERGE (:User {id: 1, name: 'a'});", "id");
+  ASSERT_TRUE(key);
+  EXPECT_EQ(key, MergeKey("MERGE (:User {name: 'a', id: 1});", "id"));
+  EXPECT_EQ(key, MergeKey("MERGE (:User {id: 1, name: 'b'});", "id"));
+  EXPECT_EQ(key, MergeKey("MERGE (:User {id: 1});", "id"));
+  EXPECT_EQ(key, MergeKey("MERGE (:User {id: 1});"));
+  EXPECT_NE(key, MergeKey("MERGE (:User {id: 2, name: 'a'});", "id"));
+  EXPECT_FALSE(MergeKey("MERGE (:User {name: 'a'});", "id"));
+}
+
+TEST(QueryKeys, MergeNumericLiterals) {
+  auto key = MergeKey("MERGE (:User {id: 1});");
+  ASSERT_TRUE(key);
+  EXPECT_EQ(key, MergeKey("MERGE (:User {id: 1.0});"));
+  EXPECT_EQ(key, MergeKey("MERGE (:User {id: 1e0});"));
+  EXPECT_EQ(key, MergeKey("MERGE (:User {id: 0x1});"));
+  EXPECT_EQ(MergeKey("MERGE (:User {id: -2});"), MergeKey("MERGE (:User {id: -2.00});"));
+  EXPECT_EQ(MergeKey("MERGE (:User {id: 0.5});"), MergeKey("MERGE (:User {id: 5e-1});"));
+  EXPECT_NE(key, MergeKey("MERGE (:User {id: 1.5});"));
+  EXPECT_NE(key, MergeKey("MERGE (:User {id: -1});"));
+  EXPECT_NE(key, MergeKey("MERGE (:User {id: '1'});"));
+}
+
+TEST(QueryKeys, MergeStringLiterals) {
+  EXPECT_EQ(MergeKey("MERGE (:User {name: 'a'});"), MergeKey("MERGE (:User {name: \"a\"});"));
+  EXPECT_EQ(MergeKey("MERGE (:User {name: 'it\\'s'});"), MergeKey("MERGE (:User {name: \"it's\"});"));
+  EXPECT_EQ(MergeKey("MERGE (:User {name: '\\u00e9'});"), MergeKey("MERGE (:User {name: '\xc3\xa9'});"));
+}
+
+TEST(QueryKeys, MergeWithoutExactKey) {
+  // Executed serially after the lanes.
+  EXPECT_FALSE(MergeKey("MERGE (:User {id: $id});"));
+  EXPECT_FALSE(MergeKey("MERGE (:User {id: 1, name: $name});"));
+  EXPECT_FALSE(MergeKey("MERGE (:User {id: 1 + 1});"));
+  EXPECT_FALSE(MergeKey("MERGE (:User {id: 010});"));
+  EXPECT_FALSE(MergeKey("MERGE (:User {name: '\\q'});"));
+  EXPECT_FALSE(MergeKey("MERGE (:User);"));
+  EXPECT_FALSE(MergeKey("MERGE (:User {id: 1}) MERGE (:User {id: 2});"));
+}
+
+TEST(QueryKeys, MergeRelationship) {
+  auto key = MergeKey("MATCH (a:User {id: 1}), (b:User {id: 2}) MERGE (a)-[:KNOWS]->(b);");
+  ASSERT_TRUE(key);
+  EXPECT_EQ(key, MergeKey("MATCH (a:User), (b:User) WHERE a.id = 1.0 AND b.id = 2 MERGE (a)-[:KNOWS]->(b);"));
+  // The same endpoints, however they are matched.
+  EXPECT_EQ(key, MergeKey("MATCH (a:User {id: 2}), (b:User {id: 1}) MERGE (a)-[:KNOWS]-(b);"));
+  EXPECT_EQ(key, MergeKey("MATCH (a:Admin:User {id: 1}), (b {id: 2}) MERGE (a)-[:KNOWS]->(b);"));
+  EXPECT_EQ(key, MergeKey("MATCH (a:User {id: 1, name: 'a'}), (b:User {id: 2}) MERGE (a)-[:KNOWS]->(b);", "id"));
+  EXPECT_NE(key, MergeKey("MATCH (a:User {id: 1}), (b:User {id: 3}) MERGE (a)-[:KNOWS]->(b);"));
+  EXPECT_NE(key, MergeKey("MATCH (a:User {id: 1}), (b:User {id: 2}) MERGE (a)-[:LIKES]->(b);"));
+  EXPECT_FALSE(MergeKey("MATCH (a:User {id: 1, name: 'a'}), (b:User {id: 2}) MERGE (a)-[:KNOWS]->(b);"));
+  EXPECT_FALSE(MergeKey("MATCH (a:User {id: $a}), (b:User {id: 2}) MERGE (a)-[:KNOWS]->(b);"));
+}
+
+TEST(QueryKeys, MatchNumericLiterals) {
+  auto keys = query::keys::ExtractKeys("MATCH (a:Node {id: 1}), (b:Node {id: 2}) CREATE (a)-[:E]->(b);");
+  EXPECT_TRUE(keys.match_keyed);
+  EXPECT_EQ(keys.match, query::keys::ExtractKeys("MATCH (a:Node {id: 1.0}), (b:Node) WHERE b.id = 2.0 "
+                                                 "CREATE (a)-[:E]->(b);")
+                            .match);
+}
@@ -0,0 +1,107 @@
+// mgconsole - console client for Memgraph database
+// Copyright (C) 2016-2023 Memgraph Ltd. [https://memgraph.com]
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <string>
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "utils/utils.hpp"
+
+// utils reads it, mgconsole defines it in main.cpp.
+DEFINE_bool(term_colors, false, "Use terminal colors syntax highlighting.");
+
+namespace {
+
+/// The clauses of a single line query, the way the batched import classifies it.
+query::line::CollectedClauses Classify(const std::string &line) {
+  char quote = '\0';
+  bool escaped = false;
+  auto result = console::ParseLine(line, &quote, &escaped, true);
+  EXPECT_TRUE(result.is_done);
+  EXPECT_TRUE(result.info);
+  return result.info ? result.info->collected_clauses : query::line::CollectedClauses{};
+}
+
+}  // namespace
+
+TEST(QueryType, Vertex) {
+  auto clauses = Classify("CREATE (:Node {id: 1});");
+  EXPECT_TRUE(clauses.has_create);
+  EXPECT_FALSE(clauses.has_match);
+  EXPECT_FALSE(clauses.has_remove);
+}
+
+TEST(QueryType, CreateAfterClosingParenthesis) {
+  // `) C` starts like `) REMOVE`.
+  auto clauses = Classify("MATCH (a:Node {id: 1}), (b:Node {id: 2}) CREATE (a)-[:E]->(b);");
+  EXPECT_TRUE(clauses.has_match);
+  EXPECT_TRUE(clauses.has_create);
+  EXPECT_FALSE(clauses.has_remove);
+
+  clauses = Classify("MATCH (a:Node {id: 1}), (b:Node {id: 2})\nCREATE (a)-[:E]->(b);");
+  EXPECT_TRUE(clauses.has_match);
+  EXPECT_TRUE(clauses.has_create);
+
+  clauses = Classify("match (a:Node {id: 1}), (b:Node {id: 2})create(a)-[:E]->(b);");
+  EXPECT_TRUE(clauses.has_match);
+  EXPECT_TRUE(clauses.has_create);
+}
+
+TEST(QueryType, MergeAfterClosingParenthesis) {
+  auto clauses = Classify("MATCH (a:Node {id: 1}) MERGE (a)-[:E]->(:Node {id: 2});");
+  EXPECT_TRUE(clauses.has_match);
+  EXPECT_TRUE(clauses.has_merge);
+  EXPECT_FALSE(clauses.has_create);
+}
+
+TEST(QueryType, Remove) {
+  auto clauses = Classify("MATCH (n:Node) REMOVE n.id;");
+  EXPECT_TRUE(clauses.has_match);
+  EXPECT_TRUE(clauses.has_remove);
+  EXPECT_FALSE(clauses.has_create);
+
+  clauses = Classify("match (n:Node) remove n:Node;");
+  EXPECT_TRUE(clauses.has_match);
+  EXPECT_TRUE(clauses.has_remove);
+
+  // An unexpected character restarts the matching, but `) R` without a REMOVE is nothing.
+  clauses = Classify("MATCH (n) RETURN n;");
+  EXPECT_TRUE(clauses.has_match);
+  EXPECT_FALSE(clauses.has_remove);
+}
+
+TEST(QueryType, QuotedClauses) {
+  auto clauses = Classify("CREATE (:Node {name: 'MATCH (n) REMOVE n'});");
+  EXPECT_TRUE(clauses.has_create);
+  EXPECT_FALSE(clauses.has_match);
+  EXPECT_FALSE(clauses.has_remove);
+
+  clauses = Classify("MATCH (n:Node) WHERE n.name = \") CREATE (\" RETURN n;");
+  EXPECT_TRUE(clauses.has_match);
+  EXPECT_FALSE(clauses.has_create);
+
+  // The escaped quote doesn't end the string.
+  clauses = Classify("CREATE (:Node {name: \"a \\\" MATCH (n) \\\" ) REMOVE\"});");
+  EXPECT_TRUE(clauses.has_create);
+  EXPECT_FALSE(clauses.has_match);
+  EXPECT_FALSE(clauses.has_remove);
+
+  // A clause right after the quote.
+  clauses = Classify("MATCH (n:Node {name: ')'}) CREATE (n)-[:E]->(:Node);");
+  EXPECT_TRUE(clauses.has_match);
+  EXPECT_TRUE(clauses.has_create);
+}